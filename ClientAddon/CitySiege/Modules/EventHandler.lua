@@ -6,6 +6,52 @@
 CitySiege_EventHandler = {}
 local EventHandler = CitySiege_EventHandler
 
+-- Newest server protocol this addon understands (1 = text UPDATE, 2 = compact U2 UPDATE)
+local PROTOCOL_VERSION = 2
+-- Compact positions are city-local, in 1/4 yard steps
+local POSITION_SCALE = 4
+-- Minimum seconds between resync requests for the same city
+local RESYNC_INTERVAL = 5
+
+local B64 = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/"
+local B64_INDEX = {}
+for i = 1, 64 do
+    B64_INDEX[string.byte(B64, i)] = i - 1
+end
+
+-- Reads one unsigned varint (5 data bits per character, values >= 32 mean more characters follow)
+local function ReadVarint(payload, pos)
+    local value, scale = 0, 1
+    while true do
+        local digit = B64_INDEX[string.byte(payload, pos) or 0]
+        if not digit then
+            return nil, pos
+        end
+        pos = pos + 1
+        value = value + (digit % 32) * scale
+        if digit < 32 then
+            return value, pos
+        end
+        scale = scale * 32
+    end
+end
+
+-- Reads one zigzag-encoded signed varint
+local function ReadSignedVarint(payload, pos)
+    local value
+    value, pos = ReadVarint(payload, pos)
+    if not value then
+        return nil, pos
+    end
+    if value % 2 == 0 then
+        return value / 2, pos
+    end
+    return -(value + 1) / 2, pos
+end
+
+-- Section order of the compact UPDATE payload
+local COMPACT_SECTIONS = { "attackerPositions", "defenderPositions", "attackerBots", "defenderBots" }
+
 function EventHandler:Initialize()
     -- Register for addon communication (3.3.5 compatible)
     if RegisterAddonMessagePrefix then
@@ -93,7 +139,25 @@ function EventHandler:ParseAddonMessage(message)
     
     command = string.upper(command)
     
-    if command == "REQUEST_MAP" then
+    if command == "HELLO" then
+        -- Format: HELLO:maxProtocolVersion
+        -- Server advertises the newest protocol it speaks; opt in to the compact encoding if we can
+        local version = tonumber(string.match(message, "^HELLO:(%d+)"))
+        if version and version >= 2 and self.protocolVersion ~= math.min(version, PROTOCOL_VERSION) then
+            self.protocolVersion = math.min(version, PROTOCOL_VERSION)
+            CitySiege_Utils:ExecuteServerCommand(".citysiege proto " .. self.protocolVersion)
+        end
+        return
+
+    elseif command == "U2" then
+        -- Format: U2:cityId:seq:baseSeq:payload (compact UPDATE, see DecodeCompactUpdate)
+        local cityID, seq, baseSeq, payload = string.match(message, "^U2:(%d+):(%d+):(%d+):(.*)$")
+        if cityID then
+            self:HandleCompactUpdate(tonumber(cityID), tonumber(seq), tonumber(baseSeq), payload)
+        end
+        return
+
+    elseif command == "REQUEST_MAP" then
         -- Format: REQUEST_MAP:cityID
         -- Client is requesting map data, execute the server command
         local parts = {}
@@ -108,7 +172,8 @@ function EventHandler:ParseAddonMessage(message)
         return
         
     elseif command == "START" then
-        -- Format: START:cityId:faction:spawnX:spawnY:spawnZ:leaderX:leaderY:leaderZ:centerX:centerY:centerZ
+        -- Format: START:cityId:faction:spawnX:spawnY:spawnZ:leaderX:leaderY:leaderZ:centerX:centerY:centerZ[:WP:count:x:y:z...]
+        -- The waypoint section is only sent to clients that negotiated the compact protocol
         local parts = {}
         for part in string.gmatch(message, "([^:]+)") do
             table.insert(parts, part)
@@ -131,8 +196,24 @@ function EventHandler:ParseAddonMessage(message)
                 coords.centerY = tonumber(parts[11])
                 coords.centerZ = tonumber(parts[12])
             end
+
+            local waypoints
+            if parts[13] == "WP" then
+                waypoints = {}
+                local i = 15
+                for j = 1, tonumber(parts[14]) or 0 do
+                    if i + 2 <= #parts then
+                        table.insert(waypoints, {
+                            x = tonumber(parts[i]),
+                            y = tonumber(parts[i + 1]),
+                            z = tonumber(parts[i + 2])
+                        })
+                        i = i + 3
+                    end
+                end
+            end
             
-            self:HandleSiegeStart(cityID, faction, coords)
+            self:HandleSiegeStart(cityID, faction, coords, waypoints)
         end
         
     elseif command == "UPDATE" then
@@ -217,6 +298,9 @@ function EventHandler:ParseAddonMessage(message)
         -- Format: END:cityId:winner
         local cityID, winner = string.match(message, "^END:(%d+):(%w+)")
         if cityID then
+            if self.compactState then
+                self.compactState[tonumber(cityID)] = nil
+            end
             self:HandleSiegeEnd(tonumber(cityID), winner)
         end
         
@@ -279,8 +363,24 @@ function EventHandler:ParseAddonMessage(message)
     end
 end
 
-function EventHandler:HandleSiegeStart(cityID, faction, coords)
+function EventHandler:HandleSiegeStart(cityID, faction, coords, waypoints)
     if not cityID then return end
+
+    -- A new siege starts a new compact delta chain
+    self.compactState = self.compactState or {}
+    self.compactState[cityID] = nil
+
+    -- A sync repeats START for sieges already tracked: refresh the static data, keep stats and timers
+    local existing = CitySiege_SiegeTracker and CitySiege_SiegeTracker:GetSiege(cityID)
+    if existing and (not existing.attackingFaction or existing.attackingFaction == faction) then
+        existing.attackingFaction = faction
+        existing.coords = coords or existing.coords or {}
+        if waypoints and #waypoints > 0 then
+            existing.waypoints = waypoints
+        end
+        CitySiege_SiegeTracker:UpdateSiege(cityID, existing)
+        return
+    end
     
     CitySiege_Utils:Debug("Siege started: city=" .. cityID .. ", faction=" .. (faction or "Unknown"))
     
@@ -293,7 +393,7 @@ function EventHandler:HandleSiegeStart(cityID, faction, coords)
         attackerCount = 0,
         defenderCount = 0,
         npcs = {},
-        waypoints = {},
+        waypoints = waypoints or {},
         coords = coords or {},
         leaderHealth = 100,
         remaining = 0,
@@ -349,9 +449,9 @@ function EventHandler:HandleSiegeUpdate(cityID, phase, attackerCount, defenderCo
             siegeData.remaining = remaining
             siegeData.leaderHealth = leaderHealth
             
-            -- Update waypoint data if provided
+            -- Update waypoint data if provided (compact updates leave the waypoints from START in place)
             if data then
-                siegeData.waypoints = data.waypoints or {}
+                siegeData.waypoints = data.waypoints or siegeData.waypoints or {}
                 siegeData.attackerPositions = data.attackerPositions or {}
                 siegeData.defenderPositions = data.defenderPositions or {}
                 siegeData.attackerBots = data.attackerBots or {}
@@ -395,6 +495,101 @@ function EventHandler:HandleSiegeUpdate(cityID, phase, attackerCount, defenderCo
     end
 end
 
+-- Decodes a compact UPDATE payload. Header fields are plain varints, followed by one section per
+-- position list: a count, then x/y/z deltas against the same entry of the previous list.
+function EventHandler:DecodeCompactUpdate(payload, previous)
+    local pos = 1
+    local header = {}
+    for i = 1, 6 do
+        header[i], pos = ReadVarint(payload, pos)
+        if not header[i] then return nil end
+    end
+
+    local sections = {}
+    for s = 1, #COMPACT_SECTIONS do
+        local count
+        count, pos = ReadVarint(payload, pos)
+        if not count then return nil end
+
+        local base = previous and previous[s] or {}
+        local list = {}
+        for j = 1, count do
+            local dx, dy, dz
+            dx, pos = ReadSignedVarint(payload, pos)
+            dy, pos = ReadSignedVarint(payload, pos)
+            dz, pos = ReadSignedVarint(payload, pos)
+            if not dz then return nil end
+
+            local b = base[j]
+            list[j] = b and { b[1] + dx, b[2] + dy, b[3] + dz } or { dx, dy, dz }
+        end
+        sections[s] = list
+    end
+
+    return header, sections
+end
+
+function EventHandler:RequestResync(cityID)
+    self.lastResync = self.lastResync or {}
+    local now = GetTime()
+    if self.lastResync[cityID] and now - self.lastResync[cityID] < RESYNC_INTERVAL then
+        return
+    end
+    self.lastResync[cityID] = now
+
+    -- Only the keyframe is needed once START was seen; without its city center a full sync is required
+    local siegeData = CitySiege_SiegeTracker and CitySiege_SiegeTracker:GetSiege(cityID)
+    if siegeData and siegeData.coords and siegeData.coords.centerX then
+        CitySiege_Utils:ExecuteServerCommand(".citysiege resync " .. cityID)
+    else
+        CitySiege_Utils:ExecuteServerCommand(".citysiege sync " .. cityID)
+    end
+end
+
+function EventHandler:HandleCompactUpdate(cityID, seq, baseSeq, payload)
+    if not cityID or not seq then return end
+
+    self.compactState = self.compactState or {}
+    local state = self.compactState[cityID]
+
+    -- Deltas only apply on top of the snapshot they were made against; otherwise ask for a keyframe
+    if baseSeq ~= 0 and (not state or state.seq ~= baseSeq) then
+        self:RequestResync(cityID)
+        return
+    end
+
+    local header, sections = self:DecodeCompactUpdate(payload, baseSeq ~= 0 and state.sections or nil)
+    if not header then
+        self.compactState[cityID] = nil
+        self:RequestResync(cityID)
+        return
+    end
+    self.compactState[cityID] = { seq = seq, sections = sections }
+
+    -- Positions are relative to the city center sent with START
+    local siegeData = CitySiege_SiegeTracker and CitySiege_SiegeTracker:GetSiege(cityID)
+    local coords = siegeData and siegeData.coords
+    if not coords or not coords.centerX then
+        self:RequestResync(cityID)
+        return
+    end
+
+    local data = {}
+    for s, key in ipairs(COMPACT_SECTIONS) do
+        local list = {}
+        for j, q in ipairs(sections[s]) do
+            list[j] = {
+                x = coords.centerX + q[1] / POSITION_SCALE,
+                y = coords.centerY + q[2] / POSITION_SCALE,
+                z = coords.centerZ + q[3] / POSITION_SCALE
+            }
+        end
+        data[key] = list
+    end
+
+    self:HandleSiegeUpdate(cityID, header[1], header[2], header[3], header[4], header[5], header[6] / 10, data)
+end
+
 function EventHandler:HandlePositionUpdate(cityID, guid, x, y, z, unitType)
     if not cityID or not guid then return end
     
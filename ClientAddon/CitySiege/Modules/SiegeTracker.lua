@@ -11,6 +11,9 @@ local activeSieges = {}
 local updateTimer = nil
 local lastUpdate = 0
 
+-- Refresh the subscription well before the server's timeout (CitySiege.Addon.SubscriptionTimeout)
+local SUBSCRIPTION_REFRESH_INTERVAL = 600
+
 function Tracker:Initialize()
     -- Load saved sieges
     activeSieges = CitySiege_Config:GetActiveSieges()
@@ -29,12 +32,19 @@ function Tracker:StartUpdateTimer()
     -- Use OnUpdate frame for 3.3.5a compatibility
     local frame = CreateFrame("Frame")
     local elapsed = 0
+    local sinceRefresh = 0
     frame:SetScript("OnUpdate", function(self, delta)
         elapsed = elapsed + delta
         if elapsed >= updateInterval then
             elapsed = 0
             Tracker:Update()
         end
+
+        sinceRefresh = sinceRefresh + delta
+        if sinceRefresh >= SUBSCRIPTION_REFRESH_INTERVAL then
+            sinceRefresh = 0
+            Tracker:RefreshSubscription()
+        end
     end)
     
     updateTimer = frame
@@ -291,6 +301,11 @@ function Tracker:RequestStatusUpdate()
     CitySiege_Utils:ExecuteServerCommand(".citysiege sync")
 end
 
+function Tracker:RefreshSubscription()
+    -- Only keeps the broadcasts coming; a sync would replay START for every active siege
+    CitySiege_Utils:ExecuteServerCommand(".citysiege refresh")
+end
+
 function Tracker:CheckCitySiege(cityID)
     -- Check if there's an active siege in this city
     local siegeData = activeSieges[cityID]
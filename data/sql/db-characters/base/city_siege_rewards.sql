@@ -0,0 +1,14 @@
+-- Journal of City Siege reward payouts, so a crash during payout neither pays a player twice nor skips them.
+-- Rows are written unpaid when a siege ends and flagged paid in the same transaction that saves the rewarded character.
+CREATE TABLE IF NOT EXISTS `city_siege_rewards` (
+  `city` TINYINT UNSIGNED NOT NULL COMMENT 'City id',
+  `start_time` INT UNSIGNED NOT NULL COMMENT 'Start time of the siege',
+  `guid` INT UNSIGNED NOT NULL COMMENT 'Character guid',
+  `honor` INT UNSIGNED NOT NULL DEFAULT 0,
+  `gold` INT UNSIGNED NOT NULL DEFAULT 0 COMMENT 'Copper',
+  `points` INT UNSIGNED NOT NULL DEFAULT 0 COMMENT 'Contribution points',
+  `scale` TINYINT UNSIGNED NOT NULL DEFAULT 100 COMMENT 'Percentage of the full reward',
+  `defended` TINYINT UNSIGNED NOT NULL DEFAULT 0 COMMENT '1 if the defenders won',
+  `paid` TINYINT UNSIGNED NOT NULL DEFAULT 0,
+  PRIMARY KEY (`city`, `start_time`, `guid`)
+) ENGINE=InnoDB DEFAULT CHARSET=utf8mb4 COMMENT='City Siege reward payout journal';
@@ -37,6 +37,10 @@ namespace CitySiegeAPI
         uint32 spawnedDefenders = 0;
         uint32 attackerBotCount = 0;
         uint32 defenderBotCount = 0;
+        uint32 pendingCreatureRespawns = 0;
+        uint32 pendingBotRespawns = 0;
+        uint32 attackerDeaths = 0;
+        uint32 defenderDeaths = 0;
     };
 
     std::vector<ActiveSiegeSnapshot> GetActiveSieges();
@@ -0,0 +1,318 @@
+/*
+ * This file is part of the AzerothCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ */
+
+#ifndef MOD_CITY_SIEGE_NET_H
+#define MOD_CITY_SIEGE_NET_H
+
+// Addon UPDATE serialization: the text format, the compact U2 deltas, keyframes and summaries.
+// Shared by the module and tools/siege_benchmark.cpp, so it only depends on the standard library
+// and CitySiegeUpdate.h; sending the messages is up to the module.
+
+#include "CitySiegeUpdate.h"
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <iomanip>
+#include <sstream>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Addon protocol versions. Version 1 is the colon-separated text format every addon
+ * understands; version 2 adds the compact UPDATE encoding (U2) and has to be negotiated.
+ */
+enum CitySiegeAddonProtocol : std::uint32_t
+{
+    ADDON_PROTOCOL_TEXT    = 1,
+    ADDON_PROTOCOL_COMPACT = 2,
+    ADDON_PROTOCOL_MAX     = ADDON_PROTOCOL_COMPACT
+};
+
+// Compact positions are relative to the city center, in 1/4 yard steps (+-8192 yards in 16 bits)
+constexpr float ADDON_POSITION_SCALE = 4.0f;
+
+// Prefix the addon recognizes its messages by, in front of every message
+constexpr char ADDON_MESSAGE_PREFIX[] = "CitySiege\t";
+
+/**
+ * @brief Position sections carried by addon UPDATE messages.
+ */
+enum SiegeNetSection
+{
+    SIEGE_NET_ATTACKERS = 0,
+    SIEGE_NET_DEFENDERS,
+    SIEGE_NET_ATTACKER_BOTS,
+    SIEGE_NET_DEFENDER_BOTS,
+    SIEGE_NET_SECTION_MAX
+};
+
+/**
+ * @brief A unit position quantized to city-local coordinates for the compact addon protocol.
+ */
+struct SiegeNetPosition
+{
+    std::int16_t x = 0;
+    std::int16_t y = 0;
+    std::int16_t z = 0;
+};
+
+/**
+ * @brief Last positions broadcast with the compact addon protocol; the next UPDATE is a delta against it.
+ */
+struct SiegeAddonBaseline
+{
+    std::uint32_t seq = 0; // 0 = nothing broadcast yet
+    std::array<std::vector<SiegeNetPosition>, SIEGE_NET_SECTION_MAX> sections;
+};
+
+/**
+ * @brief Everything an UPDATE message reports, gathered once so every encoding can share it.
+ */
+struct SiegeAddonSnapshot
+{
+    std::uint32_t phase = 1;
+    std::uint32_t attackerCount = 0;
+    std::uint32_t defenderCount = 0;
+    std::uint32_t elapsed = 0;
+    std::uint32_t remaining = 0;
+    float leaderHealthPct = 0.0f;
+    std::array<std::vector<std::array<float, 3>>, SIEGE_NET_SECTION_MAX> positions;
+};
+
+/**
+ * @brief Addon UPDATE messages for one snapshot, one per protocol version and subscriber tier.
+ */
+struct SiegeUpdateMessages
+{
+    std::string text;
+    std::string compact;
+    std::string summaryText;    // Only filled when the summary tier is due
+    std::string summaryCompact;
+};
+
+/**
+ * @brief Size of the system chat packet that carries an addon message (see BuildAddonMessagePacket).
+ */
+inline std::size_t GetAddonMessagePacketSize(std::string const& message)
+{
+    // Chat type, language, sender GUID, flags, receiver GUID, text length, text + terminator, chat tag
+    return 1 + 4 + 8 + 4 + 8 + 4 + (sizeof(ADDON_MESSAGE_PREFIX) - 1 + message.length() + 1) + 1;
+}
+
+/**
+ * @brief Appends an unsigned value as a variable length base64 string (5 data bits per character,
+ * the 6th bit marks that more characters follow). Only uses characters that are safe in chat text.
+ */
+inline void AppendAddonVarint(std::string& out, std::uint32_t value)
+{
+    static char const alphabet[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+    while (value >= 32)
+    {
+        out += alphabet[32 | (value & 31)];
+        value >>= 5;
+    }
+    out += alphabet[value];
+}
+
+/**
+ * @brief Appends a signed value zigzag-encoded, so small deltas of either sign stay short.
+ */
+inline void AppendAddonSignedVarint(std::string& out, std::int32_t value)
+{
+    AppendAddonVarint(out, (static_cast<std::uint32_t>(value) << 1) ^ static_cast<std::uint32_t>(value >> 31));
+}
+
+inline std::int16_t QuantizeAddonCoordinate(float value, float origin)
+{
+    float scaled = std::round((value - origin) * ADDON_POSITION_SCALE);
+    return static_cast<std::int16_t>(std::clamp(scaled, -32768.0f, 32767.0f));
+}
+
+/**
+ * @brief Formats an UPDATE message in the version 1 text format.
+ * @param city The besieged city.
+ * @param snapshot Current siege state.
+ */
+inline std::string FormatSiegeUpdateText(CityData const& city, SiegeAddonSnapshot const& snapshot)
+{
+    std::ostringstream ss;
+
+    ss << "UPDATE:" << static_cast<std::uint32_t>(city.id) << ":" << snapshot.phase
+       << ":" << snapshot.attackerCount << ":" << snapshot.defenderCount
+       << ":" << snapshot.elapsed << ":" << snapshot.remaining
+       << ":" << std::fixed << std::setprecision(1) << snapshot.leaderHealthPct;
+
+    ss << ":WP:" << city.waypoints.size();
+    for (const auto& wp : city.waypoints)
+        ss << ":" << std::fixed << std::setprecision(2) << wp.x << ":" << wp.y << ":" << wp.z;
+
+    static char const* const sectionNames[SIEGE_NET_SECTION_MAX] = { "ATK", "DEF", "BATK", "BDEF" };
+    for (std::uint32_t section = 0; section < SIEGE_NET_SECTION_MAX; ++section)
+    {
+        std::vector<std::array<float, 3>> const& positions = snapshot.positions[section];
+
+        ss << ":" << sectionNames[section] << ":" << positions.size();
+        for (std::array<float, 3> const& position : positions)
+            ss << ":" << std::fixed << std::setprecision(2)
+               << position[0] << ":" << position[1] << ":" << position[2];
+    }
+
+    return ss.str();
+}
+
+/**
+ * @brief Encodes the compact UPDATE header fields shared by deltas and keyframes.
+ */
+inline void AppendCompactUpdateHeader(std::string& payload, SiegeAddonSnapshot const& snapshot)
+{
+    AppendAddonVarint(payload, snapshot.phase);
+    AppendAddonVarint(payload, snapshot.attackerCount);
+    AppendAddonVarint(payload, snapshot.defenderCount);
+    AppendAddonVarint(payload, snapshot.elapsed);
+    AppendAddonVarint(payload, snapshot.remaining);
+    AppendAddonVarint(payload, static_cast<std::uint32_t>(std::lround(snapshot.leaderHealthPct * 10.0f)));
+}
+
+/**
+ * @brief Encodes a compact UPDATE against the siege's shared baseline and advances the baseline.
+ * Every compact subscriber receives the same delta, so the baseline is per siege rather than per player;
+ * a client whose last sequence number does not match the delta's base resynchronizes via .citysiege sync.
+ * Format: U2:cityId:seq:baseSeq:payload
+ * @param city The besieged city.
+ * @param baseline The siege's compact baseline.
+ * @param snapshot Current siege state.
+ */
+inline std::string EncodeSiegeUpdateDelta(CityData const& city, SiegeAddonBaseline& baseline, SiegeAddonSnapshot const& snapshot)
+{
+    std::string payload;
+    payload.reserve(64 + (snapshot.positions[SIEGE_NET_ATTACKERS].size() + snapshot.positions[SIEGE_NET_DEFENDERS].size()) * 6);
+    AppendCompactUpdateHeader(payload, snapshot);
+
+    for (std::uint32_t section = 0; section < SIEGE_NET_SECTION_MAX; ++section)
+    {
+        std::vector<std::array<float, 3>> const& positions = snapshot.positions[section];
+        std::vector<SiegeNetPosition> const& previous = baseline.sections[section];
+        std::vector<SiegeNetPosition> current;
+        current.reserve(positions.size());
+
+        AppendAddonVarint(payload, positions.size());
+        for (std::size_t i = 0; i < positions.size(); ++i)
+        {
+            SiegeNetPosition position;
+            position.x = QuantizeAddonCoordinate(positions[i][0], city.centerX);
+            position.y = QuantizeAddonCoordinate(positions[i][1], city.centerY);
+            position.z = QuantizeAddonCoordinate(positions[i][2], city.centerZ);
+
+            // Entries past the end of the previous list are encoded against the origin
+            SiegeNetPosition base = i < previous.size() ? previous[i] : SiegeNetPosition();
+            AppendAddonSignedVarint(payload, std::int32_t(position.x) - base.x);
+            AppendAddonSignedVarint(payload, std::int32_t(position.y) - base.y);
+            AppendAddonSignedVarint(payload, std::int32_t(position.z) - base.z);
+
+            current.push_back(position);
+        }
+
+        baseline.sections[section] = std::move(current);
+    }
+
+    std::uint32_t const baseSeq = baseline.seq;
+    ++baseline.seq;
+
+    return "U2:" + std::to_string(static_cast<std::uint32_t>(city.id)) + ":" + std::to_string(baseline.seq) +
+        ":" + std::to_string(baseSeq) + ":" + payload;
+}
+
+/**
+ * @brief Encodes the siege's shared baseline as a compact keyframe (base sequence 0), so a client
+ * that just (re)synchronized can apply the deltas that follow.
+ * Before the first broadcast there is no baseline yet; the keyframe is then built from the snapshot
+ * with sequence 0, and the first broadcast (base sequence 0, an absolute keyframe as well) follows it.
+ * The shared baseline is never advanced here, since only the synchronizing player receives this message.
+ * @param city The besieged city.
+ * @param baseline The siege's compact baseline.
+ * @param snapshot Current siege state.
+ */
+inline std::string EncodeSiegeUpdateKeyframe(CityData const& city, SiegeAddonBaseline const& baseline, SiegeAddonSnapshot const& snapshot)
+{
+    std::string payload;
+    AppendCompactUpdateHeader(payload, snapshot);
+
+    for (std::uint32_t section = 0; section < SIEGE_NET_SECTION_MAX; ++section)
+    {
+        if (baseline.seq)
+        {
+            std::vector<SiegeNetPosition> const& positions = baseline.sections[section];
+            AppendAddonVarint(payload, positions.size());
+            for (SiegeNetPosition const& position : positions)
+            {
+                AppendAddonSignedVarint(payload, position.x);
+                AppendAddonSignedVarint(payload, position.y);
+                AppendAddonSignedVarint(payload, position.z);
+            }
+            continue;
+        }
+
+        std::vector<std::array<float, 3>> const& positions = snapshot.positions[section];
+        AppendAddonVarint(payload, positions.size());
+        for (std::array<float, 3> const& position : positions)
+        {
+            AppendAddonSignedVarint(payload, QuantizeAddonCoordinate(position[0], city.centerX));
+            AppendAddonSignedVarint(payload, QuantizeAddonCoordinate(position[1], city.centerY));
+            AppendAddonSignedVarint(payload, QuantizeAddonCoordinate(position[2], city.centerZ));
+        }
+    }
+
+    return "U2:" + std::to_string(static_cast<std::uint32_t>(city.id)) + ":" + std::to_string(baseline.seq) +
+        ":0:" + payload;
+}
+
+/**
+ * @brief Encodes a compact UPDATE for summary-tier subscribers: the header and empty unit sections.
+ * It is sent as keyframe 0, so a client that moves into the full tier resynchronizes on its first delta.
+ */
+inline std::string EncodeSiegeUpdateSummary(CityData const& city, SiegeAddonSnapshot const& snapshot)
+{
+    std::string payload;
+    AppendCompactUpdateHeader(payload, snapshot);
+
+    for (std::uint32_t section = 0; section < SIEGE_NET_SECTION_MAX; ++section)
+        AppendAddonVarint(payload, 0);
+
+    return "U2:" + std::to_string(static_cast<std::uint32_t>(city.id)) + ":0:0:" + payload;
+}
+
+/**
+ * @brief Serializes an UPDATE snapshot for every protocol version and tier and advances the delta baseline.
+ * Independent of the world, so the benchmarks run exactly the code used by live broadcasts.
+ * @param city The besieged city.
+ * @param baseline The siege's compact baseline.
+ * @param snapshot Current siege state; its positions are cleared when the summary tier is serialized.
+ * @param includeSummaryTier Whether the summary messages are needed.
+ */
+inline SiegeUpdateMessages SerializeSiegeUpdate(CityData const& city, SiegeAddonBaseline& baseline, SiegeAddonSnapshot& snapshot,
+    bool includeSummaryTier)
+{
+    SiegeUpdateMessages messages;
+    messages.text = FormatSiegeUpdateText(city, snapshot);
+    messages.compact = EncodeSiegeUpdateDelta(city, baseline, snapshot);
+
+    if (includeSummaryTier)
+    {
+        messages.summaryCompact = EncodeSiegeUpdateSummary(city, snapshot);
+        for (auto& positions : snapshot.positions)
+            positions.clear();
+        messages.summaryText = FormatSiegeUpdateText(city, snapshot);
+    }
+
+    return messages;
+}
+
+#endif
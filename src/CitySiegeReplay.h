@@ -0,0 +1,79 @@
+/*
+ * This file is part of the AzerothCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ */
+
+#ifndef MOD_CITY_SIEGE_REPLAY_H
+#define MOD_CITY_SIEGE_REPLAY_H
+
+// Shared by the module and tools/siege_replay_reader.cpp, so it only depends on the standard library
+#include <cstdint>
+
+namespace CitySiegeReplay
+{
+    // File layout: one FileHeader followed by Records until the end of the file, in host byte order
+    constexpr char FILE_MAGIC[4] = { 'C', 'S', 'R', 'P' };
+    constexpr std::uint16_t FILE_VERSION = 1;
+    constexpr char const* FILE_EXTENSION = ".csr";
+
+    enum class EventType : std::uint8_t
+    {
+        Spawn = 1,     // id = creature GUID counter, value = entry, detail = unit tier
+        Death,         // id = creature GUID counter, value = entry
+        Respawn,       // id = new creature GUID counter, value = entry
+        Waypoint,      // id = creature GUID counter, detail = route stop reached
+        LeaderHealth,  // id = leader entry, value = health in hundredths of a percent
+        BotRecruit,    // id = bot GUID counter
+        BotDeath,      // id = bot GUID counter
+        Broadcast,     // detail = BroadcastKind, id = recipients, value = message bytes
+        CombatStart,   // Cinematic phase over, units start moving
+        Teardown,      // detail = teardown stage finished, value = microseconds spent in it
+        End,           // detail = winning team (0 Alliance, 1 Horde), id = attacker deaths, value = defender deaths
+        Dropped,       // value = records lost because the ring buffer overflowed before a flush
+    };
+
+    enum class BroadcastKind : std::uint16_t
+    {
+        Start = 0,
+        Update,
+        End,
+    };
+
+    // Matches CitySiegeAPI::SiegeParticipantRole
+    enum class Role : std::uint8_t
+    {
+        None = 0,
+        Attacker,
+        Defender,
+    };
+
+    struct FileHeader
+    {
+        char magic[4];
+        std::uint16_t version;
+        std::uint16_t recordSize;
+        std::uint32_t cityId;
+        std::uint32_t startTime; // Unix time recording started; record times are relative to it
+    };
+
+    struct Record
+    {
+        std::uint32_t timeMs; // Milliseconds since FileHeader::startTime
+        EventType type;
+        Role role;
+        std::uint16_t detail;
+        std::uint32_t id;
+        std::uint32_t value;
+        float x;
+        float y;
+    };
+
+    static_assert(sizeof(FileHeader) == 16, "Replay file header layout changed");
+    static_assert(sizeof(Record) == 24, "Replay record layout changed");
+}
+
+#endif
@@ -0,0 +1,1033 @@
+/*
+ * This file is part of the AzerothCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ */
+
+#ifndef MOD_CITY_SIEGE_UPDATE_H
+#define MOD_CITY_SIEGE_UPDATE_H
+
+// The map side of a siege tick: movement pass, player refresh, creature respawns and the leader check.
+// Shared by the module and tools/siege_benchmark.cpp, so it only depends on the standard library.
+// Everything it needs from the world goes through a World type; the module implements it on top of
+// Map and Creature (SiegeMapWorld), the benchmark with synthetic units.
+//
+// World interface, Unit being whatever handle FindUnit returns (Creature* in the module):
+//   Map lookup
+//     Unit FindUnit(Guid const& guid)                     False when the unit is not on the map
+//     bool IsAlive(Unit unit), bool IsInCombat(Unit unit)
+//     bool IsMoving(Unit unit)                            A spline is still running
+//     bool IsFollowing(Unit unit)                         Runs a follow movement
+//     Waypoint GetPosition(Unit unit)
+//     float GetDistance(Unit unit, Waypoint const& point) Distance the route stops are checked with
+//     std::uint32_t GetSpreadSeed(Unit unit)              Picks the unit's slot around a stop
+//     void AnchorHome(Unit unit)                          Home position = current position, so it never evades
+//     void EnforceGrounding(Unit unit)
+//   Height query
+//     bool GetGroundHeight(float x, float y, float z, float& groundZ)
+//   Spline launch
+//     void MoveTo(Unit unit, Waypoint const& point)       Pathfinding move, used to rejoin the route
+//     void MoveByPath(Unit unit, std::vector<Waypoint> const& points) points[0] is the current position
+//     void Follow(Unit follower, Unit leader, float distance, float angle)
+//   Player iteration
+//     void ForEachPlayer(float x, float y, float z, float range, Fn&& fn) fn(Guid, Waypoint); range 0 = whole map
+//   Siege hooks
+//     SiegeRoute const* GetRoute(CityData const& city, Unit unit) Compiled route of the city, nullptr if unavailable;
+//                                                         unit is alive on the map and may serve navmesh queries
+//     Unit RespawnUnit(Event&, Participant&, RespawnData const&, Waypoint const& position) Registers the new GUID
+//     void OnWaypointReached(Event&, Participant const&, Unit unit)
+//     void CreditPresence(Event&, Guid const& player, std::uint32_t ms) Ignores dead players
+//     bool IsLeaderDefeated(Event&), void OnLeaderDefeated(Event&), void SampleLeaderHealth(Event&)
+//     float RandomFloat(float min, float max)
+//     Timer StartTimer(Event&, SiegeMapWorkPhase phase)  Timer::AddItems(std::uint32_t) counts the work done
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+enum CityId
+{
+    CITY_STORMWIND = 0,
+    CITY_IRONFORGE,
+    CITY_DARNASSUS,
+    CITY_EXODAR,
+    CITY_ORGRIMMAR,
+    CITY_UNDERCITY,
+    CITY_THUNDERBLUFF,
+    CITY_SILVERMOON,
+    CITY_MAX
+};
+
+struct Waypoint
+{
+    float x;
+    float y;
+    float z;
+};
+
+struct CityData
+{
+    CityId id;
+    std::string name;
+    std::uint32_t mapId;
+    float centerX;      // City center for announcement radius
+    float centerY;
+    float centerZ;
+    float spawnX;       // Configurable spawn location
+    float spawnY;
+    float spawnZ;
+    float leaderX;      // Configurable leader location
+    float leaderY;
+    float leaderZ;
+    std::uint32_t targetLeaderEntry; // Entry ID of the city leader to attack
+    std::vector<Waypoint> waypoints; // Waypoints for creatures to follow to reach the leader
+};
+
+/**
+ * @brief A city's siege path compiled from its configuration, with ground heights sampled once.
+ * Stops are the spawn point, the waypoints in order, then the leader position; segments[i] runs from
+ * stops[i] to stops[i + 1] and includes both ends. Immutable once built and shared by every siege of the city.
+ */
+struct SiegeRoute
+{
+    std::vector<Waypoint> stops;
+    std::vector<std::vector<Waypoint>> stopSlots;   // Ground-validated spread positions around each stop
+    std::vector<std::vector<Waypoint>> segments;
+    std::uint32_t navmeshSegments = 0;              // Segments taken from the navmesh, the rest are sampled straight lines
+};
+
+// Units further than this from their route (e.g. after a chase) path back to it before following it again
+constexpr float ROUTE_REJOIN_DISTANCE = 15.0f;
+
+// ---------------------------------------------------------------------------
+// SCHEDULING
+// ---------------------------------------------------------------------------
+
+/**
+ * @brief Subsystems of a siege update that run on their own cadence.
+ */
+enum SiegeSubsystem
+{
+    SIEGE_SUBSYSTEM_MOVEMENT = 0,
+    SIEGE_SUBSYSTEM_RESPAWN,
+    SIEGE_SUBSYSTEM_YELLS,
+    SIEGE_SUBSYSTEM_BROADCAST,
+    SIEGE_SUBSYSTEM_WINCHECK,
+    SIEGE_SUBSYSTEM_SUMMARY,
+    SIEGE_SUBSYSTEM_RECRUIT,
+    SIEGE_SUBSYSTEM_BOT_MOVEMENT,
+    SIEGE_SUBSYSTEM_BOT_RESPAWN,
+    SIEGE_SUBSYSTEM_PROXIMITY,
+    SIEGE_SUBSYSTEM_REPLAY,
+    SIEGE_SUBSYSTEM_MAX
+};
+
+/**
+ * @brief Per-siege cadence timers plus the resumable cursor of the movement pass.
+ */
+struct SiegeScheduler
+{
+    std::array<std::uint32_t, SIEGE_SUBSYSTEM_MAX> elapsed{}; // Milliseconds since each subsystem last ran
+    bool movementPassActive = false;                           // A movement pass is spread over several ticks
+    std::uint32_t movementCursor = 0;                          // Next unit index (attackers, then defenders)
+
+    void Reset()
+    {
+        elapsed.fill(0);
+        movementPassActive = false;
+        movementCursor = 0;
+    }
+
+    void Advance(std::uint32_t diff)
+    {
+        for (std::uint32_t& value : elapsed)
+            value += diff;
+    }
+
+    /**
+     * @brief Returns true and restarts the timer if the subsystem is due.
+     */
+    bool ConsumeIfDue(SiegeSubsystem subsystem, std::uint32_t interval)
+    {
+        if (elapsed[subsystem] < interval)
+            return false;
+
+        elapsed[subsystem] = 0;
+        return true;
+    }
+};
+
+/**
+ * @brief Wall-clock budget shared by all sieges during one world tick.
+ */
+class SiegeTickBudget
+{
+public:
+    explicit SiegeTickBudget(std::uint32_t budgetUs)
+        : _start(std::chrono::steady_clock::now()), _budgetUs(budgetUs) { }
+
+    bool Exhausted() const
+    {
+        if (!_budgetUs)
+            return false;
+
+        auto spent = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - _start);
+        return spent.count() >= static_cast<std::int64_t>(_budgetUs);
+    }
+
+private:
+    std::chrono::steady_clock::time_point _start;
+    std::uint32_t _budgetUs;
+};
+
+/**
+ * @brief Respawn queue ordered by due time (binary min-heap) with a membership set.
+ * Each update only touches entries that are actually due, and "is this unit already
+ * queued" is a hash lookup instead of a scan.
+ */
+template<class Guid, class Entry>
+class BasicSiegeRespawnQueue
+{
+public:
+    bool Contains(Guid const& guid) const
+    {
+        return _queued.count(guid) != 0;
+    }
+
+    /**
+     * @brief Queues an entry. Returns false if the GUID is already queued.
+     */
+    bool Push(Guid const& guid, std::uint32_t dueTime, Entry const& entry)
+    {
+        if (!_queued.insert(guid).second)
+            return false;
+
+        _heap.push_back({ dueTime, guid, entry });
+        std::push_heap(_heap.begin(), _heap.end(), &Node::Later);
+        return true;
+    }
+
+    bool HasDue(std::uint32_t now) const
+    {
+        return !_heap.empty() && _heap.front().dueTime <= now;
+    }
+
+    /**
+     * @brief Removes and returns the entry with the earliest due time. The queue must not be empty.
+     */
+    Entry Pop()
+    {
+        std::pop_heap(_heap.begin(), _heap.end(), &Node::Later);
+        Node node = std::move(_heap.back());
+        _heap.pop_back();
+        _queued.erase(node.guid);
+        return std::move(node.entry);
+    }
+
+    std::size_t Size() const { return _heap.size(); }
+    bool Empty() const { return _heap.empty(); }
+
+    void Clear()
+    {
+        _heap.clear();
+        _queued.clear();
+    }
+
+private:
+    struct Node
+    {
+        std::uint32_t dueTime;
+        Guid guid;
+        Entry entry;
+
+        static bool Later(Node const& left, Node const& right) { return left.dueTime > right.dueTime; }
+    };
+
+    std::vector<Node> _heap;
+    std::unordered_set<Guid> _queued;
+};
+
+// ---------------------------------------------------------------------------
+// PARTICIPANTS
+// ---------------------------------------------------------------------------
+
+// Unit tier of a siege participant, fixed when it is spawned
+enum SiegeUnitTier : std::uint8_t
+{
+    SIEGE_TIER_MINION = 0,
+    SIEGE_TIER_ELITE,
+    SIEGE_TIER_MINIBOSS,
+    SIEGE_TIER_LEADER,
+    SIEGE_TIER_DEFENDER,
+    SIEGE_TIER_MAX
+};
+
+// Direction a participant walks the city route
+enum SiegeRouteDirection : std::uint8_t
+{
+    SIEGE_ROUTE_FORWARD = 0,    // Spawn point towards the city leader (attackers)
+    SIEGE_ROUTE_REVERSE         // City leader towards the spawn point (defenders)
+};
+
+/**
+ * @brief A creature taking part in a siege, as stored in the participant registry.
+ * Everything the per-tick code branches on is tagged here at spawn time.
+ * Role is CitySiegeAPI::SiegeParticipantRole in the module.
+ */
+template<class Guid, class Role>
+struct BasicSiegeParticipant
+{
+    Guid guid;
+    std::uint32_t roleSlot = 0; // Position in spawnedCreatures (attackers) or spawnedDefenders (defenders)
+    std::uint32_t squadId = 0;  // 1-based index into SiegeEvent::squads, 0 = moves on its own
+    std::uint32_t waypoint = 0; // Route progress: stops passed (forward) or the stop being walked to (reverse)
+    Role role = Role::None;
+    SiegeUnitTier tier = SIEGE_TIER_MINION;
+    std::uint8_t faction = 2;   // TeamId the unit fights for, TEAM_NEUTRAL until registered
+    SiegeRouteDirection direction = SIEGE_ROUTE_FORWARD;
+};
+
+/**
+ * @brief Dense participant records plus a GUID -> slot index for constant time lookups.
+ */
+template<class Guid, class Role>
+struct BasicSiegeParticipantRegistry
+{
+    using Participant = BasicSiegeParticipant<Guid, Role>;
+
+    std::vector<Participant> records;
+    std::unordered_map<Guid, std::uint32_t> slots;
+
+    Participant* Find(Guid const& guid)
+    {
+        auto itr = slots.find(guid);
+        return itr != slots.end() ? &records[itr->second] : nullptr;
+    }
+
+    Participant const* Find(Guid const& guid) const
+    {
+        auto itr = slots.find(guid);
+        return itr != slots.end() ? &records[itr->second] : nullptr;
+    }
+
+    /**
+     * @brief Moves a record to a new GUID in place (respawns).
+     * @return The record, or nullptr if the old GUID was not registered.
+     */
+    Participant* Replace(Guid const& oldGuid, Guid const& newGuid)
+    {
+        auto itr = slots.find(oldGuid);
+        if (itr == slots.end())
+            return nullptr;
+
+        std::uint32_t const slot = itr->second;
+        slots.erase(itr);
+        slots[newGuid] = slot;
+
+        Participant& participant = records[slot];
+        participant.guid = newGuid;
+        return &participant;
+    }
+};
+
+/**
+ * @brief A group of units marching together: the leader follows the route, followers keep a formation slot behind it.
+ */
+template<class Guid>
+struct BasicSiegeSquad
+{
+    Guid leader;                  // Empty once every member died
+    std::vector<Guid> followers;  // Formation slot = position in this list
+};
+
+/**
+ * @brief Puts a participant back at the start of its route.
+ * @param participant The participant record.
+ * @param city The city being sieged.
+ * @return The route stop to walk to first: the first waypoint going forward, the last waypoint (or the spawn point) in reverse.
+ */
+template<class Participant>
+std::uint32_t ResetParticipantRoute(Participant& participant, CityData const& city)
+{
+    if (participant.direction == SIEGE_ROUTE_REVERSE)
+    {
+        participant.waypoint = city.waypoints.size();
+        return participant.waypoint;
+    }
+
+    participant.waypoint = 0;
+    return 1;
+}
+
+/**
+ * @brief Returns the squad a participant follows in, or nullptr if it leads a squad or moves on its own.
+ */
+template<class Guid, class Role>
+BasicSiegeSquad<Guid> const* GetFollowedSquad(std::vector<BasicSiegeSquad<Guid>> const& squads,
+    BasicSiegeParticipant<Guid, Role> const& participant)
+{
+    if (!participant.squadId)
+        return nullptr;
+
+    BasicSiegeSquad<Guid> const& squad = squads[participant.squadId - 1];
+    return squad.leader == participant.guid ? nullptr : &squad;
+}
+
+// ---------------------------------------------------------------------------
+// PROXIMITY GRID
+// ---------------------------------------------------------------------------
+
+// Edge length of a proximity grid cell in yards
+constexpr float SIEGE_GRID_CELL_SIZE = 64.0f;
+
+// What a proximity grid entry stands for; queries filter with SIEGE_PROXIMITY_MASK
+enum SiegeProximityKind : std::uint8_t
+{
+    SIEGE_PROXIMITY_ATTACKER = 0,
+    SIEGE_PROXIMITY_DEFENDER,
+    SIEGE_PROXIMITY_PLAYER
+};
+
+#define SIEGE_PROXIMITY_MASK(kind) (1u << (kind))
+
+template<class Guid>
+struct BasicSiegeSpatialEntry
+{
+    Guid guid;
+    float x;
+    float y;
+    float z;
+    std::uint8_t kind;
+    std::uint32_t generation; // Refresh generation the entry was last seen in (players only)
+};
+
+/**
+ * @brief Uniform grid over the participants and the players around a siege.
+ * Only occupied cells are stored; entries move between cells as their units move, so
+ * "who is near X" queries only look at the cells the query circle overlaps.
+ */
+template<class Guid>
+struct BasicSiegeSpatialGrid
+{
+    using Entry = BasicSiegeSpatialEntry<Guid>;
+
+    struct Location
+    {
+        std::uint64_t cell;
+        std::uint32_t index;
+    };
+
+    std::unordered_map<std::uint64_t, std::vector<Entry>> cells;
+    std::unordered_map<Guid, Location> locations;
+    std::uint32_t generation = 0; // Bumped on every player refresh
+    bool playersIndexed = false;  // Set once the players around the city were indexed
+    std::vector<Entry> playerScan; // Players found by the running refresh, indexed slice by slice
+    std::uint32_t playerScanCursor = 0;
+    bool playerScanActive = false;
+
+    static std::int32_t CellCoord(float value)
+    {
+        return std::int32_t(std::floor(value / SIEGE_GRID_CELL_SIZE));
+    }
+
+    static std::uint64_t CellKey(std::int32_t cellX, std::int32_t cellY)
+    {
+        return (std::uint64_t(std::uint32_t(cellX)) << 32) | std::uint32_t(cellY);
+    }
+
+    /**
+     * @brief Inserts an entry or moves it to its new position.
+     */
+    void Update(Guid const& guid, std::uint8_t kind, float x, float y, float z)
+    {
+        std::uint64_t const cell = CellKey(CellCoord(x), CellCoord(y));
+
+        auto itr = locations.find(guid);
+        if (itr != locations.end())
+        {
+            if (itr->second.cell == cell)
+            {
+                Entry& entry = cells[cell][itr->second.index];
+                entry.x = x;
+                entry.y = y;
+                entry.z = z;
+                entry.generation = generation;
+                return;
+            }
+
+            Detach(itr->second);
+            locations.erase(guid);
+        }
+
+        std::vector<Entry>& bucket = cells[cell];
+        locations[guid] = { cell, std::uint32_t(bucket.size()) };
+        bucket.push_back({ guid, x, y, z, kind, generation });
+    }
+
+    void Remove(Guid const& guid)
+    {
+        auto itr = locations.find(guid);
+        if (itr == locations.end())
+            return;
+
+        Detach(itr->second);
+        locations.erase(guid);
+    }
+
+    /**
+     * @brief Removes every entry of a kind that was not updated since the last generation bump.
+     */
+    void RemoveStale(std::uint8_t kind)
+    {
+        std::vector<Guid> stale;
+        for (auto const& cell : cells)
+            for (Entry const& entry : cell.second)
+                if (entry.kind == kind && entry.generation != generation)
+                    stale.push_back(entry.guid);
+
+        for (Guid const& guid : stale)
+            Remove(guid);
+    }
+
+    void Clear()
+    {
+        cells.clear();
+        locations.clear();
+        playersIndexed = false;
+        playerScan.clear();
+        playerScanCursor = 0;
+        playerScanActive = false;
+    }
+
+    /**
+     * @brief Calls fn for every entry of the kinds in kindMask within radius of a point.
+     * Walks the overlapped cells, or the occupied cells when there are fewer of those.
+     */
+    template <typename Fn>
+    void ForEachInRadius(float x, float y, float z, float radius, std::uint32_t kindMask, Fn&& fn) const
+    {
+        std::int32_t const minX = CellCoord(x - radius);
+        std::int32_t const maxX = CellCoord(x + radius);
+        std::int32_t const minY = CellCoord(y - radius);
+        std::int32_t const maxY = CellCoord(y + radius);
+        float const radiusSq = radius * radius;
+
+        auto visit = [&](std::vector<Entry> const& bucket)
+        {
+            for (Entry const& entry : bucket)
+            {
+                if (!(kindMask & SIEGE_PROXIMITY_MASK(entry.kind)))
+                    continue;
+
+                float const dx = entry.x - x;
+                float const dy = entry.y - y;
+                float const dz = entry.z - z;
+                if (dx * dx + dy * dy + dz * dz <= radiusSq)
+                    fn(entry);
+            }
+        };
+
+        std::uint64_t const overlapped = std::uint64_t(maxX - minX + 1) * std::uint64_t(maxY - minY + 1);
+        if (overlapped > cells.size())
+        {
+            for (auto const& cell : cells)
+            {
+                std::int32_t const cellX = std::int32_t(std::uint32_t(cell.first >> 32));
+                std::int32_t const cellY = std::int32_t(std::uint32_t(cell.first));
+                if (cellX >= minX && cellX <= maxX && cellY >= minY && cellY <= maxY)
+                    visit(cell.second);
+            }
+            return;
+        }
+
+        for (std::int32_t cellX = minX; cellX <= maxX; ++cellX)
+        {
+            for (std::int32_t cellY = minY; cellY <= maxY; ++cellY)
+            {
+                auto itr = cells.find(CellKey(cellX, cellY));
+                if (itr != cells.end())
+                    visit(itr->second);
+            }
+        }
+    }
+
+private:
+    void Detach(Location location)
+    {
+        auto cellItr = cells.find(location.cell);
+        std::vector<Entry>& bucket = cellItr->second;
+        if (location.index != bucket.size() - 1)
+        {
+            bucket[location.index] = bucket.back();
+            locations[bucket[location.index].guid].index = location.index;
+        }
+        bucket.pop_back();
+
+        if (bucket.empty())
+            cells.erase(cellItr);
+    }
+};
+
+// ---------------------------------------------------------------------------
+// MAP WORK
+// ---------------------------------------------------------------------------
+
+/**
+ * @brief Configuration the map work runs with, filled from CitySiege.* by the module.
+ */
+struct SiegeMapWorkSettings
+{
+    std::uint32_t minUnitsPerSlice = 8;    // CitySiege.Scheduler.MinUnitsPerSlice
+    std::uint32_t movementInterval = 500;  // CitySiege.Scheduler.MovementInterval
+    std::uint32_t respawnInterval = 1000;  // CitySiege.Scheduler.RespawnInterval
+    std::uint32_t winCheckInterval = 1000; // CitySiege.Scheduler.WinCheckInterval
+    std::uint32_t proximityInterval = 1000; // CitySiege.Scheduler.ProximityInterval
+    std::uint32_t announceRadius = 1500;   // CitySiege.AnnounceRadius, 0 = whole map
+    float squadSpacing = 3.0f;             // CitySiege.Squad.Spacing
+    bool respawnEnabled = true;            // CitySiege.Respawn.Enabled
+    bool creditPresence = false;           // Contributions are on and award points for time spent in the siege area
+};
+
+// Timed parts of the map work, handed to World::StartTimer
+enum SiegeMapWorkPhase : std::uint8_t
+{
+    SIEGE_MAP_PHASE_MOVEMENT = 0,
+    SIEGE_MAP_PHASE_RESPAWN,
+    SIEGE_MAP_PHASE_LEADER_CHECK
+};
+
+/**
+ * @brief Starts a unit along a route segment towards one of the target stop's spread slots.
+ * The unit joins the segment at the node closest to it, so units coming out of combat do not walk back.
+ * @param world The map the unit is on.
+ * @param unit The unit to move.
+ * @param route The city's compiled route.
+ * @param targetStop Index of the stop to walk to.
+ * @param reverse true when walking from the leader towards the spawn point (defenders).
+ */
+template<class World, class Unit>
+void LaunchSiegeRouteMovement(World& world, Unit unit, SiegeRoute const& route, std::uint32_t targetStop, bool reverse)
+{
+    std::uint32_t const segmentIndex = reverse ? targetStop : targetStop - 1;
+    if (targetStop >= route.stops.size() || segmentIndex >= route.segments.size())
+        return;
+
+    std::vector<Waypoint> const& nodes = route.segments[segmentIndex];
+    std::size_t const count = nodes.size();
+    auto nodeAt = [&nodes, count, reverse](std::size_t index) -> Waypoint const&
+    {
+        return nodes[reverse ? count - 1 - index : index];
+    };
+
+    Waypoint const position = world.GetPosition(unit);
+    std::size_t nearest = 0;
+    float nearestDist = std::numeric_limits<float>::max();
+    for (std::size_t i = 0; i < count; ++i)
+    {
+        float const dist = std::hypot(nodeAt(i).x - position.x, nodeAt(i).y - position.y);
+        if (dist < nearestDist)
+        {
+            nearest = i;
+            nearestDist = dist;
+        }
+    }
+
+    // Update home position before movement to prevent evading
+    world.AnchorHome(unit);
+
+    if (nearestDist > ROUTE_REJOIN_DISTANCE)
+    {
+        // Off the route: let the core path back to it, the next movement pass continues along the route
+        world.MoveTo(unit, nodeAt(nearest));
+        return;
+    }
+
+    std::vector<Waypoint> const& slots = route.stopSlots[targetStop];
+    Waypoint const& slot = slots[world.GetSpreadSeed(unit) % slots.size()];
+
+    std::vector<Waypoint> points;
+    points.reserve(count - nearest + 1);
+    points.push_back(position); // Replaced by the real position on launch
+    for (std::size_t i = nearest + 1; i + 1 < count; ++i)
+        points.push_back(nodeAt(i));
+    points.push_back(slot);
+
+    world.MoveByPath(unit, points);
+}
+
+/**
+ * @brief Advances a unit along its city's route: resumes the current leg or moves on to the next stop.
+ * @param world The map the unit is on.
+ * @param route The city's compiled route.
+ * @param unit The unit to move.
+ * @param participant The unit's participant record, which holds its route direction and progress.
+ */
+template<class World, class Unit, class Participant>
+void AdvanceSiegeRouteMovement(World& world, SiegeRoute const& route, Unit unit, Participant& participant)
+{
+    bool const reverse = participant.direction == SIEGE_ROUTE_REVERSE;
+
+    // A config reload keeps the route of a running siege, so the city may list more waypoints than it has stops
+    if (reverse && route.stops.size() >= 2 && participant.waypoint > route.stops.size() - 2)
+        participant.waypoint = route.stops.size() - 2;
+
+    std::uint32_t const currentWP = participant.waypoint;
+
+    if (reverse && currentWP == 0 && route.stops.size() <= 2)
+        return; // Defender at spawn point with no waypoints
+
+    // Stops: 0 = spawn, 1..N = waypoints, N + 1 = leader. Forward walks towards the leader, reverse towards the spawn.
+    std::uint32_t const targetStop = reverse ? currentWP : currentWP + 1;
+    if (targetStop >= route.stops.size())
+        return; // Attacker already at leader
+
+    if (world.GetDistance(unit, route.stops[targetStop]) > 10.0f)
+    {
+        // Far from the current stop and not moving: resume the leg
+        LaunchSiegeRouteMovement(world, unit, route, targetStop, reverse);
+        return;
+    }
+
+    // Close to the current stop (within 10 yards), consider it reached
+    if (reverse)
+    {
+        if (currentWP == 0)
+            return; // Already at spawn
+
+        participant.waypoint = currentWP - 1;
+        LaunchSiegeRouteMovement(world, unit, route, currentWP - 1, true);
+    }
+    else
+    {
+        if (targetStop + 1 >= route.stops.size())
+            return; // Leader reached
+
+        participant.waypoint = currentWP + 1;
+        LaunchSiegeRouteMovement(world, unit, route, targetStop + 1, false);
+    }
+}
+
+/**
+ * @brief Updates route movement for a single attacker or defender unit.
+ * @param world The map the siege takes place on.
+ * @param city The city being sieged.
+ * @param unit The unit, alive.
+ * @param participant The unit's participant record.
+ */
+template<class World, class Unit, class Participant>
+void UpdateParticipantMovement(World& world, CityData const& city, Unit unit, Participant& participant)
+{
+    // IMPORTANT: ALWAYS set home position to current position to prevent evading/returning
+    // This must be done continuously - even during combat - because combat reset can restore original home
+    world.AnchorHome(unit);
+
+    // Skip movement updates if the unit is currently in combat
+    if (world.IsInCombat(unit))
+        return;
+
+    // Check if the unit is currently moving - if so, don't interrupt
+    if (world.IsMoving(unit))
+        return;
+
+    // Continuously enforce ground movement flags (heights come from the compiled route, no terrain queries here)
+    world.EnforceGrounding(unit);
+
+    if (SiegeRoute const* route = world.GetRoute(city, unit))
+        AdvanceSiegeRouteMovement(world, *route, unit, participant);
+}
+
+/**
+ * @brief Puts a follower into its formation slot behind the squad leader, using the follow movement.
+ * Slots alternate left and right of the leader, one row further back every two followers.
+ * @param world The map the squad is on.
+ * @param follower The follower.
+ * @param leader The squad leader.
+ * @param formationSlot The follower's position in the squad's followers.
+ * @param spacing Yards between two formation rows.
+ */
+template<class World, class Unit>
+void StartSquadFollow(World& world, Unit follower, Unit leader, std::uint32_t formationSlot, float spacing)
+{
+    constexpr float pi = 3.14159265358979323846f;
+    std::uint32_t const row = formationSlot / 2 + 1;
+    float const side = (formationSlot % 2) ? 1.0f : -1.0f;
+
+    world.AnchorHome(follower);
+    world.Follow(follower, leader, spacing * row, pi + side * (pi / 6.0f));
+}
+
+/**
+ * @brief Keeps a follower in formation; only reissues the follow movement after it was interrupted (e.g. by combat).
+ * @param world The map the squad is on.
+ * @param unit The follower, alive.
+ * @param participant The follower's participant record.
+ * @param squad The follower's squad.
+ * @param spacing Yards between two formation rows.
+ */
+template<class World, class Unit, class Participant, class Squad>
+void UpdateSquadFollower(World& world, Unit unit, Participant const& participant, Squad const& squad, float spacing)
+{
+    if (world.IsInCombat(unit))
+        return;
+
+    // IMPORTANT: ALWAYS set home position to current position to prevent evading/returning
+    world.AnchorHome(unit);
+
+    if (world.IsFollowing(unit))
+        return;
+
+    auto leader = world.FindUnit(squad.leader);
+    if (!leader || !world.IsAlive(leader))
+        return;
+
+    auto slot = std::find(squad.followers.begin(), squad.followers.end(), participant.guid);
+    StartSquadFollow(world, unit, leader, std::uint32_t(std::distance(squad.followers.begin(), slot)), spacing);
+}
+
+/**
+ * @brief Runs one budgeted slice of the movement pass for a siege.
+ * The participant records are visited in order; the cursor is kept on the
+ * scheduler so the pass resumes on the next tick where this one stopped.
+ * @param event The siege event to update.
+ * @param world The siege's map.
+ * @param city The city being sieged.
+ * @param settings Map work configuration.
+ * @param budget The shared per-tick budget.
+ */
+template<class Event, class World>
+void RunMovementSlice(Event& event, World& world, CityData const& city, SiegeMapWorkSettings const& settings,
+    SiegeTickBudget const& budget)
+{
+    auto timer = world.StartTimer(event, SIEGE_MAP_PHASE_MOVEMENT);
+
+    auto& records = event.participants.records;
+    using Role = decltype(records.front().role);
+    std::uint32_t const totalCount = records.size();
+    std::uint32_t processed = 0;
+
+    while (event.scheduler.movementCursor < totalCount)
+    {
+        // Always make some progress so a busy tick cannot starve a siege indefinitely
+        if (processed >= settings.minUnitsPerSlice && budget.Exhausted())
+            break;
+
+        auto& participant = records[event.scheduler.movementCursor++];
+        std::uint32_t const waypoint = participant.waypoint;
+        ++processed;
+
+        // Dead units are queued for respawn by the death hook
+        auto unit = world.FindUnit(participant.guid);
+        if (!unit || !world.IsAlive(unit))
+        {
+            event.proximity.Remove(participant.guid);
+            continue;
+        }
+
+        Waypoint const position = world.GetPosition(unit);
+        event.proximity.Update(participant.guid, participant.role == Role::Defender ? SIEGE_PROXIMITY_DEFENDER : SIEGE_PROXIMITY_ATTACKER,
+            position.x, position.y, position.z);
+
+        // Followers only keep formation; their squad leader carries the route work
+        if (auto const* squad = GetFollowedSquad(event.squads, participant))
+            UpdateSquadFollower(world, unit, participant, *squad, settings.squadSpacing);
+        else
+            UpdateParticipantMovement(world, city, unit, participant);
+
+        if (participant.waypoint != waypoint)
+            world.OnWaypointReached(event, participant, unit);
+    }
+
+    timer.AddItems(processed);
+
+    if (event.scheduler.movementCursor >= totalCount)
+        event.scheduler.movementPassActive = false;
+}
+
+/**
+ * @brief Re-indexes the players around a siege in its proximity grid and drops those that left, a slice per call.
+ * A refresh collects the players within the announce radius plus one grid cell of the city center (the whole
+ * map when the radius is 0), then indexes them until the budget runs out. Once all are indexed, the players
+ * the grid finds within the announce radius are credited for their presence.
+ * @param event The siege event; event.proximity keeps the collected players across calls.
+ * @param world The city's map.
+ * @param city The city being sieged.
+ * @param settings Map work configuration.
+ * @param budget Tick budget; at least settings.minUnitsPerSlice players are indexed per call.
+ */
+template<class Event, class World>
+void RefreshSiegePlayerIndex(Event& event, World& world, CityData const& city, SiegeMapWorkSettings const& settings,
+    SiegeTickBudget const& budget)
+{
+    auto& grid = event.proximity;
+
+    if (!grid.playerScanActive)
+    {
+        ++grid.generation;
+        grid.playerScan.clear();
+
+        float const range = settings.announceRadius ? float(settings.announceRadius) + SIEGE_GRID_CELL_SIZE : 0.0f;
+        world.ForEachPlayer(city.centerX, city.centerY, city.centerZ, range, [&](auto const& guid, Waypoint const& position)
+        {
+            grid.playerScan.push_back({ guid, position.x, position.y, position.z, SIEGE_PROXIMITY_PLAYER, grid.generation });
+        });
+
+        grid.playerScanCursor = 0;
+        grid.playerScanActive = true;
+    }
+
+    std::uint32_t processed = 0;
+    while (grid.playerScanCursor < grid.playerScan.size())
+    {
+        if (processed >= settings.minUnitsPerSlice && budget.Exhausted())
+            return;
+
+        auto const& entry = grid.playerScan[grid.playerScanCursor++];
+        grid.Update(entry.guid, SIEGE_PROXIMITY_PLAYER, entry.x, entry.y, entry.z);
+        ++processed;
+    }
+
+    grid.RemoveStale(SIEGE_PROXIMITY_PLAYER);
+    grid.playersIndexed = true;
+    grid.playerScanActive = false;
+
+    // Time in the siege area counts towards the contribution once the fighting has started
+    if (!settings.creditPresence || event.cinematicPhase)
+        return;
+
+    auto creditPresence = [&](auto const& entry)
+    {
+        world.CreditPresence(event, entry.guid, settings.proximityInterval);
+    };
+
+    if (settings.announceRadius)
+    {
+        grid.ForEachInRadius(city.centerX, city.centerY, city.centerZ, float(settings.announceRadius),
+            SIEGE_PROXIMITY_MASK(SIEGE_PROXIMITY_PLAYER), creditPresence);
+    }
+    else
+    {
+        for (auto const& entry : grid.playerScan)
+            creditPresence(entry);
+    }
+}
+
+/**
+ * @brief Respawns the dead creatures of a siege whose respawn is due and sends them back onto the route.
+ * @param event The siege event.
+ * @param world The siege's map.
+ * @param city The city being sieged.
+ * @param currentTime Current time in seconds.
+ */
+template<class Event, class World>
+void RunSiegeRespawns(Event& event, World& world, CityData const& city, std::uint32_t currentTime)
+{
+    auto timer = world.StartTimer(event, SIEGE_MAP_PHASE_RESPAWN);
+
+    // Only entries that are due are popped; everything else stays in the queue untouched
+    while (event.deadCreatures.HasDue(currentTime))
+    {
+        auto const respawnData = event.deadCreatures.Pop();
+        timer.AddItems(1);
+
+        // The participant record outlives the dead creature and carries its tier, faction and route
+        auto* participant = event.participants.Find(respawnData.guid);
+        if (!participant)
+            continue;
+
+        Waypoint spawn;
+        if (respawnData.isDefender)
+        {
+            // Defenders respawn in a circle of 10 to 15 yards around the city leader
+            float const angle = world.RandomFloat(0.0f, 2.0f * 3.14159265358979323846f);
+            float const dist = world.RandomFloat(10.0f, 15.0f);
+            spawn = { city.leaderX + dist * std::cos(angle), city.leaderY + dist * std::sin(angle), city.leaderZ };
+        }
+        else
+        {
+            // Attackers respawn at the siege spawn point
+            spawn = { city.spawnX, city.spawnY, city.spawnZ };
+        }
+
+        // Get proper ground height at spawn location
+        float groundZ;
+        if (world.GetGroundHeight(spawn.x, spawn.y, spawn.z, groundZ))
+            spawn.z = groundZ + 0.5f;
+
+        auto unit = world.RespawnUnit(event, *participant, respawnData, spawn);
+        if (!unit)
+            continue;
+
+        // Restart the route: defenders walk back from the last waypoint (spawn point without waypoints), attackers from the first
+        std::uint32_t const targetStop = ResetParticipantRoute(*participant, city);
+
+        if (SiegeRoute const* route = world.GetRoute(city, unit))
+            LaunchSiegeRouteMovement(world, unit, *route, targetStop, participant->direction == SIEGE_ROUTE_REVERSE);
+    }
+}
+
+/**
+ * @brief Runs the map side of a siege tick: player refresh, movement pass, creature respawns and the leader check.
+ * Only touches units on the siege's own map, so the module may run it on that map's update thread.
+ * @param event The siege event to update.
+ * @param world The siege's map.
+ * @param city The city being sieged.
+ * @param settings Map work configuration.
+ * @param currentTime Current time in seconds.
+ * @param budget Budget shared by every siege updated on this thread this tick.
+ */
+template<class Event, class World>
+void RunSiegeMapWork(Event& event, World& world, CityData const& city, SiegeMapWorkSettings const& settings,
+    std::uint32_t currentTime, SiegeTickBudget const& budget)
+{
+    // Player refresh: collected on the proximity cadence, then indexed slice by slice like the movement pass
+    if (event.proximity.playerScanActive ||
+        event.scheduler.ConsumeIfDue(SIEGE_SUBSYSTEM_PROXIMITY, settings.proximityInterval))
+        RefreshSiegePlayerIndex(event, world, city, settings, budget);
+
+    // Movement pass: started on the movement cadence, then resumed slice by slice until every unit was visited
+    if (!event.cinematicPhase)
+    {
+        if (!event.scheduler.movementPassActive &&
+            event.scheduler.ConsumeIfDue(SIEGE_SUBSYSTEM_MOVEMENT, settings.movementInterval))
+        {
+            event.scheduler.movementPassActive = true;
+            event.scheduler.movementCursor = 0;
+        }
+
+        if (event.scheduler.movementPassActive)
+            RunMovementSlice(event, world, city, settings, budget);
+    }
+
+    bool const respawnDue = !event.cinematicPhase &&
+        event.scheduler.ConsumeIfDue(SIEGE_SUBSYSTEM_RESPAWN, settings.respawnInterval);
+
+    // Handle respawning of dead creatures (only during active siege, not during cinematic)
+    if (respawnDue && settings.respawnEnabled && event.deadCreatures.HasDue(currentTime))
+        RunSiegeRespawns(event, world, city, currentTime);
+
+    bool const winCheckDue = !event.cinematicPhase &&
+        event.scheduler.ConsumeIfDue(SIEGE_SUBSYSTEM_WINCHECK, settings.winCheckInterval);
+
+    // Check if city leader has died (attackers win immediately); ending the siege is up to the world
+    if (winCheckDue)
+    {
+        auto timer = world.StartTimer(event, SIEGE_MAP_PHASE_LEADER_CHECK);
+        if (world.IsLeaderDefeated(event))
+            world.OnLeaderDefeated(event);
+
+        // Sample the leader's health on the win check cadence
+        world.SampleLeaderHealth(event);
+    }
+}
+
+#endif
@@ -40,15 +40,33 @@
 #include "Weather.h"
 #include "WeatherMgr.h"
 #include "MiscPackets.h"
+#include "PathGenerator.h"
 #include "CitySiegeAPI.h"
+#include "CitySiegeReplay.h"
+#include "CitySiegeUpdate.h"
+#include "CitySiegeNet.h"
+#include "MPSCQueue.h"
+#include "DatabaseEnv.h"
+#include "AsyncCallbackProcessor.h"
 #include <vector>
 #include <array>
+#include <deque>
 #include <unordered_map>
+#include <unordered_set>
+#include <memory>
+#include <limits>
 #include <string>
+#include <string_view>
 #include <cmath>
 #include <algorithm>
 #include <iomanip>
 #include <sstream>
+#include <chrono>
+#include <mutex>
+#include <thread>
+#include <condition_variable>
+#include <fstream>
+#include <filesystem>
 
 // Conditional include for playerbots module
 #ifdef MOD_PLAYERBOTS
@@ -99,6 +117,46 @@ namespace CitySiege
         
         template<class NOT_INTERESTED> void Visit(GridRefMgr<NOT_INTERESTED>&) {}
     };
+
+    // Players within a range of a point, for cell visits that have no center object
+    class PlayerInRangeCheck
+    {
+    public:
+        PlayerInRangeCheck(float x, float y, float z, float range)
+            : _x(x), _y(y), _z(z), _range(range) {}
+
+        bool operator()(Player* player) const
+        {
+            return player && player->IsInWorld() && player->GetDistance(_x, _y, _z) <= _range;
+        }
+
+    private:
+        float _x;
+        float _y;
+        float _z;
+        float _range;
+    };
+
+    template<typename Check>
+    struct SimplePlayerListSearcher : Acore::ContainerInserter<Player*>
+    {
+        Check& _check;
+
+        template<typename Container>
+        SimplePlayerListSearcher(Container& container, Check& check)
+            : Acore::ContainerInserter<Player*>(container), _check(check) {}
+
+        void Visit(PlayerMapType& m)
+        {
+            for (PlayerMapType::iterator itr = m.begin(); itr != m.end(); ++itr)
+            {
+                if (_check(itr->GetSource()))
+                    this->Insert(itr->GetSource());
+            }
+        }
+
+        template<class NOT_INTERESTED> void Visit(GridRefMgr<NOT_INTERESTED>&) {}
+    };
 }
 
 // -----------------------------------------------------------------------------
@@ -127,6 +185,7 @@ static uint32 g_SpawnCountMinions = 15;
 static uint32 g_SpawnCountElites = 5;
 static uint32 g_SpawnCountMiniBosses = 2;
 static uint32 g_SpawnCountLeaders = 1;
+static uint32 g_SpawnTickBudget = 2000;              // Microseconds of spawning per siege per world tick (0 = spawn everything at once)
 
 // Creature entries - Using Mount Hyjal battle units for thematic appropriateness
 // Alliance attackers: Footman, Knights, Riflemen, Priests
@@ -194,6 +253,18 @@ static uint32 g_RewardHonor = 100;
 static uint32 g_RewardGoldBase = 5000; // 50 silver in copper at level 1
 static uint32 g_RewardGoldPerLevel = 5000; // 0.5 gold per level in copper
 
+// Contribution settings (rewards scale with what a player did during the siege)
+static bool g_ContributionEnabled = true;
+static uint32 g_ContributionDamagePerPoint = 1000;   // Damage dealt to siege creatures per contribution point
+static uint32 g_ContributionHealingPerPoint = 1000;  // Effective healing in the siege area per contribution point
+static uint32 g_ContributionPointsPerKill = 10;      // Points for killing a siege creature
+static uint32 g_ContributionPointsPerMinute = 5;     // Points per minute spent in the siege area during combat
+static uint32 g_ContributionExpectedPlayers = 4096;  // Contributors the ledger is preallocated for at siege start
+static uint32 g_RewardMinContribution = 25;          // Points needed for any reward
+static uint32 g_RewardFullContribution = 1000;       // Points needed for the full reward
+static uint32 g_RewardMinScalePct = 25;              // Share of the full reward paid at g_RewardMinContribution
+static uint32 g_RewardBatchSize = 10;                // Reward payouts per world update after a siege ends
+
 // Announcement messages
 static std::string g_MessageSiegeStart = "|cffff0000[City Siege]|r The city of {CITYNAME} is under attack! Defenders are needed!";
 static std::string g_MessageSiegeEnd = "|cff00ff00[City Siege]|r The siege of {CITYNAME} has ended!";
@@ -218,6 +289,7 @@ static uint32 g_PlayerbotsMinLevel = 70;
 static uint32 g_PlayerbotsMaxDefenders = 20;
 static uint32 g_PlayerbotsMaxAttackers = 20;
 static uint32 g_PlayerbotsRespawnDelay = 30; // Seconds before bot respawns after death
+static uint32 g_PlayerbotsTeleportBatchSize = 5; // Bots teleported per batch during the RP phase (0 = all at once)
 #endif
 
 // Weather settings
@@ -232,48 +304,51 @@ static uint32 g_CombatMusicId = 11804;   // Battle of Mount Hyjal (intense battl
 static uint32 g_VictoryMusicId = 16039;  // Invincible (triumphant victory music)
 static uint32 g_DefeatMusicId = 14127;   // Wrath of the Lich King main theme (somber/defeat)
 
+// Update scheduler settings
+static uint32 g_SchedulerTickBudget = 2000;          // Microseconds of movement work per world tick (0 = unlimited)
+static uint32 g_SchedulerMinUnitsPerSlice = 8;       // Units always processed per siege per tick, even over budget
+static uint32 g_SchedulerMovementInterval = 500;     // Milliseconds between movement passes
+static uint32 g_SchedulerRespawnInterval = 1000;     // Milliseconds between respawn/death checks
+static uint32 g_SchedulerYellInterval = 1000;        // Milliseconds between yell/countdown checks
+static uint32 g_SchedulerBroadcastInterval = 30000;  // Milliseconds between addon UPDATE broadcasts
+static uint32 g_SchedulerWinCheckInterval = 1000;    // Milliseconds between leader/win checks
+static uint32 g_SchedulerProximityInterval = 1000;   // Milliseconds between refreshes of the player positions in the proximity grid
+static bool g_SchedulerParallelUpdate = false;       // Run creature work on the map update threads instead of the world thread
+
+// Performance instrumentation settings
+static bool g_PerfEnabled = false;                   // Time each siege phase into histograms (.citysiege perf)
+static uint32 g_PerfLogInterval = 0;                 // Seconds between perf dumps to the log (0 = never)
+
+// Route settings
+static float g_RouteSampleStep = 8.0f;               // Yards between ground samples on straight route segments
+static uint32 g_RouteJitterSlots = 8;                // Precomputed spread positions around each route stop
+static float g_RouteJitterRadius = 5.0f;             // Radius of the spread positions in yards
+
+// Squad settings
+static uint32 g_SquadSize = 5;                       // Units per squad; only the squad leader follows the route (1 = no squads)
+static float g_SquadSpacing = 3.0f;                  // Yards between formation rows
+
+// Addon subscription settings
+static uint32 g_AddonSubscriptionTimeout = 1800;     // Seconds without a sync before a subscription expires (0 = never)
+static uint32 g_AddonFullRateRadius = 1000;          // Yards from the city center that receive full-rate updates (0 = everyone)
+static uint32 g_AddonSummaryInterval = 120000;       // Milliseconds between summary updates for distant subscribers
+
+// Recovery settings
+static bool g_RecoveryEnabled = true;                // Checkpoint siege state and recover it after a crash (read at startup)
+static std::string g_RecoveryFile = "city_siege_checkpoint.txt"; // Checkpoint file, relative to the worldserver directory
+static bool g_RecoveryResume = false;                // Resume interrupted sieges instead of rolling them back
+static uint32 g_RecoveryCheckpointInterval = 10000;  // Milliseconds between checkpoints
+
+// Replay settings
+static bool g_ReplayEnabled = false;                 // Record each siege as a binary event stream
+static std::string g_ReplayDirectory = "city_siege_replays"; // Replay directory, relative to the worldserver directory
+static uint32 g_ReplayBufferSize = 8192;             // Records buffered per siege between flushes
+static uint32 g_ReplayFlushInterval = 5000;          // Milliseconds between flushes of a siege's buffer
+
 // -----------------------------------------------------------------------------
 // CITY SIEGE DATA STRUCTURES
 // -----------------------------------------------------------------------------
 
-enum CityId
-{
-    CITY_STORMWIND = 0,
-    CITY_IRONFORGE,
-    CITY_DARNASSUS,
-    CITY_EXODAR,
-    CITY_ORGRIMMAR,
-    CITY_UNDERCITY,
-    CITY_THUNDERBLUFF,
-    CITY_SILVERMOON,
-    CITY_MAX
-};
-
-struct Waypoint
-{
-    float x;
-    float y;
-    float z;
-};
-
-struct CityData
-{
-    CityId id;
-    std::string name;
-    uint32 mapId;
-    float centerX;      // City center for announcement radius
-    float centerY;
-    float centerZ;
-    float spawnX;       // Configurable spawn location
-    float spawnY;
-    float spawnZ;
-    float leaderX;      // Configurable leader location
-    float leaderY;
-    float leaderZ;
-    uint32 targetLeaderEntry; // Entry ID of the city leader to attack
-    std::vector<Waypoint> waypoints; // Waypoints for creatures to follow to reach the leader
-};
-
 // City definitions with approximate center coordinates
 static std::vector<CityData> g_Cities = {
     { CITY_STORMWIND,   "Stormwind",      0,   -8913.23f, 554.633f,  93.7944f,  -9161.16f, 353.365f,  88.117f,   -8442.578f, 334.6064f, 122.476685f,  29611,  {} },
@@ -286,6 +361,422 @@ static std::vector<CityData> g_Cities = {
     { CITY_SILVERMOON,  "Silvermoon",     530,  9338.74f, -7277.27f, 13.7014f,   9230.47f, -6962.67f, 5.004f,     9338.74f, -7277.27f, 13.7014f,  16802, {} }
 };
 
+// Compiled routes per city, built on the first siege of each city with a live unit for navmesh queries.
+// A config reload drops them, except for cities under siege, which keep theirs until the next siege.
+static std::array<std::shared_ptr<SiegeRoute const>, CITY_MAX> g_SiegeRoutes;
+
+// ---------------------------------------------------------------------------
+// PERFORMANCE COUNTERS
+// ---------------------------------------------------------------------------
+
+/**
+ * @brief Timed phases of a siege, reported by .citysiege perf.
+ */
+enum SiegePerfPhase
+{
+    SIEGE_PERF_UPDATE = 0,    // Whole UpdateSiegeEvents call (global only)
+    SIEGE_PERF_MOVEMENT,      // One movement slice
+    SIEGE_PERF_RESPAWN,       // Creature respawn pass
+    SIEGE_PERF_LEADER_CHECK,  // Leader/win check
+    SIEGE_PERF_BROADCAST,     // Addon message serialization and delivery
+    SIEGE_PERF_BOT_UPDATE,    // Playerbot travel, teleport batches and respawns
+    SIEGE_PERF_SPAWN,         // Initial creature spawn
+    SIEGE_PERF_DESPAWN,       // Creature despawn chunk at siege end
+    SIEGE_PERF_TEARDOWN_BOTS, // Bot return batch at siege end
+    SIEGE_PERF_TEARDOWN_WORLD, // Weather restore and leader respawn at siege end
+    SIEGE_PERF_MAX
+};
+
+static char const* const SiegePerfPhaseNames[SIEGE_PERF_MAX] =
+{
+    "Update", "Movement", "Respawn", "Leader check", "Broadcast", "Bot update", "Spawn", "Despawn",
+    "Teardown bots", "Teardown world"
+};
+
+/**
+ * @brief Log2-bucketed duration histogram; fixed size, so recording never allocates.
+ */
+struct SiegePerfHistogram
+{
+    static constexpr uint32 BUCKETS = 32; // Bucket i holds durations below 2^i microseconds
+
+    std::array<uint32, BUCKETS> buckets{};
+    uint64 samples = 0;
+    uint64 totalUs = 0;
+    uint64 maxUs = 0;
+    uint64 items = 0; // Units, creatures or recipients handled across all samples
+
+    void Record(uint64 us, uint32 itemCount)
+    {
+        uint32 bucket = 0;
+        while (bucket < BUCKETS - 1 && (uint64(1) << bucket) <= us)
+            ++bucket;
+
+        ++buckets[bucket];
+        ++samples;
+        totalUs += us;
+        items += itemCount;
+        maxUs = std::max(maxUs, us);
+    }
+
+    /**
+     * @brief Returns the upper bound of the bucket holding the given percentile, capped at the maximum seen.
+     */
+    uint64 Percentile(uint32 percent) const
+    {
+        if (!samples)
+            return 0;
+
+        uint64 const rank = (samples * percent + 99) / 100;
+        uint64 seen = 0;
+        for (uint32 i = 0; i < BUCKETS; ++i)
+        {
+            seen += buckets[i];
+            if (seen >= rank)
+                return std::min(maxUs, (uint64(1) << i) - 1);
+        }
+
+        return maxUs;
+    }
+};
+
+/**
+ * @brief One histogram per phase, kept per siege and once globally.
+ */
+struct SiegePerfStats
+{
+    std::array<SiegePerfHistogram, SIEGE_PERF_MAX> phases;
+
+    void Reset()
+    {
+        phases.fill(SiegePerfHistogram());
+    }
+};
+
+static SiegePerfStats g_PerfGlobal;
+static std::mutex g_PerfGlobalLock; // Map update threads record into the global stats concurrently
+static uint32 g_PerfLogElapsed = 0;
+
+/**
+ * @brief Times a scope into the global histogram and, if given, a siege's histogram.
+ *        Does nothing beyond one flag check while instrumentation is disabled.
+ */
+class SiegePerfTimer
+{
+public:
+    explicit SiegePerfTimer(SiegePerfPhase phase, SiegePerfStats* siegeStats = nullptr)
+        : _phase(phase), _siegeStats(siegeStats), _active(g_PerfEnabled)
+    {
+        if (_active)
+            _start = std::chrono::steady_clock::now();
+    }
+
+    ~SiegePerfTimer()
+    {
+        if (!_active)
+            return;
+
+        uint64 const us = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - _start).count();
+        {
+            std::lock_guard<std::mutex> guard(g_PerfGlobalLock);
+            g_PerfGlobal.phases[_phase].Record(us, _items);
+        }
+        if (_siegeStats)
+            _siegeStats->phases[_phase].Record(us, _items);
+    }
+
+    SiegePerfTimer(SiegePerfTimer const&) = delete;
+    SiegePerfTimer& operator=(SiegePerfTimer const&) = delete;
+
+    void AddItems(uint32 count) { _items += count; }
+
+private:
+    SiegePerfPhase _phase;
+    SiegePerfStats* _siegeStats;
+    bool _active;
+    uint32 _items = 0;
+    std::chrono::steady_clock::time_point _start;
+};
+
+/**
+ * @brief Formats the phases of a stats block that recorded at least one sample.
+ * @param stats The stats to format.
+ * @return One line per phase.
+ */
+std::vector<std::string> FormatSiegePerfStats(SiegePerfStats const& stats)
+{
+    std::vector<std::string> lines;
+    for (uint32 i = 0; i < SIEGE_PERF_MAX; ++i)
+    {
+        SiegePerfHistogram const& hist = stats.phases[i];
+        if (!hist.samples)
+            continue;
+
+        char line[256];
+        snprintf(line, sizeof(line), "%s: %llu samples, avg %lluus, p50 %lluus, p95 %lluus, p99 %lluus, max %lluus, %llu items",
+            SiegePerfPhaseNames[i], (unsigned long long)hist.samples, (unsigned long long)(hist.totalUs / hist.samples),
+            (unsigned long long)hist.Percentile(50), (unsigned long long)hist.Percentile(95),
+            (unsigned long long)hist.Percentile(99), (unsigned long long)hist.maxUs, (unsigned long long)hist.items);
+        lines.emplace_back(line);
+    }
+
+    return lines;
+}
+
+/**
+ * @brief Writes a stats block to the server log.
+ * @param title Heading for the block (global or a city name).
+ * @param stats The stats to log.
+ */
+void LogSiegePerfStats(std::string const& title, SiegePerfStats const& stats)
+{
+    std::vector<std::string> const lines = FormatSiegePerfStats(stats);
+    if (lines.empty())
+        return;
+
+    LOG_INFO("server.loading", "[City Siege] Perf ({}):", title);
+    for (std::string const& line : lines)
+        LOG_INFO("server.loading", "[City Siege]   {}", line);
+}
+
+// Respawn queue ordered by due time, see BasicSiegeRespawnQueue
+template<class Entry>
+using SiegeRespawnQueue = BasicSiegeRespawnQueue<ObjectGuid, Entry>;
+
+/**
+ * @brief One position of a city's siege army formation, ground-snapped when the formation is built.
+ */
+struct SiegeSpawnSlot
+{
+    SiegeUnitTier tier;
+    float x;
+    float y;
+    float z;
+};
+
+/**
+ * @brief Spawn positions of a city's whole siege army, in spawn order: leaders first so the RP speakers
+ * exist as early as possible, then mini-bosses, elites, minions and finally the defenders.
+ * Immutable once built and shared by every siege of the city.
+ */
+struct SiegeFormation
+{
+    std::vector<SiegeSpawnSlot> slots;
+};
+
+// Formations per city, built on the first siege of each city and dropped on config reload
+static std::array<std::shared_ptr<SiegeFormation const>, CITY_MAX> g_SiegeFormations;
+
+/**
+ * @brief Everything a siege unit of one tier and side is configured with, resolved from the config once.
+ */
+struct SiegeUnitProfile
+{
+    uint32 entry = 0;                       // Creature entry (0 for leaders, they are picked per siege from the leader pools)
+    uint32 level = 0;
+    float scale = 0.0f;                     // 0 = keep the template scale
+    uint32 faction = 0;                     // Faction template once the cinematic phase is over
+    ReactStates reactState = REACT_PASSIVE; // React state once the cinematic phase is over
+};
+
+// Unit profiles per tier and TeamId of the side the unit fights for, resolved at config load
+static std::array<std::array<SiegeUnitProfile, PVP_TEAMS_COUNT>, SIEGE_TIER_MAX> g_SiegeUnitProfiles;
+
+// Movement flags that would let a siege unit leave the ground
+constexpr uint32 SIEGE_AIRBORNE_MOVEMENT_FLAGS = MOVEMENTFLAG_CAN_FLY | MOVEMENTFLAG_DISABLE_GRAVITY | MOVEMENTFLAG_FLYING | MOVEMENTFLAG_SWIMMING | MOVEMENTFLAG_HOVER;
+
+using SiegeParticipant = BasicSiegeParticipant<ObjectGuid, CitySiegeAPI::SiegeParticipantRole>;
+using SiegeParticipantRegistry = BasicSiegeParticipantRegistry<ObjectGuid, CitySiegeAPI::SiegeParticipantRole>;
+using SiegeSquad = BasicSiegeSquad<ObjectGuid>;
+
+/**
+ * @brief Playerbot recruitment counters of a siege.
+ */
+struct SiegeRecruitmentStats
+{
+    uint32 scanned = 0;     // Random bots looked at by the recruitment pass
+    uint32 eligible = 0;    // Passed the filters, before the per-faction caps
+    uint32 rejected = 0;    // Failed a filter, during the pass or when their teleport came up
+    uint32 teleported = 0;  // Actually brought to the siege
+};
+
+using SiegeSpatialEntry = BasicSiegeSpatialEntry<ObjectGuid>;
+using SiegeSpatialGrid = BasicSiegeSpatialGrid<ObjectGuid>;
+
+/**
+ * @brief What one player did for a siege. Counters saturate instead of wrapping.
+ */
+struct SiegeContribution
+{
+    uint32 damage = 0;     // Damage dealt to siege creatures
+    uint32 healing = 0;    // Effective healing done in the siege area
+    uint32 kills = 0;      // Siege creatures killed
+    uint32 presenceMs = 0; // Time spent in the siege area during combat
+
+    static void Add(uint32& counter, uint32 amount)
+    {
+        counter = amount > std::numeric_limits<uint32>::max() - counter ? std::numeric_limits<uint32>::max() : counter + amount;
+    }
+};
+
+/**
+ * @brief Per-player contribution accumulators of a siege, fed by the damage, heal and death hooks.
+ * Flat open-addressing table (linear probing) preallocated when the siege starts, so crediting a
+ * contributor never allocates unless the siege outgrows the expected player count.
+ */
+struct SiegeContributionLedger
+{
+    std::vector<ObjectGuid> keys;           // Empty GUID = free slot; size is a power of two
+    std::vector<SiegeContribution> values;  // Parallel to keys
+    uint32 count = 0;
+
+    /**
+     * @brief Drops every entry and preallocates room for a number of contributors at half load.
+     */
+    void Reserve(uint32 contributors)
+    {
+        uint32 capacity = 16;
+        while (capacity < contributors * 2)
+            capacity *= 2;
+
+        keys.assign(capacity, ObjectGuid());
+        values.assign(capacity, SiegeContribution());
+        count = 0;
+    }
+
+    SiegeContribution& Credit(ObjectGuid const& guid)
+    {
+        if ((count + 1) * 2 > keys.size())
+            Grow();
+
+        uint32 slot = FindSlot(keys, guid);
+        if (keys[slot].IsEmpty())
+        {
+            keys[slot] = guid;
+            ++count;
+        }
+
+        return values[slot];
+    }
+
+    SiegeContribution const* Find(ObjectGuid const& guid) const
+    {
+        if (keys.empty())
+            return nullptr;
+
+        uint32 const slot = FindSlot(keys, guid);
+        return keys[slot].IsEmpty() ? nullptr : &values[slot];
+    }
+
+    uint32 Size() const { return count; }
+
+    template<class Visitor>
+    void ForEach(Visitor&& visit) const
+    {
+        for (std::size_t slot = 0; slot < keys.size(); ++slot)
+            if (!keys[slot].IsEmpty())
+                visit(keys[slot], values[slot]);
+    }
+
+private:
+    // Slot holding guid, or the free slot where it would go; the table is never full
+    static uint32 FindSlot(std::vector<ObjectGuid> const& table, ObjectGuid const& guid)
+    {
+        uint32 const mask = table.size() - 1;
+        uint32 slot = std::hash<ObjectGuid>()(guid) & mask;
+        while (!table[slot].IsEmpty() && table[slot] != guid)
+            slot = (slot + 1) & mask;
+        return slot;
+    }
+
+    void Grow()
+    {
+        std::vector<ObjectGuid> oldKeys = std::move(keys);
+        std::vector<SiegeContribution> oldValues = std::move(values);
+        Reserve(std::max<uint32>(oldKeys.size(), 16));
+
+        for (std::size_t slot = 0; slot < oldKeys.size(); ++slot)
+        {
+            if (oldKeys[slot].IsEmpty())
+                continue;
+
+            uint32 const target = FindSlot(keys, oldKeys[slot]);
+            keys[target] = oldKeys[slot];
+            values[target] = oldValues[slot];
+            ++count;
+        }
+    }
+};
+
+/**
+ * @brief Fixed-size ring of replay records of one siege (format in CitySiegeReplay.h).
+ * Records are pushed by whichever thread runs the siege and drained by the world thread, which never
+ * runs during the map updates. When the ring is full the oldest undrained record is overwritten.
+ */
+struct SiegeReplayBuffer
+{
+    std::vector<CitySiegeReplay::Record> ring; // Empty while the siege is not recorded
+    uint64 written = 0; // Records pushed since recording started
+    uint64 drained = 0; // Records handed to the replay writer (or overwritten)
+    uint32 dropped = 0; // Records overwritten since the last drain
+    uint32 startTime = 0; // Unix time recording started
+    std::chrono::steady_clock::time_point start;
+    std::string path;
+    bool headerWritten = false;
+
+    bool IsRecording() const { return !ring.empty(); }
+    uint64 Pending() const { return written - drained; }
+
+    void Push(CitySiegeReplay::Record const& record)
+    {
+        if (Pending() == ring.size())
+        {
+            ++drained;
+            ++dropped;
+        }
+
+        ring[written++ % ring.size()] = record;
+    }
+
+    /**
+     * @brief Moves every undrained record to out, preceded by a Dropped record if the ring overflowed.
+     */
+    void Drain(std::vector<CitySiegeReplay::Record>& out)
+    {
+        out.reserve(out.size() + Pending() + 1);
+
+        if (dropped)
+        {
+            CitySiegeReplay::Record lost{};
+            lost.timeMs = Pending() ? ring[drained % ring.size()].timeMs : 0;
+            lost.type = CitySiegeReplay::EventType::Dropped;
+            lost.value = dropped;
+            out.push_back(lost);
+            dropped = 0;
+        }
+
+        for (; drained < written; ++drained)
+            out.push_back(ring[drained % ring.size()]);
+    }
+};
+
+/**
+ * @brief Stages an ended siege goes through before it can be removed, one budgeted step per world tick.
+ */
+enum SiegeTeardownStage : uint8
+{
+    SIEGE_TEARDOWN_NONE = 0,  // Siege still running
+    SIEGE_TEARDOWN_BOTS,      // Returning playerbots in batches
+    SIEGE_TEARDOWN_CREATURES, // Despawning attackers, then defenders, in chunks
+    SIEGE_TEARDOWN_WORLD,     // Restoring weather and the city leader
+    SIEGE_TEARDOWN_DONE
+};
+
+static char const* const SiegeTeardownStageNames[SIEGE_TEARDOWN_DONE + 1] =
+{
+    "none", "bots", "creatures", "world", "done"
+};
+
 struct SiegeEvent
 {
     CityId cityId;
@@ -294,7 +785,11 @@ struct SiegeEvent
     bool isActive;
     std::vector<ObjectGuid> spawnedCreatures;
     std::vector<ObjectGuid> spawnedDefenders; // Defender creatures
+    SiegeParticipantRegistry participants; // Indexes both lists above; only modify them through the registry helpers
+    std::vector<SiegeSquad> squads; // Formed when combat starts, see FormSiegeSquads
     ObjectGuid cityLeaderGuid; // GUID of the city leader being defended
+    bool leaderDefeated = false; // Set by the death hook when the city leader dies
+    bool leaderHandleStale = false; // Set when the leader leaves the world; the next lookup falls back to a grid search
     std::string cityLeaderName; // Name of the city leader (for RP script placeholders)
     bool cinematicPhase;
     uint32 lastYellTime;
@@ -305,11 +800,12 @@ struct SiegeEvent
     bool countdown25Announced; // 25% time remaining announced
     uint32 rpScriptIndex; // Current line in the RP script (sequential playback)
     std::vector<std::string> activeRPScript; // The chosen RP script lines for this siege
-    std::unordered_map<ObjectGuid, uint32> creatureWaypointProgress; // Tracks which waypoint each creature is on (attackers and defenders)
+    std::unordered_map<ObjectGuid, uint32> botWaypointProgress; // Tracks which waypoint each playerbot is on (creatures keep theirs in their participant record)
     
     // Playerbot participants
     std::vector<ObjectGuid> defenderBots; // Playerbots defending the city
     std::vector<ObjectGuid> attackerBots; // Playerbots attacking the city
+    std::unordered_map<ObjectGuid, bool> botSides; // Indexes both lists above: bot GUID -> is defender
     
     // Structure to store bot original positions for returning them after siege
     struct BotReturnPosition
@@ -321,6 +817,17 @@ struct SiegeEvent
         std::string rpgStrategy; // Store RPG strategy if active ("rpg", "new rpg", or empty)
     };
     std::vector<BotReturnPosition> botReturnPositions; // Original positions to return bots to
+
+    // Bots picked by the recruitment pass, teleported in batches during the RP phase
+    struct PendingBotTeleport
+    {
+        ObjectGuid botGuid;
+        bool isDefender;
+    };
+    std::vector<PendingBotTeleport> pendingBotTeleports;
+    uint32 botTeleportCursor = 0;   // Next entry of pendingBotTeleports
+    uint32 botTeleportInterval = 0; // Milliseconds between teleport batches
+    SiegeRecruitmentStats recruitment;
     
     // Bot respawn tracking: stores bot GUID, death time, and faction
     struct BotRespawnData
@@ -329,7 +836,7 @@ struct SiegeEvent
         uint32 deathTime;
         bool isDefender; // true = defender, false = attacker
     };
-    std::vector<BotRespawnData> deadBots; // Bots waiting to respawn
+    SiegeRespawnQueue<BotRespawnData> deadBots; // Bots waiting to respawn, ordered by due time
     
     // Respawn tracking: stores creature GUID, entry, and death time
     struct RespawnData
@@ -339,1853 +846,4026 @@ struct SiegeEvent
         uint32 deathTime;
         bool isDefender; // Track if this is a defender for correct respawn
     };
-    std::vector<RespawnData> deadCreatures; // Creatures waiting to respawn
+    SiegeRespawnQueue<RespawnData> deadCreatures; // Creatures waiting to respawn, ordered by due time
+
+    // Death counters, updated by the death hooks
+    uint32 attackerDeaths = 0;
+    uint32 defenderDeaths = 0;
+    uint32 botDeaths = 0;
 
     // Weather override state
     bool weatherOverridden; // Track if weather was overridden for this siege
     
+    // Staggered spawning during the cinematic phase
+    std::shared_ptr<SiegeFormation const> spawnFormation; // Formation still being spawned, null once the army is complete
+    uint32 spawnCursor = 0;                               // Next formation slot to spawn
+    std::array<uint32, SIEGE_TIER_MAX> spawnEntries{};    // Creature entry per tier for this siege
+
+    // Update scheduling
+    SiegeScheduler scheduler; // Per-subsystem cadence timers and movement pass cursor
+    SiegePerfStats perf;      // Phase timings of this siege (only filled while CitySiege.Perf.Enable is on)
+    SiegeSpatialGrid proximity; // Participants (moved by the movement pass) and players on the city map (refreshed on their own cadence)
+    SiegeContributionLedger contributions; // What each player did for this siege, used to scale rewards
+    SiegeReplayBuffer replay; // Event stream of this siege (only filled while CitySiege.Replay.Enable is on)
+
+    // Staged teardown once the siege has ended, see ProcessSiegeTeardown
+    SiegeTeardownStage teardownStage = SIEGE_TEARDOWN_NONE;
+    uint32 teardownCursor = 0;         // Next bot or creature of the current stage
+    bool teardownRespawnLeader = true; // Whether the world stage respawns a dead city leader
+    std::array<uint64, SIEGE_TEARDOWN_DONE> teardownUs{};   // Microseconds spent per stage
+    std::array<uint32, SIEGE_TEARDOWN_DONE> teardownTicks{}; // World ticks that worked on each stage
+
     // Addon communication tracking
-    uint32 lastAddonBroadcast; // Last time addon data was broadcast (for frequent updates)
+    SiegeAddonBaseline addonBaseline; // Shared baseline of the compact UPDATE deltas
 };
 
 // Active siege events
 static std::vector<SiegeEvent> g_ActiveSieges;
 static uint32 g_NextSiegeTime = 0;
+static bool g_CheckpointRequested = false; // Set when a siege starts or ends so the next tick checkpoints right away
 
-namespace CitySiegeAPI
-{
-    std::vector<ActiveSiegeSnapshot> GetActiveSieges()
-    {
-        std::vector<ActiveSiegeSnapshot> snapshots;
-        snapshots.reserve(g_ActiveSieges.size());
+// Global participant index (creature GUID -> city of the siege it belongs to; a city has one siege at a time, see IsCityUnderSiege)
+// Sieges on different maps respawn creatures from their own map update threads, so the index is locked
+static std::unordered_map<ObjectGuid, CityId> g_ParticipantCities;
+static std::mutex g_ParticipantCitiesLock;
 
-        uint32 const currentTime = static_cast<uint32>(time(nullptr));
-        for (SiegeEvent const& event : g_ActiveSieges)
-        {
-            CityData const& city = g_Cities[event.cityId];
+/**
+ * @brief Looks up the city of the siege a creature belongs to.
+ * @return True if the creature is a registered siege participant.
+ */
+bool FindParticipantCity(ObjectGuid const& guid, CityId& cityId)
+{
+    std::lock_guard<std::mutex> guard(g_ParticipantCitiesLock);
+    auto cityItr = g_ParticipantCities.find(guid);
+    if (cityItr == g_ParticipantCities.end())
+        return false;
 
-            ActiveSiegeSnapshot snapshot;
-            snapshot.cityId = static_cast<uint32>(event.cityId);
-            snapshot.cityName = city.name;
-            snapshot.startTime = event.startTime;
-            snapshot.endTime = event.endTime;
-            snapshot.isActive = event.isActive;
-            snapshot.cinematicPhase = event.cinematicPhase;
-            snapshot.remainingSeconds = event.endTime > currentTime ?
-                event.endTime - currentTime : 0;
-            snapshot.spawnedAttackers = event.spawnedCreatures.size();
-            snapshot.spawnedDefenders = event.spawnedDefenders.size();
-            snapshot.attackerBotCount = event.attackerBots.size();
-            snapshot.defenderBotCount = event.defenderBots.size();
+    cityId = cityItr->second;
+    return true;
+}
 
-            snapshots.push_back(std::move(snapshot));
-        }
+/**
+ * @brief Whether an object is on the map of a siege (running or tearing down).
+ * Hooks called from every map thread check this first, so units elsewhere never touch siege state.
+ */
+bool IsOnSiegeMap(WorldObject const* object)
+{
+    // Sieges are only fought on the non-instanced continents
+    if (object->GetInstanceId() != 0)
+        return false;
 
-        return snapshots;
+    uint32 const mapId = object->GetMapId();
+    for (SiegeEvent const& event : g_ActiveSieges)
+    {
+        if (g_Cities[event.cityId].mapId == mapId)
+            return true;
     }
 
-    SiegeParticipantRole GetActiveCreatureRole(ObjectGuid const& creatureGuid)
-    {
-        if (creatureGuid.IsEmpty())
-            return SiegeParticipantRole::None;
+    return false;
+}
 
-        for (SiegeEvent const& event : g_ActiveSieges)
-        {
-            if (!event.isActive)
-                continue;
-
-            if (std::find(event.spawnedCreatures.begin(), event.spawnedCreatures.end(), creatureGuid) != event.spawnedCreatures.end())
-                return SiegeParticipantRole::Attacker;
-
-            if (std::find(event.spawnedDefenders.begin(), event.spawnedDefenders.end(), creatureGuid) != event.spawnedDefenders.end())
-                return SiegeParticipantRole::Defender;
-        }
+// -----------------------------------------------------------------------------
+// PARTICIPANT REGISTRY
+// -----------------------------------------------------------------------------
 
-        return SiegeParticipantRole::None;
-    }
+/**
+ * @brief Returns the role list (spawnedCreatures or spawnedDefenders) that holds participants of a role.
+ */
+std::vector<ObjectGuid>& GetParticipantRoleList(SiegeEvent& event, CitySiegeAPI::SiegeParticipantRole role)
+{
+    return role == CitySiegeAPI::SiegeParticipantRole::Defender ? event.spawnedDefenders : event.spawnedCreatures;
 }
 
-// Waypoint visualization tracking
-static std::unordered_map<uint32, std::vector<ObjectGuid>> g_WaypointVisualizations; // cityId -> vector of creature GUIDs
-
-// -----------------------------------------------------------------------------
-// HELPER FUNCTIONS
-// -----------------------------------------------------------------------------
+/**
+ * @brief Adds a creature to a siege's participant registry and role list.
+ * @param event The siege event the creature belongs to.
+ * @param guid GUID of the creature.
+ * @param role Whether the creature attacks or defends.
+ * @param tier The creature's unit tier.
+ */
+void RegisterSiegeParticipant(SiegeEvent& event, ObjectGuid const& guid, CitySiegeAPI::SiegeParticipantRole role, SiegeUnitTier tier)
+{
+    if (guid.IsEmpty() || event.participants.slots.count(guid))
+        return;
 
-// Forward declarations
-void DistributeRewards(const SiegeEvent& event, const CityData& city, int winningTeam = -1);
-void RestoreSiegeWeather(const CityData& city, SiegeEvent& event);
-void BroadcastSiegeDataToAddon(const SiegeEvent& event, const std::string& messageType,
-    const std::string& winner = "unknown");
-void DespawnSiegeCreatures(SiegeEvent& event);
-void DeactivatePlayerbotsFromSiege(SiegeEvent& event);
+    std::vector<ObjectGuid>& roleList = GetParticipantRoleList(event, role);
+    bool const isDefender = role == CitySiegeAPI::SiegeParticipantRole::Defender;
+    bool const isAllianceCity = event.cityId <= CITY_EXODAR;
+
+    SiegeParticipant participant;
+    participant.guid = guid;
+    participant.role = role;
+    participant.tier = tier;
+    participant.faction = (isDefender == isAllianceCity) ? TEAM_ALLIANCE : TEAM_HORDE;
+    participant.direction = isDefender ? SIEGE_ROUTE_REVERSE : SIEGE_ROUTE_FORWARD;
+    participant.roleSlot = roleList.size();
+    ResetParticipantRoute(participant, g_Cities[event.cityId]);
+
+    roleList.push_back(guid);
+    event.participants.slots[guid] = event.participants.records.size();
+    event.participants.records.push_back(participant);
+
+    std::lock_guard<std::mutex> guard(g_ParticipantCitiesLock);
+    g_ParticipantCities[guid] = event.cityId;
+}
 
-bool IsAllianceCity(CityId cityId)
+/**
+ * @brief Looks up a participant record by GUID.
+ * @return The record, or nullptr if the creature is not part of this siege.
+ */
+SiegeParticipant const* FindSiegeParticipant(SiegeEvent const& event, ObjectGuid const& guid)
 {
-    return cityId <= CITY_EXODAR;
+    return event.participants.Find(guid);
 }
 
-bool IsPlayerInAnnounceScope(Player* player, const CityData& city)
+SiegeParticipant* FindSiegeParticipant(SiegeEvent& event, ObjectGuid const& guid)
 {
-    return player && (g_AnnounceRadius == 0 ||
-        player->GetDistance(city.centerX, city.centerY, city.centerZ) <= g_AnnounceRadius);
+    return event.participants.Find(guid);
 }
 
-std::string GetTeamName(int teamId)
+/**
+ * @brief Leaders and mini-bosses are the units that speak RP lines and combat yells.
+ */
+bool IsSiegeSpeaker(SiegeParticipant const& participant)
 {
-    switch (teamId)
-    {
-        case 0:
-            return "Alliance";
-        case 1:
-            return "Horde";
-        default:
-            return "unknown";
-    }
+    return participant.tier == SIEGE_TIER_LEADER || participant.tier == SIEGE_TIER_MINIBOSS;
 }
 
-std::string ReplacePlaceholder(std::string message, std::string const& placeholder,
-    std::string const& value)
+/**
+ * @brief Swaps the GUID of a participant in place, keeping its role and list position (used on respawn).
+ * @return True if the old GUID was registered.
+ */
+bool ReplaceSiegeParticipant(SiegeEvent& event, ObjectGuid const& oldGuid, ObjectGuid const& newGuid)
 {
-    size_t pos = 0;
-    while ((pos = message.find(placeholder, pos)) != std::string::npos)
-    {
-        message.replace(pos, placeholder.length(), value);
-        pos += value.length();
-    }
+    SiegeParticipant* participant = event.participants.Replace(oldGuid, newGuid);
+    if (!participant)
+        return false;
+
+    GetParticipantRoleList(event, participant->role)[participant->roleSlot] = newGuid;
+    event.proximity.Remove(oldGuid); // The new creature is indexed by the next movement pass
 
-    return message;
+    std::lock_guard<std::mutex> guard(g_ParticipantCitiesLock);
+    g_ParticipantCities.erase(oldGuid);
+    g_ParticipantCities[newGuid] = event.cityId;
+    return true;
 }
 
-void SendSiegeScopedMessage(CityData const& city, std::string const& message)
+/**
+ * @brief Removes a participant from the registry and its role list by swapping with the last entry.
+ * @note Changes the order of the role list and the records, so a movement pass in progress may visit one unit twice or skip it once.
+ */
+void RemoveSiegeParticipant(SiegeEvent& event, ObjectGuid const& guid)
 {
-    if (g_AnnounceRadius == 0)
-    {
-        sWorldSessionMgr->SendServerMessage(SERVER_MSG_STRING, message);
+    auto itr = event.participants.slots.find(guid);
+    if (itr == event.participants.slots.end())
         return;
+
+    uint32 const slot = itr->second;
+    event.participants.slots.erase(itr);
+    event.proximity.Remove(guid);
+    {
+        std::lock_guard<std::mutex> guard(g_ParticipantCitiesLock);
+        g_ParticipantCities.erase(guid);
     }
 
-    Map* map = sMapMgr->FindMap(city.mapId, 0);
-    if (!map)
-        return;
+    std::vector<SiegeParticipant>& records = event.participants.records;
+    SiegeParticipant const removed = records[slot];
 
-    Map::PlayerList const& players = map->GetPlayers();
-    for (auto itr = players.begin(); itr != players.end(); ++itr)
+    // Swap-remove from the role list and fix the moved participant's role slot
+    std::vector<ObjectGuid>& roleList = GetParticipantRoleList(event, removed.role);
+    if (removed.roleSlot != roleList.size() - 1)
     {
-        if (Player* player = itr->GetSource())
-            if (IsPlayerInAnnounceScope(player, city))
-                ChatHandler(player->GetSession()).PSendSysMessage(message.c_str());
+        roleList[removed.roleSlot] = roleList.back();
+        records[event.participants.slots[roleList[removed.roleSlot]]].roleSlot = removed.roleSlot;
+    }
+    roleList.pop_back();
+
+    // Swap-remove from the dense records and fix the moved record's index entry
+    if (slot != records.size() - 1)
+    {
+        records[slot] = records.back();
+        event.participants.slots[records[slot].guid] = slot;
     }
+    records.pop_back();
 }
 
-void SendAddonMessageToPlayer(Player* player, const std::string& message)
+/**
+ * @brief Drops every participant of a siege from the registry, the role lists and the global index.
+ */
+void ClearSiegeParticipants(SiegeEvent& event)
 {
-    if (!player || !player->IsInWorld())
-        return;
-
-    WorldPacket data(SMSG_MESSAGECHAT, 2000);
-    data << uint8(CHAT_MSG_SYSTEM);
-    data << uint32(LANG_UNIVERSAL);
-    data << uint64(0);
-    data << uint32(0);
-    data << uint64(player->GetGUID().GetRawValue());
-
-    std::string fullMessage = "CitySiege\t" + message;
-    data << uint32(fullMessage.length() + 1);
-    data << fullMessage;
-    data << uint8(0);
+    {
+        std::lock_guard<std::mutex> guard(g_ParticipantCitiesLock);
+        for (SiegeParticipant const& participant : event.participants.records)
+            g_ParticipantCities.erase(participant.guid);
+    }
 
-    player->GetSession()->SendPacket(&data);
+    event.participants.records.clear();
+    event.participants.slots.clear();
+    event.proximity.Clear();
+    event.spawnedCreatures.clear();
+    event.spawnedDefenders.clear();
+    event.squads.clear();
 }
 
-void RespawnCityLeaderIfNeeded(const CityData& city, const SiegeEvent& event)
+/**
+ * @brief Appends an event to a siege's replay buffer; does nothing unless the siege is being recorded.
+ * Field meanings per event type are listed in CitySiegeReplay::EventType.
+ */
+void RecordSiegeReplay(SiegeEvent& event, CitySiegeReplay::EventType type, CitySiegeAPI::SiegeParticipantRole role = CitySiegeAPI::SiegeParticipantRole::None,
+    uint16 detail = 0, uint32 id = 0, uint32 value = 0, float x = 0.0f, float y = 0.0f)
 {
-    Map* map = sMapMgr->FindMap(city.mapId, 0);
-    if (!map)
+    if (!event.replay.IsRecording())
         return;
 
-    Creature* existingLeader = nullptr;
-    if (event.cityLeaderGuid)
-        existingLeader = map->GetCreature(event.cityLeaderGuid);
+    CitySiegeReplay::Record record;
+    record.timeMs = static_cast<uint32>(std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - event.replay.start).count());
+    record.type = type;
+    record.role = static_cast<CitySiegeReplay::Role>(role);
+    record.detail = detail;
+    record.id = id;
+    record.value = value;
+    record.x = x;
+    record.y = y;
+    event.replay.Push(record);
+}
 
-    if (!existingLeader)
+namespace CitySiegeAPI
+{
+    std::vector<ActiveSiegeSnapshot> GetActiveSieges()
     {
-        std::list<Creature*> leaderList;
-        CitySiege::CreatureEntryCheck check(city.targetLeaderEntry);
-        CitySiege::SimpleCreatureListSearcher<CitySiege::CreatureEntryCheck> searcher(leaderList, check);
-        Cell::VisitObjects(city.leaderX, city.leaderY, map, searcher, 100.0f);
+        std::vector<ActiveSiegeSnapshot> snapshots;
+        snapshots.reserve(g_ActiveSieges.size());
 
-        for (Creature* leader : leaderList)
+        uint32 const currentTime = static_cast<uint32>(time(nullptr));
+        for (SiegeEvent const& event : g_ActiveSieges)
         {
-            if (leader)
-            {
-                existingLeader = leader;
-                break;
-            }
+            CityData const& city = g_Cities[event.cityId];
+
+            ActiveSiegeSnapshot snapshot;
+            snapshot.cityId = static_cast<uint32>(event.cityId);
+            snapshot.cityName = city.name;
+            snapshot.startTime = event.startTime;
+            snapshot.endTime = event.endTime;
+            snapshot.isActive = event.isActive;
+            snapshot.cinematicPhase = event.cinematicPhase;
+            snapshot.remainingSeconds = event.endTime > currentTime ?
+                event.endTime - currentTime : 0;
+            snapshot.spawnedAttackers = event.spawnedCreatures.size();
+            snapshot.spawnedDefenders = event.spawnedDefenders.size();
+            snapshot.attackerBotCount = event.attackerBots.size();
+            snapshot.defenderBotCount = event.defenderBots.size();
+            snapshot.pendingCreatureRespawns = event.deadCreatures.Size();
+            snapshot.pendingBotRespawns = event.deadBots.Size();
+            snapshot.attackerDeaths = event.attackerDeaths;
+            snapshot.defenderDeaths = event.defenderDeaths;
+
+            snapshots.push_back(std::move(snapshot));
         }
+
+        return snapshots;
     }
 
-    if (existingLeader && !existingLeader->IsAlive())
+    SiegeParticipantRole GetActiveCreatureRole(ObjectGuid const& creatureGuid)
     {
-        existingLeader->Respawn();
+        if (creatureGuid.IsEmpty())
+            return SiegeParticipantRole::None;
 
-        if (g_DebugMode)
+        CityId cityId;
+        if (!FindParticipantCity(creatureGuid, cityId))
+            return SiegeParticipantRole::None;
+
+        for (SiegeEvent const& event : g_ActiveSieges)
         {
-            LOG_INFO("server.loading", "[City Siege] Respawned city leader {} (entry {})",
-                     existingLeader->GetName(), city.targetLeaderEntry);
+            if (event.cityId != cityId || !event.isActive)
+                continue;
+
+            if (SiegeParticipant const* participant = FindSiegeParticipant(event, creatureGuid))
+                return participant->role;
         }
+
+        return SiegeParticipantRole::None;
     }
 }
 
-void FinalizeSiegeCleanup(SiegeEvent& event, const std::string& winnerForAddon,
-    bool respawnLeader = true)
-{
-    const CityData& city = g_Cities[event.cityId];
+// Waypoint visualization tracking
+static std::unordered_map<uint32, std::vector<ObjectGuid>> g_WaypointVisualizations; // cityId -> vector of creature GUIDs
 
-    event.isActive = false;
-    DespawnSiegeCreatures(event);
-    BroadcastSiegeDataToAddon(event, "END", winnerForAddon);
-    RestoreSiegeWeather(city, event);
+// -----------------------------------------------------------------------------
+// HELPER FUNCTIONS
+// -----------------------------------------------------------------------------
 
-    if (respawnLeader)
-        RespawnCityLeaderIfNeeded(city, event);
+// Forward declarations
+void DistributeRewards(const SiegeEvent& event, const CityData& city, int winningTeam = -1);
+void RestoreSiegeWeather(const CityData& city, SiegeEvent& event);
+void BroadcastSiegeDataToAddon(SiegeEvent& event, const std::string& messageType,
+    const std::string& winner = "unknown", bool includeSummaryTier = true);
+bool DespawnSiegeCreatures(SiegeEvent& event, SiegeTickBudget const& budget);
+bool DeactivatePlayerbotsFromSiege(SiegeEvent& event, SiegeTickBudget const& budget);
+void StartSiegeEvent(int targetCityId);
+bool IsCityUnderSiege(CityId cityId);
+void FlushSiegeReplay(SiegeEvent& event, bool final);
+#ifdef MOD_PLAYERBOTS
+void ReleaseBotTravelPool(CityId cityId);
+#endif
 
-    DeactivatePlayerbotsFromSiege(event);
+bool IsAllianceCity(CityId cityId)
+{
+    return cityId <= CITY_EXODAR;
+}
 
-    event.creatureWaypointProgress.clear();
-    event.deadCreatures.clear();
-    event.deadBots.clear();
-    event.activeRPScript.clear();
+/**
+ * @brief Gets the configured respawn delay for a siege creature.
+ * @param tier The creature's unit tier.
+ * @return Respawn delay in seconds.
+ */
+uint32 GetCreatureRespawnDelay(SiegeUnitTier tier)
+{
+    switch (tier)
+    {
+        case SIEGE_TIER_DEFENDER: return g_RespawnTimeDefender;
+        case SIEGE_TIER_LEADER:   return g_RespawnTimeLeader;
+        case SIEGE_TIER_MINIBOSS: return g_RespawnTimeMiniBoss;
+        case SIEGE_TIER_ELITE:    return g_RespawnTimeElite;
+        default:                  return g_RespawnTimeMinion;
+    }
 }
 
+// ---------------------------------------------------------------------------
+// CONTRIBUTION LEDGER
+// ---------------------------------------------------------------------------
+
 /**
- * @brief Sets siege weather for a city during RP phase
- * @param city The city to set weather for
- * @param event The siege event to store original weather state
+ * @brief Converts a player's contribution into points using the CitySiege.Contribution.* weights.
+ * @param contribution The player's accumulators.
+ * @return The contribution points.
  */
-void SetSiegeWeather(const CityData& city, SiegeEvent& event)
+uint32 GetContributionPoints(SiegeContribution const& contribution)
 {
-    if (!g_WeatherEnabled)
-        return;
+    uint64 points = 0;
+    if (g_ContributionDamagePerPoint)
+        points += contribution.damage / g_ContributionDamagePerPoint;
+    if (g_ContributionHealingPerPoint)
+        points += contribution.healing / g_ContributionHealingPerPoint;
+    points += uint64(contribution.kills) * g_ContributionPointsPerKill;
+    points += uint64(contribution.presenceMs) * g_ContributionPointsPerMinute / 60000;
+
+    return uint32(std::min<uint64>(points, std::numeric_limits<uint32>::max()));
+}
 
-    Map* map = sMapMgr->FindMap(city.mapId, 0);
-    if (!map)
-        return;
+/**
+ * @brief Returns the share of the full reward (in percent) a contribution earns.
+ * @param points The player's contribution points.
+ * @return 0 below CitySiege.Reward.MinContribution, then rising linearly from MinScalePct to 100.
+ */
+uint32 GetContributionRewardScale(uint32 points)
+{
+    if (!g_ContributionEnabled)
+        return 100;
 
-    // Get the zone ID from the city center coordinates
-    uint32 zoneId = map->GetZoneId(0, city.centerX, city.centerY, city.centerZ);
+    if (points < g_RewardMinContribution)
+        return 0;
 
-    // Prime the default weather cache so we can restore the zone's default weather later.
-    map->GetOrGenerateZoneDefaultWeather(zoneId);
-    event.weatherOverridden = true;
+    if (points >= g_RewardFullContribution || g_RewardFullContribution <= g_RewardMinContribution)
+        return 100;
 
-    // Set siege weather
-    map->SetZoneWeather(zoneId, g_WeatherType, g_WeatherGrade);
+    uint64 const progress = uint64(points - g_RewardMinContribution) * (100 - g_RewardMinScalePct) /
+        (g_RewardFullContribution - g_RewardMinContribution);
+    return g_RewardMinScalePct + uint32(progress);
+}
 
-    if (g_DebugMode)
+/**
+ * @brief Finds the active siege whose announce area contains a unit.
+ * @param unit The unit to locate.
+ * @return The siege, or nullptr if the unit is not near any active siege.
+ */
+SiegeEvent* FindSiegeAround(Unit* unit)
+{
+    for (SiegeEvent& event : g_ActiveSieges)
     {
-        LOG_INFO("server.loading", "[City Siege] Set siege weather for {} (zone {}): type={}, grade={:.2f}",
-                 city.name, zoneId, static_cast<uint32>(g_WeatherType), g_WeatherGrade);
+        if (!event.isActive || event.cinematicPhase)
+            continue;
+
+        CityData const& city = g_Cities[event.cityId];
+        if (unit->GetMapId() != city.mapId)
+            continue;
+
+        if (!g_AnnounceRadius || unit->GetDistance(city.centerX, city.centerY, city.centerZ) <= g_AnnounceRadius)
+            return &event;
     }
+
+    return nullptr;
 }
 
 /**
- * @brief Restores original weather for a city after siege ends
- * @param city The city to restore weather for
- * @param event The siege event containing original weather state
+ * @brief Whether a unit fights in a siege: a participant creature, the city leader or a recruited bot.
+ * Only call this from the siege's own map thread.
  */
-void RestoreSiegeWeather(const CityData& city, SiegeEvent& event)
+bool IsSiegeCombatant(SiegeEvent const& event, ObjectGuid const& guid)
 {
-    if (!g_WeatherEnabled || !event.weatherOverridden)
-        return;
+    return guid == event.cityLeaderGuid || FindSiegeParticipant(event, guid) || event.botSides.count(guid);
+}
 
-    Map* map = sMapMgr->FindMap(city.mapId, 0);
-    if (!map)
+/**
+ * @brief Credits the player behind a killing blow in a siege.
+ * @param event The siege the victim fought in.
+ * @param killer The killing unit; pets and totems credit their owner.
+ */
+void CreditSiegeKill(SiegeEvent& event, Unit* killer)
+{
+    if (!g_ContributionEnabled || !killer)
         return;
 
-    // Get the zone ID from the city center coordinates
-    uint32 zoneId = map->GetZoneId(0, city.centerX, city.centerY, city.centerZ);
+    if (Player* player = killer->GetCharmerOrOwnerPlayerOrPlayerItself())
+        SiegeContribution::Add(event.contributions.Credit(player->GetGUID()).kills, 1);
+}
 
-    // Clear the override and restore the zone's default/generated weather.
-    map->SetZoneWeather(zoneId, WEATHER_STATE_FINE, 0.0f);
+/**
+ * @brief Credits a player for damage dealt to a siege creature, the city leader or a siege bot (reported from the map update thread of the siege).
+ * @param attacker The unit dealing the damage; pets and totems credit their owner.
+ * @param victim The damaged unit.
+ * @param damage The damage dealt.
+ */
+void RecordSiegeDamage(Unit* attacker, Unit* victim, uint32 damage)
+{
+    if (!g_ContributionEnabled || !damage)
+        return;
 
-    if (Weather* defaultWeather = map->GetOrGenerateZoneDefaultWeather(zoneId))
-    {
-        Map::PlayerList const& players = map->GetPlayers();
-        for (auto itr = players.begin(); itr != players.end(); ++itr)
-        {
-            if (Player* player = itr->GetSource())
-                if (player->GetZoneId() == zoneId)
-                    defaultWeather->SendWeatherUpdateToPlayer(player);
-        }
-    }
+    Player* player = attacker->GetCharmerOrOwnerPlayerOrPlayerItself();
+    if (!player)
+        return;
 
-    if (g_DebugMode)
+    for (SiegeEvent& event : g_ActiveSieges)
     {
-        LOG_INFO("server.loading", "[City Siege] Restored default weather for {} (zone {})",
-                 city.name, zoneId);
-    }
+        if (!event.isActive || g_Cities[event.cityId].mapId != victim->GetMapId() || !IsSiegeCombatant(event, victim->GetGUID()))
+            continue;
 
-    event.weatherOverridden = false;
+        // Only damage that actually came off the creature counts
+        SiegeContribution::Add(event.contributions.Credit(player->GetGUID()).damage, std::min(damage, victim->GetHealth()));
+        return;
+    }
 }
 
 /**
- * @brief Loads the configuration for the City Siege module.
+ * @brief Credits a player for healing a player in combat inside a siege area.
+ * @param healer The unit healing; pets and totems credit their owner.
+ * @param receiver The healed unit.
+ * @param gain The amount healed.
  */
-void LoadCitySiegeConfiguration()
+void RecordSiegeHealing(Unit* healer, Unit* receiver, uint32 gain)
 {
-    g_CitySiegeEnabled = sConfigMgr->GetOption<bool>("CitySiege.Enabled", true);
-    g_DebugMode = sConfigMgr->GetOption<bool>("CitySiege.DebugMode", false);
+    if (!g_ContributionEnabled || !gain || !receiver->IsPlayer() || !receiver->IsInCombat())
+        return;
 
-    // Timer settings (convert minutes to seconds)
-    g_TimerMin = sConfigMgr->GetOption<uint32>("CitySiege.TimerMin", 120) * 60;
-    g_TimerMax = sConfigMgr->GetOption<uint32>("CitySiege.TimerMax", 240) * 60;
-    g_EventDuration = sConfigMgr->GetOption<uint32>("CitySiege.EventDuration", 30) * 60;
+    Player* player = healer->GetCharmerOrOwnerPlayerOrPlayerItself();
+    if (!player)
+        return;
 
-    // Event settings
-    g_AllowMultipleCities = sConfigMgr->GetOption<bool>("CitySiege.AllowMultipleCities", false);
-    g_AnnounceRadius = sConfigMgr->GetOption<uint32>("CitySiege.AnnounceRadius", 1500);
-    g_MinimumLevel = sConfigMgr->GetOption<uint32>("CitySiege.MinimumLevel", 1);
+    SiegeEvent* event = FindSiegeAround(receiver);
+    if (!event)
+        return;
+
+    // Overhealing does not count
+    uint32 const missing = receiver->GetMaxHealth() - receiver->GetHealth();
+    SiegeContribution::Add(event->contributions.Credit(player->GetGUID()).healing, std::min(gain, missing));
+}
+
+bool IsPlayerInAnnounceScope(Player* player, const CityData& city)
+{
+    return player && (g_AnnounceRadius == 0 ||
+        player->GetDistance(city.centerX, city.centerY, city.centerZ) <= g_AnnounceRadius);
+}
+
+/**
+ * @brief Collects the players on a city's map that are within CitySiege.AnnounceRadius of its center.
+ * Served from the proximity grid of the city's active siege once its players are indexed, with a scan
+ * of the map's players as fallback (and when the radius is 0, which means the whole map).
+ * @param city The city to look around.
+ * @return The players in scope.
+ */
+std::vector<Player*> GetPlayersInAnnounceScope(const CityData& city)
+{
+    std::vector<Player*> result;
+
+    if (g_AnnounceRadius > 0)
+    {
+        for (SiegeEvent const& event : g_ActiveSieges)
+        {
+            if (!event.isActive || event.cityId != city.id || !event.proximity.playersIndexed)
+                continue;
+
+            event.proximity.ForEachInRadius(city.centerX, city.centerY, city.centerZ, float(g_AnnounceRadius),
+                SIEGE_PROXIMITY_MASK(SIEGE_PROXIMITY_PLAYER), [&](SiegeSpatialEntry const& entry)
+            {
+                Player* player = ObjectAccessor::FindPlayer(entry.guid);
+                if (player && player->IsInWorld() && player->GetMapId() == city.mapId)
+                    result.push_back(player);
+            });
+            return result;
+        }
+    }
+
+    Map* map = sMapMgr->FindMap(city.mapId, 0);
+    if (!map)
+        return result;
+
+    Map::PlayerList const& players = map->GetPlayers();
+    for (auto itr = players.begin(); itr != players.end(); ++itr)
+    {
+        if (Player* player = itr->GetSource())
+            if (IsPlayerInAnnounceScope(player, city))
+                result.push_back(player);
+    }
+
+    return result;
+}
+
+std::string GetTeamName(int teamId)
+{
+    switch (teamId)
+    {
+        case 0:
+            return "Alliance";
+        case 1:
+            return "Horde";
+        default:
+            return "unknown";
+    }
+}
+
+// -----------------------------------------------------------------------------
+// SIEGE TEXT
+// -----------------------------------------------------------------------------
+
+// Values a text template can insert
+enum SiegeTextField : uint8
+{
+    SIEGE_TEXT_LITERAL = 0,
+    SIEGE_TEXT_CITY,        // {CITY} or {CITYNAME}
+    SIEGE_TEXT_LEADER,      // {LEADER}
+    SIEGE_TEXT_ACTION       // {ACTION}
+};
+
+struct SiegeTextSegment
+{
+    SiegeTextField field = SIEGE_TEXT_LITERAL;
+    std::string literal;    // Only set for SIEGE_TEXT_LITERAL
+};
+
+/**
+ * @brief A configured message, yell or RP line split into literal and placeholder segments once at config load.
+ */
+struct SiegeTextTemplate
+{
+    std::vector<SiegeTextSegment> segments;
+    size_t literalLength = 0;   // Total length of the literal segments, used to size the render buffer
+};
+
+struct SiegeTextArgs
+{
+    std::string_view city;
+    std::string_view leader;
+    std::string_view action;
+};
+
+// Compiled text templates, rebuilt by CompileSiegeTexts on every config load
+static SiegeTextTemplate g_TextSiegeStart;
+static SiegeTextTemplate g_TextSiegeEnd;
+static SiegeTextTemplate g_TextReward;
+static std::vector<SiegeTextTemplate> g_TextLeaderSpawnYells;
+static std::vector<SiegeTextTemplate> g_TextCombatYells;
+static std::vector<std::vector<SiegeTextTemplate>> g_TextRPScriptsAlliance;
+static std::vector<std::vector<SiegeTextTemplate>> g_TextRPScriptsHorde;
+
+/**
+ * @brief Splits a template into literal and placeholder segments. Unknown {TOKENS} stay literal.
+ * @param text The configured text.
+ */
+SiegeTextTemplate CompileSiegeText(std::string_view text)
+{
+    static constexpr std::pair<std::string_view, SiegeTextField> placeholders[] =
+    {
+        { "{CITYNAME}", SIEGE_TEXT_CITY },
+        { "{CITY}",     SIEGE_TEXT_CITY },
+        { "{LEADER}",   SIEGE_TEXT_LEADER },
+        { "{ACTION}",   SIEGE_TEXT_ACTION }
+    };
+
+    SiegeTextTemplate compiled;
+    std::string literal;
+
+    auto flushLiteral = [&compiled, &literal]()
+    {
+        if (literal.empty())
+            return;
+
+        compiled.literalLength += literal.size();
+        compiled.segments.push_back({ SIEGE_TEXT_LITERAL, std::move(literal) });
+        literal.clear();
+    };
+
+    size_t pos = 0;
+    while (pos < text.size())
+    {
+        bool matched = false;
+        if (text[pos] == '{')
+        {
+            for (auto const& [token, field] : placeholders)
+            {
+                if (text.compare(pos, token.size(), token) == 0)
+                {
+                    flushLiteral();
+                    compiled.segments.push_back({ field, {} });
+                    pos += token.size();
+                    matched = true;
+                    break;
+                }
+            }
+        }
+
+        if (!matched)
+            literal += text[pos++];
+    }
+
+    flushLiteral();
+    return compiled;
+}
+
+/**
+ * @brief Compiles every non-empty entry of a delimiter separated list.
+ */
+std::vector<SiegeTextTemplate> CompileSiegeTextList(std::string_view text, char delimiter)
+{
+    std::vector<SiegeTextTemplate> compiled;
+
+    size_t start = 0;
+    while (start <= text.size())
+    {
+        size_t end = text.find(delimiter, start);
+        if (end == std::string_view::npos)
+            end = text.size();
+
+        if (end > start)
+            compiled.push_back(CompileSiegeText(text.substr(start, end - start)));
+
+        start = end + 1;
+    }
+
+    return compiled;
+}
+
+/**
+ * @brief Compiles RP scripts: scripts are separated by '|', lines within a script by ';'.
+ */
+std::vector<std::vector<SiegeTextTemplate>> CompileSiegeScripts(std::string_view text)
+{
+    std::vector<std::vector<SiegeTextTemplate>> scripts;
+
+    size_t start = 0;
+    while (start <= text.size())
+    {
+        size_t end = text.find('|', start);
+        if (end == std::string_view::npos)
+            end = text.size();
+
+        std::vector<SiegeTextTemplate> lines = CompileSiegeTextList(text.substr(start, end - start), ';');
+        if (!lines.empty())
+            scripts.push_back(std::move(lines));
+
+        start = end + 1;
+    }
+
+    return scripts;
+}
+
+/**
+ * @brief Renders a template into a reusable buffer in a single pass.
+ * @return The rendered text; valid until the next call on the same thread.
+ */
+std::string const& RenderSiegeText(SiegeTextTemplate const& text, SiegeTextArgs const& args)
+{
+    thread_local std::string buffer;
+    buffer.clear();
+    buffer.reserve(text.literalLength + 64);
+
+    for (SiegeTextSegment const& segment : text.segments)
+    {
+        switch (segment.field)
+        {
+            case SIEGE_TEXT_LITERAL: buffer += segment.literal; break;
+            case SIEGE_TEXT_CITY:    buffer += args.city; break;
+            case SIEGE_TEXT_LEADER:  buffer += args.leader; break;
+            case SIEGE_TEXT_ACTION:  buffer += args.action; break;
+        }
+    }
+
+    return buffer;
+}
+
+/**
+ * @brief Picks a random template from a pool, or nullptr if the pool is empty.
+ */
+SiegeTextTemplate const* PickSiegeText(std::vector<SiegeTextTemplate> const& pool)
+{
+    return pool.empty() ? nullptr : &pool[urand(0, pool.size() - 1)];
+}
+
+/**
+ * @brief Compiles all configured messages, yells and RP scripts.
+ */
+void CompileSiegeTexts()
+{
+    g_TextSiegeStart = CompileSiegeText(g_MessageSiegeStart);
+    g_TextSiegeEnd = CompileSiegeText(g_MessageSiegeEnd);
+    g_TextReward = CompileSiegeText(g_MessageReward);
+    g_TextLeaderSpawnYells = CompileSiegeTextList(g_YellLeaderSpawn, ';');
+    g_TextCombatYells = CompileSiegeTextList(g_YellsCombat, ';');
+    g_TextRPScriptsAlliance = CompileSiegeScripts(g_RPScriptsAlliance);
+    g_TextRPScriptsHorde = CompileSiegeScripts(g_RPScriptsHorde);
+}
+
+void SendSiegeScopedMessage(CityData const& city, std::string const& message)
+{
+    if (g_AnnounceRadius == 0)
+    {
+        sWorldSessionMgr->SendServerMessage(SERVER_MSG_STRING, message);
+        return;
+    }
+
+    for (Player* player : GetPlayersInAnnounceScope(city))
+        ChatHandler(player->GetSession()).PSendSysMessage(message.c_str());
+}
+
+/**
+ * @brief Builds the system chat packet that carries an addon message.
+ * The packet does not name its receiver, so one packet can be sent to any number of players.
+ * @param message The addon message (without the CitySiege prefix).
+ */
+WorldPacket BuildAddonMessagePacket(const std::string& message)
+{
+    std::string fullMessage = ADDON_MESSAGE_PREFIX + message;
+
+    WorldPacket data(SMSG_MESSAGECHAT, 1 + 4 + 8 + 4 + 8 + 4 + fullMessage.length() + 2);
+    data << uint8(CHAT_MSG_SYSTEM);
+    data << uint32(LANG_UNIVERSAL);
+    data << uint64(0);
+    data << uint32(0);
+    data << uint64(0);
+    data << uint32(fullMessage.length() + 1);
+    data << fullMessage;
+    data << uint8(0);
+
+    return data;
+}
+
+void SendAddonMessageToPlayer(Player* player, const std::string& message)
+{
+    if (!player || !player->IsInWorld())
+        return;
+
+    WorldPacket data = BuildAddonMessagePacket(message);
+    player->GetSession()->SendPacket(&data);
+}
+
+/**
+ * @brief Searches the grid around a city's throne for its leader.
+ * @param city The city whose leader to find.
+ * @param map The city's map.
+ * @param aliveOnly Only accept a living leader.
+ * @return The leader creature, or nullptr if none was found.
+ */
+Creature* FindCityLeaderInGrid(const CityData& city, Map* map, bool aliveOnly)
+{
+    std::list<Creature*> leaderList;
+    CitySiege::CreatureEntryCheck check(city.targetLeaderEntry);
+    CitySiege::SimpleCreatureListSearcher<CitySiege::CreatureEntryCheck> searcher(leaderList, check);
+    Cell::VisitObjects(city.leaderX, city.leaderY, map, searcher, 100.0f);
+
+    for (Creature* leader : leaderList)
+    {
+        if (leader && (!aliveOnly || leader->IsAlive()))
+            return leader;
+    }
+
+    return nullptr;
+}
+
+/**
+ * @brief Resolves the city leader of a siege through its cached GUID.
+ * Only searches the grid when the cached handle is stale, and refreshes the cache with the result.
+ * @param event The siege event.
+ * @param map The city's map.
+ * @return The leader creature, or nullptr if it could not be found.
+ */
+Creature* ResolveSiegeLeader(SiegeEvent& event, Map* map)
+{
+    if (event.cityLeaderGuid && !event.leaderHandleStale)
+    {
+        if (Creature* leader = map->GetCreature(event.cityLeaderGuid))
+            return leader;
+    }
+
+    Creature* leader = FindCityLeaderInGrid(g_Cities[event.cityId], map, false);
+    if (leader)
+    {
+        event.cityLeaderGuid = leader->GetGUID();
+        event.leaderHandleStale = false;
+    }
+
+    return leader;
+}
+
+/**
+ * @brief Checks whether the city leader of a siege has fallen.
+ * Death and removal are reported by hooks, so this is free while the cached handle is valid.
+ * @param event The siege event.
+ * @param map The city's map.
+ * @return True if the leader is dead, or was being tracked and can no longer be found.
+ */
+bool IsSiegeLeaderDefeated(SiegeEvent& event, Map* map)
+{
+    if (event.leaderDefeated)
+        return true;
+
+    if (event.cityLeaderGuid && !event.leaderHandleStale)
+        return false;
+
+    bool const hadLeader = !event.cityLeaderGuid.IsEmpty();
+    Creature* leader = ResolveSiegeLeader(event, map);
+    if (!leader)
+        return hadLeader; // The leader we were defending is gone
+
+    event.leaderDefeated = !leader->IsAlive();
+    return event.leaderDefeated;
+}
+
+void RespawnCityLeaderIfNeeded(const CityData& city, const SiegeEvent& event)
+{
+    Map* map = sMapMgr->FindMap(city.mapId, 0);
+    if (!map)
+        return;
+
+    Creature* existingLeader = nullptr;
+    if (event.cityLeaderGuid)
+        existingLeader = map->GetCreature(event.cityLeaderGuid);
+
+    if (!existingLeader)
+        existingLeader = FindCityLeaderInGrid(city, map, false);
+
+    if (existingLeader && !existingLeader->IsAlive())
+    {
+        existingLeader->Respawn();
+
+        if (g_DebugMode)
+        {
+            LOG_INFO("server.loading", "[City Siege] Respawned city leader {} (entry {})",
+                     existingLeader->GetName(), city.targetLeaderEntry);
+        }
+    }
+}
+
+/**
+ * @brief Advances the teardown of an ended siege: bots are returned in batches, then creatures are
+ * despawned in chunks, then weather and the city leader are restored. Stops when the budget runs out.
+ * @param event The ended siege.
+ * @param budget Budget shared with the other sieges of this tick; always makes progress on one stage.
+ * @return True once the siege is fully torn down and may be removed.
+ */
+bool ProcessSiegeTeardown(SiegeEvent& event, SiegeTickBudget const& budget)
+{
+    if (event.teardownStage == SIEGE_TEARDOWN_NONE)
+        return false;
+
+    const CityData& city = g_Cities[event.cityId];
+
+    while (event.teardownStage != SIEGE_TEARDOWN_DONE)
+    {
+        SiegeTeardownStage const stage = event.teardownStage;
+        auto const stageStart = std::chrono::steady_clock::now();
+        bool stageDone = true;
+
+        switch (stage)
+        {
+            case SIEGE_TEARDOWN_BOTS:
+                stageDone = DeactivatePlayerbotsFromSiege(event, budget);
+                break;
+            case SIEGE_TEARDOWN_CREATURES:
+                stageDone = DespawnSiegeCreatures(event, budget);
+                break;
+            case SIEGE_TEARDOWN_WORLD:
+            {
+                SiegePerfTimer perfTimer(SIEGE_PERF_TEARDOWN_WORLD, &event.perf);
+                RestoreSiegeWeather(city, event);
+
+                if (event.teardownRespawnLeader)
+                    RespawnCityLeaderIfNeeded(city, event);
+
+#ifdef MOD_PLAYERBOTS
+                ReleaseBotTravelPool(event.cityId);
+#endif
+                break;
+            }
+            default:
+                break;
+        }
+
+        event.teardownUs[stage] += std::chrono::duration_cast<std::chrono::microseconds>(
+            std::chrono::steady_clock::now() - stageStart).count();
+        ++event.teardownTicks[stage];
+
+        if (!stageDone)
+            return false;
+
+        RecordSiegeReplay(event, CitySiegeReplay::EventType::Teardown, CitySiegeAPI::SiegeParticipantRole::None, stage, 0,
+            static_cast<uint32>(std::min<uint64>(event.teardownUs[stage], std::numeric_limits<uint32>::max())));
+
+        event.teardownStage = static_cast<SiegeTeardownStage>(stage + 1);
+        event.teardownCursor = 0;
+
+        if (budget.Exhausted() && event.teardownStage != SIEGE_TEARDOWN_DONE)
+            return false;
+    }
+
+    if (g_DebugMode || g_PerfEnabled)
+    {
+        LOG_INFO("server.loading", "[City Siege] {} teardown finished: bots {}us/{} ticks, creatures {}us/{} ticks, world {}us/{} ticks",
+                 city.name,
+                 event.teardownUs[SIEGE_TEARDOWN_BOTS], event.teardownTicks[SIEGE_TEARDOWN_BOTS],
+                 event.teardownUs[SIEGE_TEARDOWN_CREATURES], event.teardownTicks[SIEGE_TEARDOWN_CREATURES],
+                 event.teardownUs[SIEGE_TEARDOWN_WORLD], event.teardownTicks[SIEGE_TEARDOWN_WORLD]);
+    }
+
+    if (g_PerfEnabled)
+        LogSiegePerfStats(city.name + " siege", event.perf);
+
+    FlushSiegeReplay(event, true);
+
+    g_CheckpointRequested = true;
+    return true;
+}
+
+/**
+ * @brief Ends a siege and starts its teardown.
+ * @param event The siege to end.
+ * @param winnerForAddon Winner reported in the addon END message.
+ * @param respawnLeader Whether a dead city leader is respawned.
+ * @param immediate Tear everything down now instead of spreading it over the following ticks
+ * (used at shutdown and by the cleanup command).
+ */
+void FinalizeSiegeCleanup(SiegeEvent& event, const std::string& winnerForAddon,
+    bool respawnLeader = true, bool immediate = false)
+{
+    if (event.teardownStage != SIEGE_TEARDOWN_NONE)
+    {
+        // Already ending; only finish the remaining stages if asked to
+        if (immediate)
+            ProcessSiegeTeardown(event, SiegeTickBudget(0));
+        return;
+    }
+
+    event.isActive = false;
+    BroadcastSiegeDataToAddon(event, "END", winnerForAddon);
+
+    event.teardownStage = SIEGE_TEARDOWN_BOTS;
+    event.teardownCursor = 0;
+    event.teardownRespawnLeader = respawnLeader;
+
+    event.botWaypointProgress.clear();
+    event.pendingBotTeleports.clear();
+    event.botTeleportCursor = 0;
+    event.spawnFormation.reset();
+    event.spawnCursor = 0;
+    event.deadCreatures.Clear();
+    event.deadBots.Clear();
+    event.activeRPScript.clear();
+
+    if (immediate)
+        ProcessSiegeTeardown(event, SiegeTickBudget(0));
+}
+
+/**
+ * @brief Sets siege weather for a city during RP phase
+ * @param city The city to set weather for
+ * @param event The siege event to store original weather state
+ */
+void SetSiegeWeather(const CityData& city, SiegeEvent& event)
+{
+    if (!g_WeatherEnabled)
+        return;
+
+    Map* map = sMapMgr->FindMap(city.mapId, 0);
+    if (!map)
+        return;
+
+    // Get the zone ID from the city center coordinates
+    uint32 zoneId = map->GetZoneId(0, city.centerX, city.centerY, city.centerZ);
+
+    // Prime the default weather cache so we can restore the zone's default weather later.
+    map->GetOrGenerateZoneDefaultWeather(zoneId);
+    event.weatherOverridden = true;
+
+    // Set siege weather
+    map->SetZoneWeather(zoneId, g_WeatherType, g_WeatherGrade);
+
+    if (g_DebugMode)
+    {
+        LOG_INFO("server.loading", "[City Siege] Set siege weather for {} (zone {}): type={}, grade={:.2f}",
+                 city.name, zoneId, static_cast<uint32>(g_WeatherType), g_WeatherGrade);
+    }
+}
+
+/**
+ * @brief Restores original weather for a city after siege ends
+ * @param city The city to restore weather for
+ * @param event The siege event containing original weather state
+ */
+void RestoreSiegeWeather(const CityData& city, SiegeEvent& event)
+{
+    if (!g_WeatherEnabled || !event.weatherOverridden)
+        return;
+
+    Map* map = sMapMgr->FindMap(city.mapId, 0);
+    if (!map)
+        return;
+
+    // Get the zone ID from the city center coordinates
+    uint32 zoneId = map->GetZoneId(0, city.centerX, city.centerY, city.centerZ);
+
+    // Clear the override and restore the zone's default/generated weather.
+    map->SetZoneWeather(zoneId, WEATHER_STATE_FINE, 0.0f);
+
+    if (Weather* defaultWeather = map->GetOrGenerateZoneDefaultWeather(zoneId))
+    {
+        Map::PlayerList const& players = map->GetPlayers();
+        for (auto itr = players.begin(); itr != players.end(); ++itr)
+        {
+            if (Player* player = itr->GetSource())
+                if (player->GetZoneId() == zoneId)
+                    defaultWeather->SendWeatherUpdateToPlayer(player);
+        }
+    }
+
+    if (g_DebugMode)
+    {
+        LOG_INFO("server.loading", "[City Siege] Restored default weather for {} (zone {})",
+                 city.name, zoneId);
+    }
+
+    event.weatherOverridden = false;
+}
+
+// ---------------------------------------------------------------------------
+// UNIT PROFILES
+// ---------------------------------------------------------------------------
+
+/**
+ * @brief Resolves the unit profile of every tier and side from the current configuration.
+ * Units of TEAM_ALLIANCE use the Alliance entries and faction, TEAM_HORDE the Horde ones.
+ */
+void ResolveSiegeUnitProfiles()
+{
+    // Attackers only aggro NPCs on their own when both aggro options are enabled
+    ReactStates const attackerReactState = (g_AggroPlayers && g_AggroNPCs) ? REACT_AGGRESSIVE : REACT_DEFENSIVE;
+
+    for (uint8 team = TEAM_ALLIANCE; team < PVP_TEAMS_COUNT; ++team)
+    {
+        bool const alliance = team == TEAM_ALLIANCE;
+        uint32 const faction = alliance ? 84 : 83; // 84 = Alliance, 83 = Horde
+
+        g_SiegeUnitProfiles[SIEGE_TIER_MINION][team] = { alliance ? g_CreatureAllianceMinion : g_CreatureHordeMinion, g_LevelMinion, 0.0f, faction, attackerReactState };
+        g_SiegeUnitProfiles[SIEGE_TIER_ELITE][team] = { alliance ? g_CreatureAllianceElite : g_CreatureHordeElite, g_LevelElite, 0.0f, faction, attackerReactState };
+        g_SiegeUnitProfiles[SIEGE_TIER_MINIBOSS][team] = { alliance ? g_CreatureAllianceMiniBoss : g_CreatureHordeMiniBoss, g_LevelMiniBoss, g_ScaleMiniBoss, faction, attackerReactState };
+        g_SiegeUnitProfiles[SIEGE_TIER_LEADER][team] = { 0, g_LevelLeader, g_ScaleLeader, faction, attackerReactState };
+        g_SiegeUnitProfiles[SIEGE_TIER_DEFENDER][team] = { alliance ? g_CreatureAllianceDefender : g_CreatureHordeDefender, g_LevelDefender, 0.0f, faction, REACT_AGGRESSIVE };
+    }
+}
+
+/**
+ * @brief Returns the profile of a unit tier fighting for the given side.
+ * @param tier The unit tier.
+ * @param team The TeamId the unit fights for.
+ */
+SiegeUnitProfile const& GetSiegeUnitProfile(SiegeUnitTier tier, uint8 team)
+{
+    return g_SiegeUnitProfiles[tier][team == TEAM_ALLIANCE ? TEAM_ALLIANCE : TEAM_HORDE];
+}
+
+/**
+ * @brief Keeps a siege unit on the ground. The flags are only touched when one of them is set,
+ * so the steady state sends no movement packets.
+ * @param creature The siege unit.
+ */
+void EnforceSiegeUnitGrounding(Creature* creature)
+{
+    if (!creature->HasUnitMovementFlag(SIEGE_AIRBORNE_MOVEMENT_FLAGS))
+        return;
+
+    creature->SetDisableGravity(false);
+    creature->SetCanFly(false);
+    creature->SetHover(false);
+    creature->RemoveUnitMovementFlag(SIEGE_AIRBORNE_MOVEMENT_FLAGS);
+}
+
+/**
+ * @brief Applies a unit profile to a siege creature, skipping every field that already has the wanted value.
+ * @param creature The siege unit.
+ * @param profile The profile of its tier and side.
+ * @param combatReady False while the cinematic phase runs: the unit stays neutral, passive and unattackable.
+ */
+void ApplySiegeUnitProfile(Creature* creature, SiegeUnitProfile const& profile, bool combatReady)
+{
+    if (creature->GetLevel() != profile.level)
+        creature->SetLevel(profile.level);
+
+    if (profile.scale > 0.0f && creature->GetObjectScale() != profile.scale)
+        creature->SetObjectScale(profile.scale);
+
+    uint32 const faction = combatReady ? profile.faction : 35; // Neutral during cinematic
+    if (creature->GetFaction() != faction)
+        creature->SetFaction(faction);
+
+    ReactStates const reactState = combatReady ? profile.reactState : REACT_PASSIVE;
+    if (creature->GetReactState() != reactState)
+        creature->SetReactState(reactState);
+
+    if (combatReady == creature->HasUnitFlag(UNIT_FLAG_NON_ATTACKABLE))
+    {
+        if (combatReady)
+            creature->RemoveUnitFlag(UNIT_FLAG_NON_ATTACKABLE);
+        else
+            creature->SetUnitFlag(UNIT_FLAG_NON_ATTACKABLE);
+    }
+
+    EnforceSiegeUnitGrounding(creature);
+
+    // Prevent return to home position after combat
+    creature->SetWalk(false);
+    creature->GetMotionMaster()->Clear(false);
+    creature->GetMotionMaster()->MoveIdle();
+}
+
+/**
+ * @brief Snaps a siege unit to the ground below its current position.
+ * @param creature The siege unit.
+ */
+void GroundSiegeUnit(Creature* creature)
+{
+    float x = creature->GetPositionX();
+    float y = creature->GetPositionY();
+    float z = creature->GetPositionZ();
+    float groundZ = creature->GetMap()->GetHeight(x, y, z + 5.0f, true, 50.0f);
+
+    if (groundZ > INVALID_HEIGHT)
+    {
+        creature->UpdateGroundPositionZ(x, y, groundZ);
+        creature->Relocate(x, y, groundZ, creature->GetOrientation());
+    }
+}
+
+/**
+ * @brief Loads the configuration for the City Siege module.
+ */
+void LoadCitySiegeConfiguration()
+{
+    g_CitySiegeEnabled = sConfigMgr->GetOption<bool>("CitySiege.Enabled", true);
+    g_DebugMode = sConfigMgr->GetOption<bool>("CitySiege.DebugMode", false);
+
+    // Timer settings (convert minutes to seconds)
+    g_TimerMin = sConfigMgr->GetOption<uint32>("CitySiege.TimerMin", 120) * 60;
+    g_TimerMax = sConfigMgr->GetOption<uint32>("CitySiege.TimerMax", 240) * 60;
+    g_EventDuration = sConfigMgr->GetOption<uint32>("CitySiege.EventDuration", 30) * 60;
+
+    // Event settings
+    g_AllowMultipleCities = sConfigMgr->GetOption<bool>("CitySiege.AllowMultipleCities", false);
+    g_AnnounceRadius = sConfigMgr->GetOption<uint32>("CitySiege.AnnounceRadius", 1500);
+    g_MinimumLevel = sConfigMgr->GetOption<uint32>("CitySiege.MinimumLevel", 1);
+
+    // City enable/disable flags
+    g_CityEnabled["Stormwind"] = sConfigMgr->GetOption<bool>("CitySiege.Stormwind.Enabled", true);
+    g_CityEnabled["Ironforge"] = sConfigMgr->GetOption<bool>("CitySiege.Ironforge.Enabled", true);
+    g_CityEnabled["Darnassus"] = sConfigMgr->GetOption<bool>("CitySiege.Darnassus.Enabled", true);
+    g_CityEnabled["Exodar"] = sConfigMgr->GetOption<bool>("CitySiege.Exodar.Enabled", true);
+    g_CityEnabled["Orgrimmar"] = sConfigMgr->GetOption<bool>("CitySiege.Orgrimmar.Enabled", true);
+    g_CityEnabled["Undercity"] = sConfigMgr->GetOption<bool>("CitySiege.Undercity.Enabled", true);
+    g_CityEnabled["ThunderBluff"] = sConfigMgr->GetOption<bool>("CitySiege.ThunderBluff.Enabled", true);
+    g_CityEnabled["Silvermoon"] = sConfigMgr->GetOption<bool>("CitySiege.Silvermoon.Enabled", true);
+
+    // Spawn counts
+    g_SpawnCountMinions = sConfigMgr->GetOption<uint32>("CitySiege.SpawnCount.Minions", 15);
+    g_SpawnCountElites = sConfigMgr->GetOption<uint32>("CitySiege.SpawnCount.Elites", 5);
+    g_SpawnCountMiniBosses = sConfigMgr->GetOption<uint32>("CitySiege.SpawnCount.MiniBosses", 2);
+    g_SpawnCountLeaders = sConfigMgr->GetOption<uint32>("CitySiege.SpawnCount.Leaders", 1);
+    g_SpawnTickBudget = sConfigMgr->GetOption<uint32>("CitySiege.Spawn.TickBudget", 2000);
+
+    // Creature entries - Mount Hyjal battle units
+    g_CreatureAllianceMinion = sConfigMgr->GetOption<uint32>("CitySiege.Creature.Alliance.Minion", 17919);   // Alliance Footman
+    g_CreatureAllianceElite = sConfigMgr->GetOption<uint32>("CitySiege.Creature.Alliance.Elite", 17920);     // Alliance Knight
+    g_CreatureAllianceMiniBoss = sConfigMgr->GetOption<uint32>("CitySiege.Creature.Alliance.MiniBoss", 17921); // Alliance Rifleman
+    g_CreatureHordeMinion = sConfigMgr->GetOption<uint32>("CitySiege.Creature.Horde.Minion", 17932);         // Horde Grunt
+    g_CreatureHordeElite = sConfigMgr->GetOption<uint32>("CitySiege.Creature.Horde.Elite", 17933);           // Tauren Warrior
+    g_CreatureHordeMiniBoss = sConfigMgr->GetOption<uint32>("CitySiege.Creature.Horde.MiniBoss", 17934);     // Horde Headhunter
+
+    // Aggro settings
+    g_AggroPlayers = sConfigMgr->GetOption<bool>("CitySiege.AggroPlayers", true);
+    g_AggroNPCs = sConfigMgr->GetOption<bool>("CitySiege.AggroNPCs", true);
+
+    // Defender settings
+    g_DefendersEnabled = sConfigMgr->GetOption<bool>("CitySiege.Defenders.Enabled", true);
+    g_DefendersCount = sConfigMgr->GetOption<uint32>("CitySiege.Defenders.Count", 10);
+    g_CreatureAllianceDefender = sConfigMgr->GetOption<uint32>("CitySiege.Creature.Alliance.Defender", 17919);
+    g_CreatureHordeDefender = sConfigMgr->GetOption<uint32>("CitySiege.Creature.Horde.Defender", 17932);
+
+    // Level settings
+    g_LevelLeader = sConfigMgr->GetOption<uint32>("CitySiege.Level.Leader", 80);
+    g_LevelMiniBoss = sConfigMgr->GetOption<uint32>("CitySiege.Level.MiniBoss", 80);
+    g_LevelElite = sConfigMgr->GetOption<uint32>("CitySiege.Level.Elite", 75);
+    g_LevelMinion = sConfigMgr->GetOption<uint32>("CitySiege.Level.Minion", 70);
+    g_LevelDefender = sConfigMgr->GetOption<uint32>("CitySiege.Level.Defender", 70);
+
+    // Scale settings
+    g_ScaleLeader = sConfigMgr->GetOption<float>("CitySiege.Scale.Leader", 1.6f);
+    g_ScaleMiniBoss = sConfigMgr->GetOption<float>("CitySiege.Scale.MiniBoss", 1.3f);
+
+    // Cinematic settings
+    g_CinematicDelay = sConfigMgr->GetOption<uint32>("CitySiege.CinematicDelay", 150);
+    g_YellFrequency = sConfigMgr->GetOption<uint32>("CitySiege.YellFrequency", 30);
+
+    // Respawn settings
+    g_RespawnEnabled = sConfigMgr->GetOption<bool>("CitySiege.Respawn.Enabled", true);
+    g_RespawnTimeLeader = sConfigMgr->GetOption<uint32>("CitySiege.Respawn.LeaderTime", 300);
+    g_RespawnTimeMiniBoss = sConfigMgr->GetOption<uint32>("CitySiege.Respawn.MiniBossTime", 180);
+    g_RespawnTimeElite = sConfigMgr->GetOption<uint32>("CitySiege.Respawn.EliteTime", 120);
+    g_RespawnTimeMinion = sConfigMgr->GetOption<uint32>("CitySiege.Respawn.MinionTime", 60);
+    g_RespawnTimeDefender = sConfigMgr->GetOption<uint32>("CitySiege.Defenders.RespawnTime", 45);
+
+    // Reward settings
+    g_RewardOnDefense = sConfigMgr->GetOption<bool>("CitySiege.RewardOnDefense", true);
+    g_RewardHonor = sConfigMgr->GetOption<uint32>("CitySiege.RewardHonor", 100);
+    g_RewardGoldBase = sConfigMgr->GetOption<uint32>("CitySiege.RewardGoldBase", 5000);
+    g_RewardGoldPerLevel = sConfigMgr->GetOption<uint32>("CitySiege.RewardGoldPerLevel", 5000);
+
+    // Contribution settings
+    g_ContributionEnabled = sConfigMgr->GetOption<bool>("CitySiege.Contribution.Enable", true);
+    g_ContributionDamagePerPoint = sConfigMgr->GetOption<uint32>("CitySiege.Contribution.DamagePerPoint", 1000);
+    g_ContributionHealingPerPoint = sConfigMgr->GetOption<uint32>("CitySiege.Contribution.HealingPerPoint", 1000);
+    g_ContributionPointsPerKill = sConfigMgr->GetOption<uint32>("CitySiege.Contribution.PointsPerKill", 10);
+    g_ContributionPointsPerMinute = sConfigMgr->GetOption<uint32>("CitySiege.Contribution.PointsPerMinute", 5);
+    g_ContributionExpectedPlayers = std::min(65536u, sConfigMgr->GetOption<uint32>("CitySiege.Contribution.ExpectedPlayers", 4096));
+    g_RewardMinContribution = sConfigMgr->GetOption<uint32>("CitySiege.Reward.MinContribution", 25);
+    g_RewardFullContribution = sConfigMgr->GetOption<uint32>("CitySiege.Reward.FullContribution", 1000);
+    g_RewardMinScalePct = std::min<uint32>(sConfigMgr->GetOption<uint32>("CitySiege.Reward.MinScalePct", 25), 100);
+    g_RewardBatchSize = std::max(1u, sConfigMgr->GetOption<uint32>("CitySiege.Reward.BatchSize", 10));
+
+    // Messages
+    g_MessageSiegeStart = sConfigMgr->GetOption<std::string>("CitySiege.Message.SiegeStart", 
+        "|cffff0000[City Siege]|r The city of {CITYNAME} is under attack! Defenders are needed!");
+    g_MessageSiegeEnd = sConfigMgr->GetOption<std::string>("CitySiege.Message.SiegeEnd", 
+        "|cff00ff00[City Siege]|r The siege of {CITYNAME} has ended!");
+    g_MessageReward = sConfigMgr->GetOption<std::string>("CitySiege.Message.Reward", 
+        "|cff00ff00[City Siege]|r You have been rewarded for {ACTION} {CITYNAME}!");
+    
+    // Yells
+    g_YellLeaderSpawn = sConfigMgr->GetOption<std::string>("CitySiege.Yell.LeaderSpawn", 
+        "This city will fall before our might!");
+    g_YellsCombat = sConfigMgr->GetOption<std::string>("CitySiege.Yell.Combat", 
+        "Your defenses crumble!;This city will burn!;Face your doom!;None can stand against us!;Your leaders will fall!");
+    
+    // RP Phase scripts (multiple scripts separated by |, lines within each script separated by ;)
+    g_RPScriptsAlliance = sConfigMgr->GetOption<std::string>("CitySiege.RP.Alliance", 
+        "Citizens of {CITY}, your time has come! We march under the banner of the Alliance!;{LEADER}, your people cry out for mercy, but you have shown none to ours!;We have crossed mountains and seas to bring justice to {CITY}. Surrender now, or face annihilation!;The Light guides our blades, and the might of Stormwind stands behind us. Your defenses will crumble!;This ends today! {LEADER}, come forth and face the Alliance, or watch {CITY} burn!|The Alliance has gathered its greatest heroes for this assault on {CITY}. You cannot stand against us!;{LEADER}, your leadership has made the Horde enemies it cannot defeat! We will tear down these walls!;Too long have you raided our villages and slaughtered our people. Today, we bring the war to {CITY}!;Your shamans' magic cannot protect you. Our priests and paladins have blessed this army!;Prepare to face the wrath of the Alliance! {LEADER}, your reign over {CITY} ends here and now!|By order of King Varian Wrynn, {CITY} is to be taken! Resistance is futile!;{LEADER}! Come forth and face us, or hide like a coward while your people suffer!;The Horde's reign of terror ends here at {CITY}. We will show no mercy to those who threaten peace!;Our siege engines are ready. The walls of {CITY} mean nothing to the might of the Alliance!;For every innocent killed by Horde aggression, {LEADER}, you will pay with your life!");
+    g_RPScriptsHorde = sConfigMgr->GetOption<std::string>("CitySiege.RP.Horde", 
+        "The Horde has come to claim {CITY}! Your precious Alliance ends today!;{LEADER}, you have oppressed our people for the last time! Come out and face your fate!;We are not savages - we are warriors! And today, we show {CITY} what true strength means!;Your guards are weak. Your walls are weak. {LEADER} hides in the throne room while we stand at the gates!;Blood and honor! Today we prove that the Horde is the superior force in Azeroth!|Citizens of {CITY}, flee while you can! We have come for your leaders, not for you!;{LEADER}! Your reign of tyranny over {CITY} ends today! The throne will belong to the Horde!;You call us monsters, but it is YOU who started this war! We finish it today at {CITY}!;The spirits of our ancestors guide us. No amount of Light magic will save {CITY} from our wrath!;Lok'tar Ogar! {LEADER}, today you fall, and the Horde claims {CITY}!|The Warchief has sent his finest warriors to end Alliance tyranny at {CITY} once and for all!;Your pitiful city guard cannot stop the Horde war machine! {LEADER}, your time has come!;We march for honor! We march for glory! We march to prove that the Horde will take {CITY}!;Every siege tower, every warrior, every drop of blood spilled today at {CITY} - it all leads to YOUR defeat!;{LEADER}, the Alliance has grown soft under your leadership. Today at {CITY}, the Horde reminds you why you should fear us!");
+
+    // Compile messages, yells and RP scripts once; rendering only appends segments
+    CompileSiegeTexts();
+
+#ifdef MOD_PLAYERBOTS
+    // Playerbot Integration
+    g_PlayerbotsEnabled = sConfigMgr->GetOption<bool>("CitySiege.Playerbots.Enabled", false);
+    g_PlayerbotsMinLevel = sConfigMgr->GetOption<uint32>("CitySiege.Playerbots.MinLevel", 70);
+    g_PlayerbotsMaxDefenders = sConfigMgr->GetOption<uint32>("CitySiege.Playerbots.MaxDefenders", 20);
+    g_PlayerbotsMaxAttackers = sConfigMgr->GetOption<uint32>("CitySiege.Playerbots.MaxAttackers", 20);
+    g_PlayerbotsRespawnDelay = sConfigMgr->GetOption<uint32>("CitySiege.Playerbots.RespawnDelay", 30);
+    g_PlayerbotsTeleportBatchSize = sConfigMgr->GetOption<uint32>("CitySiege.Playerbots.TeleportBatchSize", 5);
+#endif
+
+    // Weather settings
+    g_WeatherEnabled = sConfigMgr->GetOption<bool>("CitySiege.Weather.Enabled", true);
+    g_WeatherType = static_cast<WeatherState>(sConfigMgr->GetOption<uint32>("CitySiege.Weather.Type", WEATHER_STATE_MEDIUM_RAIN));
+    g_WeatherGrade = sConfigMgr->GetOption<float>("CitySiege.Weather.Grade", 0.8f);
+
+    // Music settings
+    g_MusicEnabled   = sConfigMgr->GetOption<bool>("CitySiege.Music.Enabled", true);
+    g_RPMusicId      = sConfigMgr->GetOption<uint32>("CitySiege.Music.RPMusicId", 11803);        // The Burning Legion
+    g_CombatMusicId  = sConfigMgr->GetOption<uint32>("CitySiege.Music.CombatMusicId", 11804); // Battle of Mount Hyjal
+    g_VictoryMusicId = sConfigMgr->GetOption<uint32>("CitySiege.Music.VictoryMusicId", 16039); // Invincible
+    g_DefeatMusicId  = sConfigMgr->GetOption<uint32>("CitySiege.Music.DefeatMusicId", 14127);   // Wrath of the Lich King
+
+    // Update scheduler settings
+    g_SchedulerTickBudget = sConfigMgr->GetOption<uint32>("CitySiege.Scheduler.TickBudget", 2000);
+    g_SchedulerMinUnitsPerSlice = std::max<uint32>(1, sConfigMgr->GetOption<uint32>("CitySiege.Scheduler.MinUnitsPerSlice", 8));
+    g_SchedulerMovementInterval = sConfigMgr->GetOption<uint32>("CitySiege.Scheduler.MovementInterval", 500);
+    g_SchedulerRespawnInterval = sConfigMgr->GetOption<uint32>("CitySiege.Scheduler.RespawnInterval", 1000);
+    g_SchedulerYellInterval = sConfigMgr->GetOption<uint32>("CitySiege.Scheduler.YellInterval", 1000);
+    g_SchedulerBroadcastInterval = sConfigMgr->GetOption<uint32>("CitySiege.Scheduler.BroadcastInterval", 30000);
+    g_SchedulerWinCheckInterval = sConfigMgr->GetOption<uint32>("CitySiege.Scheduler.WinCheckInterval", 1000);
+    g_SchedulerProximityInterval = sConfigMgr->GetOption<uint32>("CitySiege.Scheduler.ProximityInterval", 1000);
+    g_SchedulerParallelUpdate = sConfigMgr->GetOption<bool>("CitySiege.Scheduler.ParallelUpdate", false);
+
+    // Performance instrumentation settings
+    g_PerfEnabled = sConfigMgr->GetOption<bool>("CitySiege.Perf.Enable", false);
+    g_PerfLogInterval = sConfigMgr->GetOption<uint32>("CitySiege.Perf.LogInterval", 0);
+
+    // Route settings
+    g_RouteSampleStep = std::max(1.0f, sConfigMgr->GetOption<float>("CitySiege.Route.SampleStep", 8.0f));
+    g_RouteJitterSlots = std::max<uint32>(1, sConfigMgr->GetOption<uint32>("CitySiege.Route.JitterSlots", 8));
+    g_RouteJitterRadius = std::max(0.0f, sConfigMgr->GetOption<float>("CitySiege.Route.JitterRadius", 5.0f));
+
+    // Squad settings
+    g_SquadSize = std::max<uint32>(1, sConfigMgr->GetOption<uint32>("CitySiege.Squad.Size", 5));
+    g_SquadSpacing = std::max(1.0f, sConfigMgr->GetOption<float>("CitySiege.Squad.Spacing", 3.0f));
+
+    // Addon subscription settings
+    g_AddonSubscriptionTimeout = sConfigMgr->GetOption<uint32>("CitySiege.Addon.SubscriptionTimeout", 1800);
+    g_AddonFullRateRadius = sConfigMgr->GetOption<uint32>("CitySiege.Addon.FullRateRadius", 1000);
+    g_AddonSummaryInterval = sConfigMgr->GetOption<uint32>("CitySiege.Addon.SummaryInterval", 120000);
+
+    // Recovery settings
+    g_RecoveryEnabled = sConfigMgr->GetOption<bool>("CitySiege.Recovery.Enable", true);
+    g_RecoveryFile = sConfigMgr->GetOption<std::string>("CitySiege.Recovery.File", "city_siege_checkpoint.txt");
+    g_RecoveryResume = sConfigMgr->GetOption<bool>("CitySiege.Recovery.Resume", false);
+    g_RecoveryCheckpointInterval = std::max(1000u, sConfigMgr->GetOption<uint32>("CitySiege.Recovery.CheckpointInterval", 10000));
+
+    // Replay settings (apply to sieges started after a reload)
+    g_ReplayEnabled = sConfigMgr->GetOption<bool>("CitySiege.Replay.Enable", false);
+    g_ReplayDirectory = sConfigMgr->GetOption<std::string>("CitySiege.Replay.Directory", "city_siege_replays");
+    g_ReplayBufferSize = std::max(64u, sConfigMgr->GetOption<uint32>("CitySiege.Replay.BufferSize", 8192));
+    g_ReplayFlushInterval = std::max(1000u, sConfigMgr->GetOption<uint32>("CitySiege.Replay.FlushInterval", 5000));
+
+    // Load spawn locations for each city
+    g_Cities[CITY_STORMWIND].spawnX = sConfigMgr->GetOption<float>("CitySiege.Stormwind.SpawnX", -9161.16f);
+    g_Cities[CITY_STORMWIND].spawnY = sConfigMgr->GetOption<float>("CitySiege.Stormwind.SpawnY", 353.365f);
+    g_Cities[CITY_STORMWIND].spawnZ = sConfigMgr->GetOption<float>("CitySiege.Stormwind.SpawnZ", 88.117f);
+    
+    g_Cities[CITY_IRONFORGE].spawnX = sConfigMgr->GetOption<float>("CitySiege.Ironforge.SpawnX", -5174.09f);
+    g_Cities[CITY_IRONFORGE].spawnY = sConfigMgr->GetOption<float>("CitySiege.Ironforge.SpawnY", -594.361f);
+    g_Cities[CITY_IRONFORGE].spawnZ = sConfigMgr->GetOption<float>("CitySiege.Ironforge.SpawnZ", 397.853f);
+    
+    g_Cities[CITY_DARNASSUS].spawnX = sConfigMgr->GetOption<float>("CitySiege.Darnassus.SpawnX", 9887.36f);
+    g_Cities[CITY_DARNASSUS].spawnY = sConfigMgr->GetOption<float>("CitySiege.Darnassus.SpawnY", 1856.49f);
+    g_Cities[CITY_DARNASSUS].spawnZ = sConfigMgr->GetOption<float>("CitySiege.Darnassus.SpawnZ", 1317.14f);
+    
+    g_Cities[CITY_EXODAR].spawnX = sConfigMgr->GetOption<float>("CitySiege.Exodar.SpawnX", -4080.80f);
+    g_Cities[CITY_EXODAR].spawnY = sConfigMgr->GetOption<float>("CitySiege.Exodar.SpawnY", -12193.2f);
+    g_Cities[CITY_EXODAR].spawnZ = sConfigMgr->GetOption<float>("CitySiege.Exodar.SpawnZ", 1.712f);
+    
+    g_Cities[CITY_ORGRIMMAR].spawnX = sConfigMgr->GetOption<float>("CitySiege.Orgrimmar.SpawnX", 1114.96f);
+    g_Cities[CITY_ORGRIMMAR].spawnY = sConfigMgr->GetOption<float>("CitySiege.Orgrimmar.SpawnY", -4374.63f);
+    g_Cities[CITY_ORGRIMMAR].spawnZ = sConfigMgr->GetOption<float>("CitySiege.Orgrimmar.SpawnZ", 25.813f);
+    
+    g_Cities[CITY_UNDERCITY].spawnX = sConfigMgr->GetOption<float>("CitySiege.Undercity.SpawnX", 1982.26f);
+    g_Cities[CITY_UNDERCITY].spawnY = sConfigMgr->GetOption<float>("CitySiege.Undercity.SpawnY", 226.674f);
+    g_Cities[CITY_UNDERCITY].spawnZ = sConfigMgr->GetOption<float>("CitySiege.Undercity.SpawnZ", 35.951f);
+    
+    g_Cities[CITY_THUNDERBLUFF].spawnX = sConfigMgr->GetOption<float>("CitySiege.ThunderBluff.SpawnX", -1558.61f);
+    g_Cities[CITY_THUNDERBLUFF].spawnY = sConfigMgr->GetOption<float>("CitySiege.ThunderBluff.SpawnY", -5.071f);
+    g_Cities[CITY_THUNDERBLUFF].spawnZ = sConfigMgr->GetOption<float>("CitySiege.ThunderBluff.SpawnZ", 5.384f);
+    
+    g_Cities[CITY_SILVERMOON].spawnX = sConfigMgr->GetOption<float>("CitySiege.Silvermoon.SpawnX", 9230.47f);
+    g_Cities[CITY_SILVERMOON].spawnY = sConfigMgr->GetOption<float>("CitySiege.Silvermoon.SpawnY", -6962.67f);
+    g_Cities[CITY_SILVERMOON].spawnZ = sConfigMgr->GetOption<float>("CitySiege.Silvermoon.SpawnZ", 5.004f);
+
+    // Load leader locations for each city
+    g_Cities[CITY_STORMWIND].leaderX = sConfigMgr->GetOption<float>("CitySiege.Stormwind.LeaderX", -8442.578f);
+    g_Cities[CITY_STORMWIND].leaderY = sConfigMgr->GetOption<float>("CitySiege.Stormwind.LeaderY", 334.6064f);
+    g_Cities[CITY_STORMWIND].leaderZ = sConfigMgr->GetOption<float>("CitySiege.Stormwind.LeaderZ", 122.476685f);
+    
+    g_Cities[CITY_IRONFORGE].leaderX = sConfigMgr->GetOption<float>("CitySiege.Ironforge.LeaderX", -4981.25f);
+    g_Cities[CITY_IRONFORGE].leaderY = sConfigMgr->GetOption<float>("CitySiege.Ironforge.LeaderY", -881.542f);
+    g_Cities[CITY_IRONFORGE].leaderZ = sConfigMgr->GetOption<float>("CitySiege.Ironforge.LeaderZ", 501.660f);
+    
+    g_Cities[CITY_DARNASSUS].leaderX = sConfigMgr->GetOption<float>("CitySiege.Darnassus.LeaderX", 9947.52f);
+    g_Cities[CITY_DARNASSUS].leaderY = sConfigMgr->GetOption<float>("CitySiege.Darnassus.LeaderY", 2482.73f);
+    g_Cities[CITY_DARNASSUS].leaderZ = sConfigMgr->GetOption<float>("CitySiege.Darnassus.LeaderZ", 1316.21f);
+    
+    g_Cities[CITY_EXODAR].leaderX = sConfigMgr->GetOption<float>("CitySiege.Exodar.LeaderX", -3864.92f);
+    g_Cities[CITY_EXODAR].leaderY = sConfigMgr->GetOption<float>("CitySiege.Exodar.LeaderY", -11643.7f);
+    g_Cities[CITY_EXODAR].leaderZ = sConfigMgr->GetOption<float>("CitySiege.Exodar.LeaderZ", -137.644f);
+    
+    g_Cities[CITY_ORGRIMMAR].leaderX = sConfigMgr->GetOption<float>("CitySiege.Orgrimmar.LeaderX", 1633.75f);
+    g_Cities[CITY_ORGRIMMAR].leaderY = sConfigMgr->GetOption<float>("CitySiege.Orgrimmar.LeaderY", -4439.39f);
+    g_Cities[CITY_ORGRIMMAR].leaderZ = sConfigMgr->GetOption<float>("CitySiege.Orgrimmar.LeaderZ", 15.4396f);
+    
+    g_Cities[CITY_UNDERCITY].leaderX = sConfigMgr->GetOption<float>("CitySiege.Undercity.LeaderX", 1633.75f);
+    g_Cities[CITY_UNDERCITY].leaderY = sConfigMgr->GetOption<float>("CitySiege.Undercity.LeaderY", 240.167f);
+    g_Cities[CITY_UNDERCITY].leaderZ = sConfigMgr->GetOption<float>("CitySiege.Undercity.LeaderZ", -43.1034f);
+    
+    g_Cities[CITY_THUNDERBLUFF].leaderX = sConfigMgr->GetOption<float>("CitySiege.ThunderBluff.LeaderX", -1043.11f);
+    g_Cities[CITY_THUNDERBLUFF].leaderY = sConfigMgr->GetOption<float>("CitySiege.ThunderBluff.LeaderY", 285.809f);
+    g_Cities[CITY_THUNDERBLUFF].leaderZ = sConfigMgr->GetOption<float>("CitySiege.ThunderBluff.LeaderZ", 135.165f);
+    
+    g_Cities[CITY_SILVERMOON].leaderX = sConfigMgr->GetOption<float>("CitySiege.Silvermoon.LeaderX", 9338.74f);
+    g_Cities[CITY_SILVERMOON].leaderY = sConfigMgr->GetOption<float>("CitySiege.Silvermoon.LeaderY", -7277.27f);
+    g_Cities[CITY_SILVERMOON].leaderZ = sConfigMgr->GetOption<float>("CitySiege.Silvermoon.LeaderZ", 13.7014f);
+
+    // Load waypoints for each city
+    for (auto& city : g_Cities)
+    {
+        city.waypoints.clear();
+        
+        // Get waypoint count for this city
+        std::string waypointCountKey = "CitySiege." + city.name + ".WaypointCount";
+        uint32 waypointCount = sConfigMgr->GetOption<uint32>(waypointCountKey, 0);
+        
+        if (g_DebugMode)
+        {
+            LOG_INFO("server.loading", "[City Siege] Loading {} waypoints for {}", waypointCount, city.name);
+        }
+        
+        // Load each waypoint
+        for (uint32 i = 0; i < waypointCount; ++i)
+        {
+            std::string baseKey = "CitySiege." + city.name + ".Waypoint" + std::to_string(i + 1);
+            Waypoint wp;
+            wp.x = sConfigMgr->GetOption<float>(baseKey + ".X", 0.0f);
+            wp.y = sConfigMgr->GetOption<float>(baseKey + ".Y", 0.0f);
+            wp.z = sConfigMgr->GetOption<float>(baseKey + ".Z", 0.0f);
+            
+            // Only add waypoint if coordinates are valid
+            if (wp.x != 0.0f || wp.y != 0.0f || wp.z != 0.0f)
+            {
+                city.waypoints.push_back(wp);
+                
+                if (g_DebugMode)
+                {
+                    LOG_INFO("server.loading", "[City Siege]   Waypoint {}: ({}, {}, {})", 
+                             i + 1, wp.x, wp.y, wp.z);
+                }
+            }
+        }
+    }
+
+    // Waypoints may have changed; routes are recompiled on the next siege of each city.
+    // A running siege keeps its route: recompiling it mid-siege would happen on a map thread, possibly without navmesh.
+    for (uint32 cityId = 0; cityId < CITY_MAX; ++cityId)
+    {
+        if (!IsCityUnderSiege(CityId(cityId)))
+            g_SiegeRoutes[cityId].reset();
+    }
+
+    // Spawn counts may have changed; formations are rebuilt on the next siege of each city
+    for (auto& formation : g_SiegeFormations)
+        formation.reset();
+
+    ResolveSiegeUnitProfiles();
+
+    if (g_DebugMode)
+    {
+        LOG_INFO("server.loading", "[City Siege] Configuration loaded:");
+        LOG_INFO("server.loading", "[City Siege]   Enabled: {}", g_CitySiegeEnabled);
+        LOG_INFO("server.loading", "[City Siege]   Timer: {}-{} minutes", g_TimerMin / 60, g_TimerMax / 60);
+        LOG_INFO("server.loading", "[City Siege]   Event Duration: {} minutes", g_EventDuration / 60);
+    }
+}
+
+/**
+ * @brief Checks whether a city has a siege that is running or still tearing down.
+ * A city only ever has one such siege: participants, the bot travel pool and the addon protocol are keyed by city.
+ */
+bool IsCityUnderSiege(CityId cityId)
+{
+    for (const auto& siege : g_ActiveSieges)
+    {
+        if (siege.cityId == cityId && (siege.isActive || siege.teardownStage != SIEGE_TEARDOWN_DONE))
+            return true;
+    }
+
+    return false;
+}
+
+/**
+ * @brief Selects a random city for siege event.
+ * @return Pointer to the selected CityData, or nullptr if no cities are available.
+ */
+CityData* SelectRandomCity()
+{
+    std::vector<CityData*> availableCities;
+
+    for (auto& city : g_Cities)
+    {
+        // With CitySiege.AllowMultipleCities other cities may be under siege, never this one twice
+        if (g_CityEnabled[city.name] && !IsCityUnderSiege(city.id))
+        {
+            availableCities.push_back(&city);
+        }
+    }
+
+    if (availableCities.empty())
+    {
+        return nullptr;
+    }
+
+    uint32 randomIndex = urand(0, availableCities.size() - 1);
+    return availableCities[randomIndex];
+}
+
+/**
+ * @brief Announces a siege event to players.
+ * @param city The city being sieged.
+ * @param isStart True if siege is starting, false if ending.
+ */
+void AnnounceSiege(const CityData& city, bool isStart)
+{
+    SiegeTextArgs args;
+    args.city = city.name;
+
+    std::string const& message = RenderSiegeText(isStart ? g_TextSiegeStart : g_TextSiegeEnd, args);
+    SendSiegeScopedMessage(city, message);
+
+    if (g_DebugMode)
+    {
+        LOG_INFO("server.loading", "[City Siege] {}", message);
+    }
+}
+
+// -----------------------------------------------------------------------------
+// ADDON PROTOCOL
+// -----------------------------------------------------------------------------
+
+// How much of a siege's traffic a subscriber receives
+enum CitySiegeAddonTier : uint8
+{
+    ADDON_TIER_NONE = 0,    // Filtered out by the subscriber's city/distance filter
+    ADDON_TIER_SUMMARY,     // Phase, counts and leader health on the summary cadence
+    ADDON_TIER_FULL         // Every UPDATE, including unit positions
+};
+
+/**
+ * @brief An addon client's interest in siege broadcasts, registered by .citysiege sync.
+ */
+struct AddonSubscription
+{
+    uint32 protocol = ADDON_PROTOCOL_TEXT;  // Negotiated through .citysiege proto
+    uint32 cityFilter = CITY_MAX;           // CITY_MAX = every city
+    float maxDistance = 0.0f;               // Yards from the city center, 0 = unlimited
+    uint32 lastRefresh = 0;                 // Time of the last sync
+};
+
+// Addon subscribers; only these players receive siege broadcasts
+static std::unordered_map<ObjectGuid, AddonSubscription> g_AddonSubscriptions;
+
+/**
+ * @brief Registers or refreshes a player's addon subscription.
+ * @return The subscription, so callers can adjust its filters.
+ */
+AddonSubscription& SubscribeAddonClient(Player* player)
+{
+    AddonSubscription& subscription = g_AddonSubscriptions[player->GetGUID()];
+    subscription.lastRefresh = time(nullptr);
+    return subscription;
+}
+
+void UnsubscribeAddonClient(ObjectGuid const& guid)
+{
+    g_AddonSubscriptions.erase(guid);
+}
+
+uint32 GetAddonProtocolVersion(Player* player)
+{
+    auto itr = g_AddonSubscriptions.find(player->GetGUID());
+    return itr != g_AddonSubscriptions.end() ? itr->second.protocol : ADDON_PROTOCOL_TEXT;
+}
+
+/**
+ * @brief Decides how much of a siege's traffic a subscriber receives.
+ * @param player The subscribed player.
+ * @param subscription The player's subscription.
+ * @param cityId The besieged city.
+ */
+CitySiegeAddonTier GetAddonSubscriberTier(Player* player, AddonSubscription const& subscription, CityId cityId)
+{
+    if (subscription.cityFilter < CITY_MAX && subscription.cityFilter != static_cast<uint32>(cityId))
+        return ADDON_TIER_NONE;
+
+    const CityData& city = g_Cities[cityId];
+    bool const onCityMap = player->GetMapId() == city.mapId;
+    float const distance = onCityMap ? player->GetDistance(city.centerX, city.centerY, city.centerZ) : 0.0f;
+
+    if (subscription.maxDistance > 0.0f && (!onCityMap || distance > subscription.maxDistance))
+        return ADDON_TIER_NONE;
+
+    if (!g_AddonFullRateRadius || (onCityMap && distance <= g_AddonFullRateRadius))
+        return ADDON_TIER_FULL;
+
+    return ADDON_TIER_SUMMARY;
+}
+
+/**
+ * @brief Collects the live state reported by UPDATE messages.
+ * @param event The siege event.
+ * @param map The city's map.
+ */
+SiegeAddonSnapshot CollectSiegeAddonSnapshot(const SiegeEvent& event, Map* map)
+{
+    SiegeAddonSnapshot snapshot;
+
+    if (event.cityLeaderGuid)
+    {
+        if (Creature* leader = map->GetCreature(event.cityLeaderGuid))
+        {
+            if (leader->IsAlive())
+                snapshot.leaderHealthPct = leader->GetHealthPct();
+        }
+    }
+
+    uint32 const now = time(nullptr);
+    snapshot.attackerCount = event.spawnedCreatures.size();
+    snapshot.defenderCount = event.spawnedDefenders.size();
+    snapshot.elapsed = now - event.startTime;
+    snapshot.remaining = event.endTime > now ? event.endTime - now : 0;
+
+    if (!event.cinematicPhase)
+    {
+        uint32 duration = event.endTime - event.startTime;
+        if (snapshot.elapsed > duration * 0.75f)
+            snapshot.phase = 4;
+        else if (snapshot.elapsed > duration * 0.5f)
+            snapshot.phase = 3;
+        else if (snapshot.elapsed > duration * 0.25f)
+            snapshot.phase = 2;
+    }
+
+    auto collectCreaturePositions = [&](SiegeNetSection section, std::vector<ObjectGuid> const& guids)
+    {
+        std::vector<std::array<float, 3>>& positions = snapshot.positions[section];
+        positions.reserve(guids.size());
+
+        for (ObjectGuid const& guid : guids)
+        {
+            if (Creature* creature = map->GetCreature(guid))
+            {
+                if (!creature->IsAlive())
+                    continue;
+
+                positions.push_back({
+                    creature->GetPositionX(),
+                    creature->GetPositionY(),
+                    creature->GetPositionZ()
+                });
+            }
+        }
+    };
+
+    auto collectBotPositions = [&](SiegeNetSection section, std::vector<ObjectGuid> const& guids)
+    {
+        std::vector<std::array<float, 3>>& positions = snapshot.positions[section];
+        positions.reserve(guids.size());
+
+        for (ObjectGuid const& guid : guids)
+        {
+            if (Player* bot = ObjectAccessor::FindPlayer(guid))
+            {
+                if (!bot->IsInWorld() || !bot->IsAlive())
+                    continue;
+
+                positions.push_back({
+                    bot->GetPositionX(),
+                    bot->GetPositionY(),
+                    bot->GetPositionZ()
+                });
+            }
+        }
+    };
+
+    collectCreaturePositions(SIEGE_NET_ATTACKERS, event.spawnedCreatures);
+    collectCreaturePositions(SIEGE_NET_DEFENDERS, event.spawnedDefenders);
+    collectBotPositions(SIEGE_NET_ATTACKER_BOTS, event.attackerBots);
+    collectBotPositions(SIEGE_NET_DEFENDER_BOTS, event.defenderBots);
+
+    return snapshot;
+}
+
+/**
+ * @brief Formats a START message.
+ * @param event The siege event.
+ * @param withWaypoints Append the static waypoint list (compact protocol clients).
+ */
+std::string FormatSiegeStartMessage(const SiegeEvent& event, bool withWaypoints)
+{
+    const CityData& city = g_Cities[event.cityId];
+    std::string attackingFaction = IsAllianceCity(event.cityId) ? "Horde" : "Alliance";
+
+    std::ostringstream ss;
+    ss << "START:" << static_cast<uint32>(event.cityId) << ":" << attackingFaction
+       << ":" << std::fixed << std::setprecision(2)
+       << city.spawnX << ":" << city.spawnY << ":" << city.spawnZ
+       << ":" << city.leaderX << ":" << city.leaderY << ":" << city.leaderZ
+       << ":" << city.centerX << ":" << city.centerY << ":" << city.centerZ;
+
+    // Compact clients get the static waypoint list once per siege instead of in every UPDATE
+    if (withWaypoints)
+    {
+        ss << ":WP:" << city.waypoints.size();
+        for (const auto& wp : city.waypoints)
+            ss << ":" << wp.x << ":" << wp.y << ":" << wp.z;
+    }
+
+    return ss.str();
+}
+
+std::string FormatSiegeEndMessage(const SiegeEvent& event, const std::string& winner)
+{
+    return "END:" + std::to_string(static_cast<uint32>(event.cityId)) + ":" + winner;
+}
+
+struct AddonRecipient
+{
+    Player* player;
+    AddonSubscription const* subscription;
+};
+
+/**
+ * @brief Collects the in-world addon subscribers and drops subscriptions that timed out.
+ * Only the subscription registry is walked; the global player lock is taken per lookup, never while
+ * messages are serialized or sent. The pointers are only valid until the world thread processes sessions again.
+ */
+std::vector<AddonRecipient> CollectAddonRecipients()
+{
+    std::vector<AddonRecipient> recipients;
+    recipients.reserve(g_AddonSubscriptions.size());
+
+    uint32 const currentTime = time(nullptr);
+    for (auto itr = g_AddonSubscriptions.begin(); itr != g_AddonSubscriptions.end();)
+    {
+        if (g_AddonSubscriptionTimeout && currentTime - itr->second.lastRefresh > g_AddonSubscriptionTimeout)
+        {
+            if (g_DebugMode)
+            {
+                LOG_INFO("server.loading", "[City Siege] Addon subscription of {} timed out", itr->first.ToString());
+            }
+
+            itr = g_AddonSubscriptions.erase(itr);
+            continue;
+        }
+
+        // Players that are loading or teleporting keep their subscription until logout or timeout
+        Player* player = ObjectAccessor::FindPlayer(itr->first);
+        if (player && player->IsInWorld())
+            recipients.push_back({ player, &itr->second });
+
+        ++itr;
+    }
+
+    return recipients;
+}
+
+/**
+ * @brief Sends siege data to a specific player's addon, in the protocol version the player negotiated.
+ * @param player The target player.
+ * @param event The siege event to serialize.
+ * @param messageType Type of message (START, UPDATE, END).
+ * @param winner Winner identifier for END messages.
+ */
+void SendSiegeDataToPlayer(Player* player, SiegeEvent& event,
+    const std::string& messageType, const std::string& winner = "unknown")
+{
+    if (!player)
+        return;
+
+    const CityData& city = g_Cities[event.cityId];
+    Map* map = sMapMgr->FindMap(city.mapId, 0);
+    if (!map)
+        return;
+
+    bool const compact = GetAddonProtocolVersion(player) >= ADDON_PROTOCOL_COMPACT;
+
+    if (messageType == "START")
+    {
+        SendAddonMessageToPlayer(player, FormatSiegeStartMessage(event, compact));
+    }
+    else if (messageType == "UPDATE")
+    {
+        SiegeAddonSnapshot snapshot = CollectSiegeAddonSnapshot(event, map);
+        CityData const& city = g_Cities[event.cityId];
+        SendAddonMessageToPlayer(player, compact ? EncodeSiegeUpdateKeyframe(city, event.addonBaseline, snapshot)
+            : FormatSiegeUpdateText(city, snapshot));
+    }
+    else if (messageType == "END")
+    {
+        SendAddonMessageToPlayer(player, FormatSiegeEndMessage(event, winner));
+    }
+}
+
+/**
+ * @brief Broadcasts siege data to clients via addon messages
+ * @param event The siege event to broadcast
+ * @param messageType Type of message (START, UPDATE, END, POSITION)
+ */
+void BroadcastSiegeDataToAddon(SiegeEvent& event, const std::string& messageType,
+    const std::string& winner, bool includeSummaryTier)
+{
+    SiegePerfTimer perfTimer(SIEGE_PERF_BROADCAST, &event.perf);
+
+    // Serialize once per protocol version and tier, then hand the same packet to every recipient
+    std::string textMessage;
+    std::string compactMessage;
+    std::string summaryTextMessage;
+    std::string summaryCompactMessage;
+    bool const isUpdate = messageType == "UPDATE";
+
+    if (messageType == "START")
+    {
+        textMessage = FormatSiegeStartMessage(event, false);
+        compactMessage = FormatSiegeStartMessage(event, true);
+    }
+    else if (isUpdate)
+    {
+        Map* map = sMapMgr->FindMap(g_Cities[event.cityId].mapId, 0);
+        if (!map)
+            return;
+
+        SiegeAddonSnapshot snapshot = CollectSiegeAddonSnapshot(event, map);
+        SiegeUpdateMessages messages = SerializeSiegeUpdate(g_Cities[event.cityId], event.addonBaseline, snapshot, includeSummaryTier);
+        textMessage = std::move(messages.text);
+        compactMessage = std::move(messages.compact);
+        summaryTextMessage = std::move(messages.summaryText);
+        summaryCompactMessage = std::move(messages.summaryCompact);
+    }
+    else if (messageType == "END")
+    {
+        textMessage = FormatSiegeEndMessage(event, winner);
+        compactMessage = textMessage;
+    }
+    else
+    {
+        return;
+    }
+
+    std::vector<AddonRecipient> const recipients = CollectAddonRecipients();
+    if (recipients.empty())
+        return;
+
+    perfTimer.AddItems(recipients.size());
+
+    WorldPacket const textPacket = BuildAddonMessagePacket(textMessage);
+    WorldPacket const compactPacket = BuildAddonMessagePacket(compactMessage);
+    WorldPacket const summaryTextPacket = BuildAddonMessagePacket(summaryTextMessage);
+    WorldPacket const summaryCompactPacket = BuildAddonMessagePacket(summaryCompactMessage);
+
+    uint32 sent = 0;
+    for (AddonRecipient const& recipient : recipients)
+    {
+        CitySiegeAddonTier tier = GetAddonSubscriberTier(recipient.player, *recipient.subscription, event.cityId);
+
+        // START and END are cheap and bracket the siege, so only the city filter applies to them
+        if (!isUpdate)
+        {
+            if (recipient.subscription->cityFilter < CITY_MAX && recipient.subscription->cityFilter != static_cast<uint32>(event.cityId))
+                continue;
+            tier = ADDON_TIER_FULL;
+        }
+
+        if (tier == ADDON_TIER_NONE || (tier == ADDON_TIER_SUMMARY && !includeSummaryTier))
+            continue;
+
+        bool const compact = recipient.subscription->protocol >= ADDON_PROTOCOL_COMPACT;
+        if (tier == ADDON_TIER_SUMMARY)
+            recipient.player->GetSession()->SendPacket(compact ? &summaryCompactPacket : &summaryTextPacket);
+        else
+            recipient.player->GetSession()->SendPacket(compact ? &compactPacket : &textPacket);
+        ++sent;
+    }
+
+    CitySiegeReplay::BroadcastKind const kind = isUpdate ? CitySiegeReplay::BroadcastKind::Update :
+        messageType == "START" ? CitySiegeReplay::BroadcastKind::Start : CitySiegeReplay::BroadcastKind::End;
+    RecordSiegeReplay(event, CitySiegeReplay::EventType::Broadcast, CitySiegeAPI::SiegeParticipantRole::None,
+        static_cast<uint16>(kind), sent, textMessage.size());
+}
+
+/**
+ * @brief Sends map data (waypoints and leader position) to a player's addon
+ * @param player The player to send data to
+ * @param cityId The city ID
+ */
+void SendMapDataToPlayer(Player* player, CityId cityId)
+{
+    if (!player || cityId >= CITY_MAX)
+        return;
+        
+    const CityData& city = g_Cities[cityId];
+    Map* map = sMapMgr->FindMap(city.mapId, 0);
+    if (!map)
+        return;
+    
+    std::ostringstream ss;
+    
+    // Format: MAP_DATA:cityID:WP:count:x:y:z...:LEADER:x:y:z
+    ss << "MAP_DATA:" << static_cast<uint32>(cityId);
+    
+    // Add waypoint data
+    ss << ":WP:" << city.waypoints.size();
+    for (const auto& wp : city.waypoints)
+    {
+        ss << ":" << std::fixed << std::setprecision(2) << wp.x << ":" << wp.y << ":" << wp.z;
+    }
+    
+    // Add leader position
+    ss << ":LEADER:" << std::fixed << std::setprecision(2) 
+       << city.leaderX << ":" << city.leaderY << ":" << city.leaderZ;
+    
+    SendAddonMessageToPlayer(player, ss.str());
+}
+
+/**
+ * @brief Broadcasts position updates for siege participants
+ * @param event The siege event
+ * @param guid The GUID of the unit
+ * @param x X coordinate
+ * @param y Y coordinate  
+ * @param z Z coordinate
+ * @param unitType Type of unit (ATTACKER, DEFENDER, NPC)
+ */
+void BroadcastPositionUpdate(const SiegeEvent& event, ObjectGuid guid, float x, float y, float z, const std::string& unitType)
+{
+    const CityData& city = g_Cities[event.cityId];
+    Map* map = sMapMgr->FindMap(city.mapId, 0);
+    if (!map)
+        return;
+        
+    std::ostringstream ss;
+    ss << "POS:" << static_cast<uint32>(event.cityId) << ":" 
+       << guid.GetRawValue() << ":" 
+       << std::fixed << std::setprecision(2) << x << ":" << y << ":" << z 
+       << ":" << unitType;
+       
+    std::string message = ss.str();
+    std::string addonMessage = "CITYSIEGE_" + message;
+    
+    // Positions are full-rate traffic: only subscribers near the city receive them
+    for (AddonRecipient const& recipient : CollectAddonRecipients())
+    {
+        if (GetAddonSubscriberTier(recipient.player, *recipient.subscription, event.cityId) == ADDON_TIER_FULL)
+            ChatHandler(recipient.player->GetSession()).PSendSysMessage(addonMessage.c_str());
+    }
+}
+
+// ---------------------------------------------------------------------------
+// SYNTHETIC BENCHMARK
+// ---------------------------------------------------------------------------
+
+// The map work (movement, respawns, player refresh) is benchmarked offline by tools/siege_benchmark.cpp;
+// this in-process run only covers the addon UPDATE serialization and fan-out, which needs the module's sessions code.
+constexpr uint32 SIEGE_BENCH_TICK_MS = 50;       // Simulated world update interval
+constexpr float SIEGE_BENCH_JITTER = 8.0f;       // Yards a unit wanders around its stop between broadcasts
+
+/**
+ * @brief Sizes of a synthetic benchmark run (.citysiege bench).
+ */
+struct SiegeBenchOptions
+{
+    uint32 sieges = 1;
+    uint32 attackers = 100;
+    uint32 defenders = 40;
+    uint32 bots = 20;     // Split evenly between both sides
+    uint32 players = 50;  // Addon subscribers, spread around the city center
+    uint32 ticks = 1200;  // 1 minute of simulated siege
+};
+
+struct SiegeBenchResult
+{
+    uint64 elapsedNs = 0;
+    uint64 broadcasts = 0;
+    uint64 packets = 0;
+    uint64 bytes = 0;
+};
+
+/**
+ * @brief Stand-in for a creature or bot: stays around one of the city's stops.
+ */
+struct SiegeBenchUnit
+{
+    SiegeNetSection section;
+    uint32 stop;    // Index of the stop the unit is reported around
+};
+
+/**
+ * @brief Stand-in for an addon subscriber.
+ */
+struct SiegeBenchPlayer
+{
+    float distance; // Yards from the city center
+    bool compact;   // Negotiated the compact protocol
+};
+
+/**
+ * @brief One simulated siege: a real SiegeEvent for the scheduler and delta baseline, plus synthetic units.
+ */
+struct SiegeBenchSiege
+{
+    SiegeEvent event;
+    std::vector<std::array<float, 3>> stops; // Spawn, waypoints, leader
+    std::vector<SiegeBenchUnit> units;
+    std::vector<SiegeBenchPlayer> players;
+};
+
+/**
+ * @brief Builds a simulated siege for a city with the requested unit and subscriber counts.
+ */
+void SetupSiegeBench(SiegeBenchSiege& bench, CityId cityId, SiegeBenchOptions const& options, uint32 now)
+{
+    const CityData& city = g_Cities[cityId];
+
+    bench.event.cityId = cityId;
+    bench.event.isActive = true;
+    bench.event.cinematicPhase = false;
+    bench.event.startTime = now;
+    bench.event.endTime = now + g_EventDuration;
+    bench.event.scheduler.Reset();
+    bench.event.scheduler.elapsed[SIEGE_SUBSYSTEM_BROADCAST] = g_SchedulerBroadcastInterval;
+    bench.event.scheduler.elapsed[SIEGE_SUBSYSTEM_SUMMARY] = g_AddonSummaryInterval;
+
+    bench.stops.push_back({ city.spawnX, city.spawnY, city.spawnZ });
+    for (Waypoint const& wp : city.waypoints)
+        bench.stops.push_back({ wp.x, wp.y, wp.z });
+    bench.stops.push_back({ city.leaderX, city.leaderY, city.leaderZ });
+
+    // Units spread over the whole route, so the positions cover the same area as a running siege
+    auto addUnits = [&](SiegeNetSection section, uint32 count)
+    {
+        for (uint32 i = 0; i < count; ++i)
+            bench.units.push_back({ section, i % uint32(bench.stops.size()) });
+    };
+
+    addUnits(SIEGE_NET_ATTACKERS, options.attackers);
+    addUnits(SIEGE_NET_DEFENDERS, options.defenders);
+    addUnits(SIEGE_NET_ATTACKER_BOTS, options.bots - options.bots / 2);
+    addUnits(SIEGE_NET_DEFENDER_BOTS, options.bots / 2);
+
+    // Subscribers out to three times the full-rate radius, so both tiers are exercised
+    float const spread = 3.0f * std::max<uint32>(g_AddonFullRateRadius, 1);
+    for (uint32 i = 0; i < options.players; ++i)
+        bench.players.push_back({ frand(0.0f, spread), i % 2 == 0 });
+}
+
+/**
+ * @brief Runs simulated siege ticks: scheduler and UPDATE serialization and fan-out, with units
+ * and subscribers replaced by in-memory stand-ins.
+ * @param options Sizes of the run.
+ * @return Wall time and addon traffic of the run.
+ */
+SiegeBenchResult RunSiegeBenchmark(SiegeBenchOptions const& options)
+{
+    SiegeBenchResult result;
+    uint32 const now = time(nullptr);
+
+    std::vector<SiegeBenchSiege> sieges(options.sieges);
+    for (uint32 i = 0; i < options.sieges; ++i)
+        SetupSiegeBench(sieges[i], CityId(i % CITY_MAX), options, now);
+
+    auto const start = std::chrono::steady_clock::now();
+
+    for (uint32 tick = 0; tick < options.ticks; ++tick)
+    {
+        for (SiegeBenchSiege& bench : sieges)
+        {
+            SiegeEvent& event = bench.event;
+            event.scheduler.Advance(SIEGE_BENCH_TICK_MS);
+
+            if (!event.scheduler.ConsumeIfDue(SIEGE_SUBSYSTEM_BROADCAST, g_SchedulerBroadcastInterval))
+                continue;
+
+            bool const summaryDue = event.scheduler.ConsumeIfDue(SIEGE_SUBSYSTEM_SUMMARY, g_AddonSummaryInterval);
+
+            SiegeAddonSnapshot snapshot;
+            snapshot.attackerCount = options.attackers;
+            snapshot.defenderCount = options.defenders;
+            snapshot.elapsed = tick * SIEGE_BENCH_TICK_MS / 1000;
+            snapshot.remaining = g_EventDuration > snapshot.elapsed ? g_EventDuration - snapshot.elapsed : 0;
+            snapshot.leaderHealthPct = 100.0f;
+            for (SiegeBenchUnit const& unit : bench.units)
+            {
+                std::array<float, 3> position = bench.stops[unit.stop];
+                position[0] += frand(-SIEGE_BENCH_JITTER, SIEGE_BENCH_JITTER);
+                position[1] += frand(-SIEGE_BENCH_JITTER, SIEGE_BENCH_JITTER);
+                snapshot.positions[unit.section].push_back(position);
+            }
+
+            SiegeUpdateMessages const messages = SerializeSiegeUpdate(g_Cities[event.cityId], event.addonBaseline, snapshot, summaryDue);
+            size_t const textSize = BuildAddonMessagePacket(messages.text).size();
+            size_t const compactSize = BuildAddonMessagePacket(messages.compact).size();
+            size_t const summaryTextSize = summaryDue ? BuildAddonMessagePacket(messages.summaryText).size() : 0;
+            size_t const summaryCompactSize = summaryDue ? BuildAddonMessagePacket(messages.summaryCompact).size() : 0;
+            ++result.broadcasts;
+
+            for (SiegeBenchPlayer const& player : bench.players)
+            {
+                bool const fullRate = !g_AddonFullRateRadius || player.distance <= g_AddonFullRateRadius;
+                if (!fullRate && !summaryDue)
+                    continue;
+
+                if (fullRate)
+                    result.bytes += player.compact ? compactSize : textSize;
+                else
+                    result.bytes += player.compact ? summaryCompactSize : summaryTextSize;
+                ++result.packets;
+            }
+        }
+    }
+
+    result.elapsedNs = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count();
+    return result;
+}
+
+// ---------------------------------------------------------------------------
+// SPAWN PIPELINE
+// ---------------------------------------------------------------------------
+
+/**
+ * @brief Computes a city's army formation with ground heights sampled once.
+ * Military formation - organized ranks like a real army assault: leaders at the center, mini-bosses forming
+ * a command circle, elites in the mid-rank, minions on the outer perimeter and defenders around the city leader.
+ * @param city The city to build the formation for.
+ * @param map The city's map, used for the ground height queries.
+ */
+std::shared_ptr<SiegeFormation const> BuildSiegeFormation(CityData const& city, Map* map)
+{
+    auto formation = std::make_shared<SiegeFormation>();
+
+    auto addRing = [&](SiegeUnitTier tier, uint32 count, float centerX, float centerY, float centerZ, float radius, float probeHeight)
+    {
+        float const angleStep = (2 * M_PI) / std::max(1u, count);
+        for (uint32 i = 0; i < count; ++i)
+        {
+            float const angle = angleStep * i;
+            SiegeSpawnSlot slot{ tier, centerX + radius * std::cos(angle), centerY + radius * std::sin(angle), centerZ };
+
+            float const groundZ = map->GetHeight(slot.x, slot.y, slot.z + probeHeight, true, 50.0f);
+            if (groundZ > INVALID_HEIGHT)
+                slot.z = groundZ + 0.5f;
+
+            formation->slots.push_back(slot);
+        }
+    };
+
+    float const baseRadius = 35.0f;
+    addRing(SIEGE_TIER_LEADER, g_SpawnCountLeaders, city.spawnX, city.spawnY, city.spawnZ, 3.0f, 50.0f);
+    addRing(SIEGE_TIER_MINIBOSS, g_SpawnCountMiniBosses, city.spawnX, city.spawnY, city.spawnZ, baseRadius * 0.3f, 50.0f); // ~10.5 yards
+    addRing(SIEGE_TIER_ELITE, g_SpawnCountElites, city.spawnX, city.spawnY, city.spawnZ, baseRadius * 0.6f, 50.0f);       // ~21 yards
+    addRing(SIEGE_TIER_MINION, g_SpawnCountMinions, city.spawnX, city.spawnY, city.spawnZ, baseRadius, 50.0f);            // Full 35 yards
+
+    // Defenders spawn near the leader and march towards the attackers (reverse waypoint order)
+    if (g_DefendersEnabled && g_DefendersCount > 0)
+        addRing(SIEGE_TIER_DEFENDER, g_DefendersCount, city.leaderX, city.leaderY, city.leaderZ, 10.0f, 0.0f);
+
+    return formation;
+}
+
+/**
+ * @brief Returns the cached formation of a city, building it on first use.
+ * @param city The city being sieged.
+ * @param map The city's map.
+ */
+std::shared_ptr<SiegeFormation const> GetSiegeFormation(CityData const& city, Map* map)
+{
+    std::shared_ptr<SiegeFormation const>& formation = g_SiegeFormations[city.id];
+    if (!formation)
+    {
+        formation = BuildSiegeFormation(city, map);
+
+        if (g_DebugMode)
+        {
+            LOG_INFO("server.loading", "[City Siege] Built spawn formation for {}: {} slots", city.name, formation->slots.size());
+        }
+    }
+
+    return formation;
+}
+
+/**
+ * @brief Summons and prepares one unit of the army at its formation slot.
+ * @param event The siege event the unit belongs to.
+ * @param map The city's map.
+ * @param slot The formation slot to spawn.
+ */
+void SpawnSiegeUnit(SiegeEvent& event, Map* map, SiegeSpawnSlot const& slot)
+{
+    float x = slot.x;
+    float y = slot.y;
+    float z = slot.z;
+
+    Creature* creature = map->SummonCreature(event.spawnEntries[slot.tier], Position(x, y, z, 0));
+    if (!creature)
+        return;
+
+    bool const isDefender = slot.tier == SIEGE_TIER_DEFENDER;
+    bool const isAllianceCity = (event.cityId <= CITY_EXODAR);
+    ApplySiegeUnitProfile(creature, GetSiegeUnitProfile(slot.tier, (isDefender == isAllianceCity) ? TEAM_ALLIANCE : TEAM_HORDE), false);
+
+    // Set home position to spawn location to prevent evading back
+    creature->SetHomePosition(x, y, z, 0.0f);
+
+    // Enforce ground position immediately after spawn
+    creature->UpdateGroundPositionZ(x, y, z);
+
+    CitySiegeAPI::SiegeParticipantRole const role = isDefender ? CitySiegeAPI::SiegeParticipantRole::Defender : CitySiegeAPI::SiegeParticipantRole::Attacker;
+    RegisterSiegeParticipant(event, creature->GetGUID(), role, slot.tier);
+    RecordSiegeReplay(event, CitySiegeReplay::EventType::Spawn, role, slot.tier, creature->GetGUID().GetCounter(), creature->GetEntry(), x, y);
+
+    // Yell a random spawn message (compiled from CitySiege.Yell.LeaderSpawn at config load)
+    if (slot.tier == SIEGE_TIER_LEADER)
+    {
+        SiegeTextTemplate const* spawnYell = PickSiegeText(g_TextLeaderSpawnYells);
+        if (spawnYell && creature->IsAlive())
+        {
+            SiegeTextArgs args;
+            args.city = g_Cities[event.cityId].name;
+            args.leader = event.cityLeaderName;
+            creature->Yell(RenderSiegeText(*spawnYell, args), LANG_UNIVERSAL);
+        }
+    }
+
+    if (g_DebugMode)
+    {
+        LOG_INFO("server.loading", "[City Siege] Spawned {} at ({}, {}, {})", isDefender ? "defender" : "attacker", x, y, z);
+    }
+}
+
+/**
+ * @brief Spawns the next formation slots of a siege within the spawn budget of this tick.
+ * @param event The siege event being spawned.
+ * @param flushAll Spawn everything that is left, regardless of the budget.
+ */
+void ProcessSiegeSpawnJobs(SiegeEvent& event, bool flushAll = false)
+{
+    if (!event.spawnFormation)
+        return;
+
+    SiegePerfTimer perfTimer(SIEGE_PERF_SPAWN, &event.perf);
+    const CityData& city = g_Cities[event.cityId];
+    Map* map = sMapMgr->FindMap(city.mapId, 0);
+    if (!map)
+        return;
+
+    SiegeTickBudget budget(flushAll ? 0 : g_SpawnTickBudget);
+    std::vector<SiegeSpawnSlot> const& slots = event.spawnFormation->slots;
+    uint32 spawned = 0;
+
+    while (event.spawnCursor < slots.size())
+    {
+        // Always make some progress so the army is complete long before the cinematic phase ends
+        if (spawned >= g_SchedulerMinUnitsPerSlice && budget.Exhausted())
+            break;
+
+        SpawnSiegeUnit(event, map, slots[event.spawnCursor++]);
+        ++spawned;
+    }
+
+    perfTimer.AddItems(spawned);
+
+    if (event.spawnCursor >= slots.size())
+    {
+        event.spawnFormation.reset();
+
+        LOG_INFO("server.loading", "[City Siege] Spawned {} attacker and {} defender creatures in military formation for siege at {}",
+                 event.spawnedCreatures.size(), event.spawnedDefenders.size(), city.name);
+    }
+}
+
+/**
+ * @brief Starts spawning the siege army for a city siege event.
+ * The first units are spawned right away; the rest follow over the next ticks within
+ * CitySiege.Spawn.TickBudget, and everything is in place by the middle of the cinematic phase.
+ * @param event The siege event to spawn creatures for.
+ */
+void SpawnSiegeCreatures(SiegeEvent& event)
+{
+    const CityData& city = g_Cities[event.cityId];
+    
+    if (g_DebugMode)
+    {
+        LOG_INFO("server.loading", "[City Siege] Spawning creatures for siege at {}", city.name);
+        LOG_INFO("server.loading", "[City Siege]   Minions: {}", g_SpawnCountMinions);
+        LOG_INFO("server.loading", "[City Siege]   Elites: {}", g_SpawnCountElites);
+        LOG_INFO("server.loading", "[City Siege]   Mini-Bosses: {}", g_SpawnCountMiniBosses);
+        LOG_INFO("server.loading", "[City Siege]   Leaders: {}", g_SpawnCountLeaders);
+    }
+
+    Map* map = sMapMgr->FindMap(city.mapId, 0);
+    if (!map)
+    {
+        LOG_ERROR("server.loading", "[City Siege] Failed to find map {} for {}", city.mapId, city.name);
+        return;
+    }
+
+    // Define creature entries based on city faction
+    // If it's an Alliance city, spawn Horde attackers (and vice versa)
+    bool isAllianceCity = (event.cityId <= CITY_EXODAR);
+    
+    // Use configured creature entries - spawn OPPOSITE faction as attackers, defenders are of the city's own faction
+    uint8 const attackerTeam = isAllianceCity ? TEAM_HORDE : TEAM_ALLIANCE;
+    uint8 const defenderTeam = isAllianceCity ? TEAM_ALLIANCE : TEAM_HORDE;
+    for (uint8 tier = 0; tier < SIEGE_TIER_MAX; ++tier)
+        event.spawnEntries[tier] = GetSiegeUnitProfile(SiegeUnitTier(tier), tier == SIEGE_TIER_DEFENDER ? defenderTeam : attackerTeam).entry;
+    
+    // Randomly select a city leader from the opposing faction's leader pool
+    uint32 leaderEntry;
+    if (isAllianceCity)
+    {
+        // Horde attacking Alliance city - pick random Horde leader
+        uint32 randomIndex = urand(0, g_HordeCityLeaders.size() - 1);
+        leaderEntry = g_HordeCityLeaders[randomIndex];
+        
+        if (g_DebugMode)
+        {
+            LOG_INFO("server.loading", "[City Siege] Randomly selected Horde leader entry {} for attack on Alliance city {}", 
+                     leaderEntry, city.name);
+        }
+    }
+    else
+    {
+        // Alliance attacking Horde city - pick random Alliance leader
+        uint32 randomIndex = urand(0, g_AllianceCityLeaders.size() - 1);
+        leaderEntry = g_AllianceCityLeaders[randomIndex];
+        
+        if (g_DebugMode)
+        {
+            LOG_INFO("server.loading", "[City Siege] Randomly selected Alliance leader entry {} for attack on Horde city {}", 
+                     leaderEntry, city.name);
+        }
+    }
+    event.spawnEntries[SIEGE_TIER_LEADER] = leaderEntry;
 
-    // City enable/disable flags
-    g_CityEnabled["Stormwind"] = sConfigMgr->GetOption<bool>("CitySiege.Stormwind.Enabled", true);
-    g_CityEnabled["Ironforge"] = sConfigMgr->GetOption<bool>("CitySiege.Ironforge.Enabled", true);
-    g_CityEnabled["Darnassus"] = sConfigMgr->GetOption<bool>("CitySiege.Darnassus.Enabled", true);
-    g_CityEnabled["Exodar"] = sConfigMgr->GetOption<bool>("CitySiege.Exodar.Enabled", true);
-    g_CityEnabled["Orgrimmar"] = sConfigMgr->GetOption<bool>("CitySiege.Orgrimmar.Enabled", true);
-    g_CityEnabled["Undercity"] = sConfigMgr->GetOption<bool>("CitySiege.Undercity.Enabled", true);
-    g_CityEnabled["ThunderBluff"] = sConfigMgr->GetOption<bool>("CitySiege.ThunderBluff.Enabled", true);
-    g_CityEnabled["Silvermoon"] = sConfigMgr->GetOption<bool>("CitySiege.Silvermoon.Enabled", true);
+    // The siege keeps its own reference, so a config reload mid-spawn cannot pull the slots away
+    event.spawnFormation = GetSiegeFormation(city, map);
+    event.spawnCursor = 0;
+    ProcessSiegeSpawnJobs(event, !g_SpawnTickBudget);
+}
 
-    // Spawn counts
-    g_SpawnCountMinions = sConfigMgr->GetOption<uint32>("CitySiege.SpawnCount.Minions", 15);
-    g_SpawnCountElites = sConfigMgr->GetOption<uint32>("CitySiege.SpawnCount.Elites", 5);
-    g_SpawnCountMiniBosses = sConfigMgr->GetOption<uint32>("CitySiege.SpawnCount.MiniBosses", 2);
-    g_SpawnCountLeaders = sConfigMgr->GetOption<uint32>("CitySiege.SpawnCount.Leaders", 1);
+/**
+ * @brief Despawns the creatures of a siege event in chunks: attackers first, then defenders.
+ * @param event The siege event to clean up; event.teardownCursor tracks progress across calls.
+ * @param budget Tick budget; at least g_SchedulerMinUnitsPerSlice creatures are despawned per call.
+ * @return True once every creature is gone and the participant registry is cleared.
+ */
+bool DespawnSiegeCreatures(SiegeEvent& event, SiegeTickBudget const& budget)
+{
+    SiegePerfTimer perfTimer(SIEGE_PERF_DESPAWN, &event.perf);
+    const CityData& city = g_Cities[event.cityId];
+    Map* map = sMapMgr->FindMap(city.mapId, 0);
+    
+    if (map)
+    {
+        // The cursor walks attackers and then defenders as one sequence
+        size_t const total = event.spawnedCreatures.size() + event.spawnedDefenders.size();
+        uint32 processed = 0;
+        while (event.teardownCursor < total)
+        {
+            if (processed >= g_SchedulerMinUnitsPerSlice && budget.Exhausted())
+                break;
 
-    // Creature entries - Mount Hyjal battle units
-    g_CreatureAllianceMinion = sConfigMgr->GetOption<uint32>("CitySiege.Creature.Alliance.Minion", 17919);   // Alliance Footman
-    g_CreatureAllianceElite = sConfigMgr->GetOption<uint32>("CitySiege.Creature.Alliance.Elite", 17920);     // Alliance Knight
-    g_CreatureAllianceMiniBoss = sConfigMgr->GetOption<uint32>("CitySiege.Creature.Alliance.MiniBoss", 17921); // Alliance Rifleman
-    g_CreatureHordeMinion = sConfigMgr->GetOption<uint32>("CitySiege.Creature.Horde.Minion", 17932);         // Horde Grunt
-    g_CreatureHordeElite = sConfigMgr->GetOption<uint32>("CitySiege.Creature.Horde.Elite", 17933);           // Tauren Warrior
-    g_CreatureHordeMiniBoss = sConfigMgr->GetOption<uint32>("CitySiege.Creature.Horde.MiniBoss", 17934);     // Horde Headhunter
+            ObjectGuid const& guid = event.teardownCursor < event.spawnedCreatures.size()
+                ? event.spawnedCreatures[event.teardownCursor]
+                : event.spawnedDefenders[event.teardownCursor - event.spawnedCreatures.size()];
 
-    // Aggro settings
-    g_AggroPlayers = sConfigMgr->GetOption<bool>("CitySiege.AggroPlayers", true);
-    g_AggroNPCs = sConfigMgr->GetOption<bool>("CitySiege.AggroNPCs", true);
+            if (Creature* creature = map->GetCreature(guid))
+            {
+                creature->DespawnOrUnsummon();
+            }
 
-    // Defender settings
-    g_DefendersEnabled = sConfigMgr->GetOption<bool>("CitySiege.Defenders.Enabled", true);
-    g_DefendersCount = sConfigMgr->GetOption<uint32>("CitySiege.Defenders.Count", 10);
-    g_CreatureAllianceDefender = sConfigMgr->GetOption<uint32>("CitySiege.Creature.Alliance.Defender", 17919);
-    g_CreatureHordeDefender = sConfigMgr->GetOption<uint32>("CitySiege.Creature.Horde.Defender", 17932);
+            ++event.teardownCursor;
+            ++processed;
+        }
 
-    // Level settings
-    g_LevelLeader = sConfigMgr->GetOption<uint32>("CitySiege.Level.Leader", 80);
-    g_LevelMiniBoss = sConfigMgr->GetOption<uint32>("CitySiege.Level.MiniBoss", 80);
-    g_LevelElite = sConfigMgr->GetOption<uint32>("CitySiege.Level.Elite", 75);
-    g_LevelMinion = sConfigMgr->GetOption<uint32>("CitySiege.Level.Minion", 70);
-    g_LevelDefender = sConfigMgr->GetOption<uint32>("CitySiege.Level.Defender", 70);
+        perfTimer.AddItems(processed);
+        if (event.teardownCursor < total)
+            return false;
+    }
+    
+    ClearSiegeParticipants(event);
 
-    // Scale settings
-    g_ScaleLeader = sConfigMgr->GetOption<float>("CitySiege.Scale.Leader", 1.6f);
-    g_ScaleMiniBoss = sConfigMgr->GetOption<float>("CitySiege.Scale.MiniBoss", 1.3f);
+    if (g_DebugMode)
+    {
+        LOG_INFO("server.loading", "[City Siege] Despawned attackers and defenders for siege at {}", city.name);
+    }
 
-    // Cinematic settings
-    g_CinematicDelay = sConfigMgr->GetOption<uint32>("CitySiege.CinematicDelay", 150);
-    g_YellFrequency = sConfigMgr->GetOption<uint32>("CitySiege.YellFrequency", 30);
+    return true;
+}
 
-    // Respawn settings
-    g_RespawnEnabled = sConfigMgr->GetOption<bool>("CitySiege.Respawn.Enabled", true);
-    g_RespawnTimeLeader = sConfigMgr->GetOption<uint32>("CitySiege.Respawn.LeaderTime", 300);
-    g_RespawnTimeMiniBoss = sConfigMgr->GetOption<uint32>("CitySiege.Respawn.MiniBossTime", 180);
-    g_RespawnTimeElite = sConfigMgr->GetOption<uint32>("CitySiege.Respawn.EliteTime", 120);
-    g_RespawnTimeMinion = sConfigMgr->GetOption<uint32>("CitySiege.Respawn.MinionTime", 60);
-    g_RespawnTimeDefender = sConfigMgr->GetOption<uint32>("CitySiege.Defenders.RespawnTime", 45);
+/**
+ * @brief Starts a new siege event in a random city.
+ */
+// -----------------------------------------------------------------------------
+// SIEGE ROUTES
+// -----------------------------------------------------------------------------
 
-    // Reward settings
-    g_RewardOnDefense = sConfigMgr->GetOption<bool>("CitySiege.RewardOnDefense", true);
-    g_RewardHonor = sConfigMgr->GetOption<uint32>("CitySiege.RewardHonor", 100);
-    g_RewardGoldBase = sConfigMgr->GetOption<uint32>("CitySiege.RewardGoldBase", 5000);
-    g_RewardGoldPerLevel = sConfigMgr->GetOption<uint32>("CitySiege.RewardGoldPerLevel", 5000);
+// Ground samples further than this from the reference height belong to another floor and are ignored
+constexpr float ROUTE_MAX_FLOOR_DELTA = 6.0f;
 
-    // Messages
-    g_MessageSiegeStart = sConfigMgr->GetOption<std::string>("CitySiege.Message.SiegeStart", 
-        "|cffff0000[City Siege]|r The city of {CITYNAME} is under attack! Defenders are needed!");
-    g_MessageSiegeEnd = sConfigMgr->GetOption<std::string>("CitySiege.Message.SiegeEnd", 
-        "|cff00ff00[City Siege]|r The siege of {CITYNAME} has ended!");
-    g_MessageReward = sConfigMgr->GetOption<std::string>("CitySiege.Message.Reward", 
-        "|cff00ff00[City Siege]|r You have been rewarded for {ACTION} {CITYNAME}!");
-    
-    // Yells
-    g_YellLeaderSpawn = sConfigMgr->GetOption<std::string>("CitySiege.Yell.LeaderSpawn", 
-        "This city will fall before our might!");
-    g_YellsCombat = sConfigMgr->GetOption<std::string>("CitySiege.Yell.Combat", 
-        "Your defenses crumble!;This city will burn!;Face your doom!;None can stand against us!;Your leaders will fall!");
-    
-    // RP Phase scripts (multiple scripts separated by |, lines within each script separated by ;)
-    g_RPScriptsAlliance = sConfigMgr->GetOption<std::string>("CitySiege.RP.Alliance", 
-        "Citizens of {CITY}, your time has come! We march under the banner of the Alliance!;{LEADER}, your people cry out for mercy, but you have shown none to ours!;We have crossed mountains and seas to bring justice to {CITY}. Surrender now, or face annihilation!;The Light guides our blades, and the might of Stormwind stands behind us. Your defenses will crumble!;This ends today! {LEADER}, come forth and face the Alliance, or watch {CITY} burn!|The Alliance has gathered its greatest heroes for this assault on {CITY}. You cannot stand against us!;{LEADER}, your leadership has made the Horde enemies it cannot defeat! We will tear down these walls!;Too long have you raided our villages and slaughtered our people. Today, we bring the war to {CITY}!;Your shamans' magic cannot protect you. Our priests and paladins have blessed this army!;Prepare to face the wrath of the Alliance! {LEADER}, your reign over {CITY} ends here and now!|By order of King Varian Wrynn, {CITY} is to be taken! Resistance is futile!;{LEADER}! Come forth and face us, or hide like a coward while your people suffer!;The Horde's reign of terror ends here at {CITY}. We will show no mercy to those who threaten peace!;Our siege engines are ready. The walls of {CITY} mean nothing to the might of the Alliance!;For every innocent killed by Horde aggression, {LEADER}, you will pay with your life!");
-    g_RPScriptsHorde = sConfigMgr->GetOption<std::string>("CitySiege.RP.Horde", 
-        "The Horde has come to claim {CITY}! Your precious Alliance ends today!;{LEADER}, you have oppressed our people for the last time! Come out and face your fate!;We are not savages - we are warriors! And today, we show {CITY} what true strength means!;Your guards are weak. Your walls are weak. {LEADER} hides in the throne room while we stand at the gates!;Blood and honor! Today we prove that the Horde is the superior force in Azeroth!|Citizens of {CITY}, flee while you can! We have come for your leaders, not for you!;{LEADER}! Your reign of tyranny over {CITY} ends today! The throne will belong to the Horde!;You call us monsters, but it is YOU who started this war! We finish it today at {CITY}!;The spirits of our ancestors guide us. No amount of Light magic will save {CITY} from our wrath!;Lok'tar Ogar! {LEADER}, today you fall, and the Horde claims {CITY}!|The Warchief has sent his finest warriors to end Alliance tyranny at {CITY} once and for all!;Your pitiful city guard cannot stop the Horde war machine! {LEADER}, your time has come!;We march for honor! We march for glory! We march to prove that the Horde will take {CITY}!;Every siege tower, every warrior, every drop of blood spilled today at {CITY} - it all leads to YOUR defeat!;{LEADER}, the Alliance has grown soft under your leadership. Today at {CITY}, the Horde reminds you why you should fear us!");
+/**
+ * @brief Snaps a route point to the ground right under it.
+ * Keeps the reference height when the sample lands on another floor (multi-level cities).
+ * @return true if ground was found near the reference height.
+ */
+bool SampleRouteGround(Map* map, float x, float y, float& z)
+{
+    float groundZ = map->GetHeight(x, y, z + 5.0f, true, 50.0f);
+    if (groundZ <= INVALID_HEIGHT || std::abs(groundZ - z) > ROUTE_MAX_FLOOR_DELTA)
+        return false;
 
-#ifdef MOD_PLAYERBOTS
-    // Playerbot Integration
-    g_PlayerbotsEnabled = sConfigMgr->GetOption<bool>("CitySiege.Playerbots.Enabled", false);
-    g_PlayerbotsMinLevel = sConfigMgr->GetOption<uint32>("CitySiege.Playerbots.MinLevel", 70);
-    g_PlayerbotsMaxDefenders = sConfigMgr->GetOption<uint32>("CitySiege.Playerbots.MaxDefenders", 20);
-    g_PlayerbotsMaxAttackers = sConfigMgr->GetOption<uint32>("CitySiege.Playerbots.MaxAttackers", 20);
-    g_PlayerbotsRespawnDelay = sConfigMgr->GetOption<uint32>("CitySiege.Playerbots.RespawnDelay", 30);
-#endif
+    z = groundZ;
+    return true;
+}
 
-    // Weather settings
-    g_WeatherEnabled = sConfigMgr->GetOption<bool>("CitySiege.Weather.Enabled", true);
-    g_WeatherType = static_cast<WeatherState>(sConfigMgr->GetOption<uint32>("CitySiege.Weather.Type", WEATHER_STATE_MEDIUM_RAIN));
-    g_WeatherGrade = sConfigMgr->GetOption<float>("CitySiege.Weather.Grade", 0.8f);
+/**
+ * @brief Compiles a city's route: ground-validated stops, spread slots and segment paths.
+ * @param city The city to compile.
+ * @param map The city's map.
+ * @param pathSource A unit on the map used for navmesh queries, or nullptr to sample straight lines only.
+ */
+std::shared_ptr<SiegeRoute const> CompileSiegeRoute(CityData const& city, Map* map, WorldObject const* pathSource)
+{
+    auto route = std::make_shared<SiegeRoute>();
 
-    // Music settings
-    g_MusicEnabled   = sConfigMgr->GetOption<bool>("CitySiege.Music.Enabled", true);
-    g_RPMusicId      = sConfigMgr->GetOption<uint32>("CitySiege.Music.RPMusicId", 11803);        // The Burning Legion
-    g_CombatMusicId  = sConfigMgr->GetOption<uint32>("CitySiege.Music.CombatMusicId", 11804); // Battle of Mount Hyjal
-    g_VictoryMusicId = sConfigMgr->GetOption<uint32>("CitySiege.Music.VictoryMusicId", 16039); // Invincible
-    g_DefeatMusicId  = sConfigMgr->GetOption<uint32>("CitySiege.Music.DefeatMusicId", 14127);   // Wrath of the Lich King
+    route->stops.push_back({ city.spawnX, city.spawnY, city.spawnZ });
+    route->stops.insert(route->stops.end(), city.waypoints.begin(), city.waypoints.end());
+    route->stops.push_back({ city.leaderX, city.leaderY, city.leaderZ });
 
-    // Load spawn locations for each city
-    g_Cities[CITY_STORMWIND].spawnX = sConfigMgr->GetOption<float>("CitySiege.Stormwind.SpawnX", -9161.16f);
-    g_Cities[CITY_STORMWIND].spawnY = sConfigMgr->GetOption<float>("CitySiege.Stormwind.SpawnY", 353.365f);
-    g_Cities[CITY_STORMWIND].spawnZ = sConfigMgr->GetOption<float>("CitySiege.Stormwind.SpawnZ", 88.117f);
-    
-    g_Cities[CITY_IRONFORGE].spawnX = sConfigMgr->GetOption<float>("CitySiege.Ironforge.SpawnX", -5174.09f);
-    g_Cities[CITY_IRONFORGE].spawnY = sConfigMgr->GetOption<float>("CitySiege.Ironforge.SpawnY", -594.361f);
-    g_Cities[CITY_IRONFORGE].spawnZ = sConfigMgr->GetOption<float>("CitySiege.Ironforge.SpawnZ", 397.853f);
-    
-    g_Cities[CITY_DARNASSUS].spawnX = sConfigMgr->GetOption<float>("CitySiege.Darnassus.SpawnX", 9887.36f);
-    g_Cities[CITY_DARNASSUS].spawnY = sConfigMgr->GetOption<float>("CitySiege.Darnassus.SpawnY", 1856.49f);
-    g_Cities[CITY_DARNASSUS].spawnZ = sConfigMgr->GetOption<float>("CitySiege.Darnassus.SpawnZ", 1317.14f);
-    
-    g_Cities[CITY_EXODAR].spawnX = sConfigMgr->GetOption<float>("CitySiege.Exodar.SpawnX", -4080.80f);
-    g_Cities[CITY_EXODAR].spawnY = sConfigMgr->GetOption<float>("CitySiege.Exodar.SpawnY", -12193.2f);
-    g_Cities[CITY_EXODAR].spawnZ = sConfigMgr->GetOption<float>("CitySiege.Exodar.SpawnZ", 1.712f);
-    
-    g_Cities[CITY_ORGRIMMAR].spawnX = sConfigMgr->GetOption<float>("CitySiege.Orgrimmar.SpawnX", 1114.96f);
-    g_Cities[CITY_ORGRIMMAR].spawnY = sConfigMgr->GetOption<float>("CitySiege.Orgrimmar.SpawnY", -4374.63f);
-    g_Cities[CITY_ORGRIMMAR].spawnZ = sConfigMgr->GetOption<float>("CitySiege.Orgrimmar.SpawnZ", 25.813f);
-    
-    g_Cities[CITY_UNDERCITY].spawnX = sConfigMgr->GetOption<float>("CitySiege.Undercity.SpawnX", 1982.26f);
-    g_Cities[CITY_UNDERCITY].spawnY = sConfigMgr->GetOption<float>("CitySiege.Undercity.SpawnY", 226.674f);
-    g_Cities[CITY_UNDERCITY].spawnZ = sConfigMgr->GetOption<float>("CitySiege.Undercity.SpawnZ", 35.951f);
-    
-    g_Cities[CITY_THUNDERBLUFF].spawnX = sConfigMgr->GetOption<float>("CitySiege.ThunderBluff.SpawnX", -1558.61f);
-    g_Cities[CITY_THUNDERBLUFF].spawnY = sConfigMgr->GetOption<float>("CitySiege.ThunderBluff.SpawnY", -5.071f);
-    g_Cities[CITY_THUNDERBLUFF].spawnZ = sConfigMgr->GetOption<float>("CitySiege.ThunderBluff.SpawnZ", 5.384f);
-    
-    g_Cities[CITY_SILVERMOON].spawnX = sConfigMgr->GetOption<float>("CitySiege.Silvermoon.SpawnX", 9230.47f);
-    g_Cities[CITY_SILVERMOON].spawnY = sConfigMgr->GetOption<float>("CitySiege.Silvermoon.SpawnY", -6962.67f);
-    g_Cities[CITY_SILVERMOON].spawnZ = sConfigMgr->GetOption<float>("CitySiege.Silvermoon.SpawnZ", 5.004f);
+    for (Waypoint& stop : route->stops)
+        SampleRouteGround(map, stop.x, stop.y, stop.z);
 
-    // Load leader locations for each city
-    g_Cities[CITY_STORMWIND].leaderX = sConfigMgr->GetOption<float>("CitySiege.Stormwind.LeaderX", -8442.578f);
-    g_Cities[CITY_STORMWIND].leaderY = sConfigMgr->GetOption<float>("CitySiege.Stormwind.LeaderY", 334.6064f);
-    g_Cities[CITY_STORMWIND].leaderZ = sConfigMgr->GetOption<float>("CitySiege.Stormwind.LeaderZ", 122.476685f);
-    
-    g_Cities[CITY_IRONFORGE].leaderX = sConfigMgr->GetOption<float>("CitySiege.Ironforge.LeaderX", -4981.25f);
-    g_Cities[CITY_IRONFORGE].leaderY = sConfigMgr->GetOption<float>("CitySiege.Ironforge.LeaderY", -881.542f);
-    g_Cities[CITY_IRONFORGE].leaderZ = sConfigMgr->GetOption<float>("CitySiege.Ironforge.LeaderZ", 501.660f);
-    
-    g_Cities[CITY_DARNASSUS].leaderX = sConfigMgr->GetOption<float>("CitySiege.Darnassus.LeaderX", 9947.52f);
-    g_Cities[CITY_DARNASSUS].leaderY = sConfigMgr->GetOption<float>("CitySiege.Darnassus.LeaderY", 2482.73f);
-    g_Cities[CITY_DARNASSUS].leaderZ = sConfigMgr->GetOption<float>("CitySiege.Darnassus.LeaderZ", 1316.21f);
-    
-    g_Cities[CITY_EXODAR].leaderX = sConfigMgr->GetOption<float>("CitySiege.Exodar.LeaderX", -3864.92f);
-    g_Cities[CITY_EXODAR].leaderY = sConfigMgr->GetOption<float>("CitySiege.Exodar.LeaderY", -11643.7f);
-    g_Cities[CITY_EXODAR].leaderZ = sConfigMgr->GetOption<float>("CitySiege.Exodar.LeaderZ", -137.644f);
-    
-    g_Cities[CITY_ORGRIMMAR].leaderX = sConfigMgr->GetOption<float>("CitySiege.Orgrimmar.LeaderX", 1633.75f);
-    g_Cities[CITY_ORGRIMMAR].leaderY = sConfigMgr->GetOption<float>("CitySiege.Orgrimmar.LeaderY", -4439.39f);
-    g_Cities[CITY_ORGRIMMAR].leaderZ = sConfigMgr->GetOption<float>("CitySiege.Orgrimmar.LeaderZ", 15.4396f);
-    
-    g_Cities[CITY_UNDERCITY].leaderX = sConfigMgr->GetOption<float>("CitySiege.Undercity.LeaderX", 1633.75f);
-    g_Cities[CITY_UNDERCITY].leaderY = sConfigMgr->GetOption<float>("CitySiege.Undercity.LeaderY", 240.167f);
-    g_Cities[CITY_UNDERCITY].leaderZ = sConfigMgr->GetOption<float>("CitySiege.Undercity.LeaderZ", -43.1034f);
-    
-    g_Cities[CITY_THUNDERBLUFF].leaderX = sConfigMgr->GetOption<float>("CitySiege.ThunderBluff.LeaderX", -1043.11f);
-    g_Cities[CITY_THUNDERBLUFF].leaderY = sConfigMgr->GetOption<float>("CitySiege.ThunderBluff.LeaderY", 285.809f);
-    g_Cities[CITY_THUNDERBLUFF].leaderZ = sConfigMgr->GetOption<float>("CitySiege.ThunderBluff.LeaderZ", 135.165f);
-    
-    g_Cities[CITY_SILVERMOON].leaderX = sConfigMgr->GetOption<float>("CitySiege.Silvermoon.LeaderX", 9338.74f);
-    g_Cities[CITY_SILVERMOON].leaderY = sConfigMgr->GetOption<float>("CitySiege.Silvermoon.LeaderY", -7277.27f);
-    g_Cities[CITY_SILVERMOON].leaderZ = sConfigMgr->GetOption<float>("CitySiege.Silvermoon.LeaderZ", 13.7014f);
+    // Spread slots replace per-move randomization: alternate inner and outer ring so neighbours do not overlap
+    for (Waypoint const& stop : route->stops)
+    {
+        std::vector<Waypoint> slots;
+        for (uint32 i = 0; i < g_RouteJitterSlots; ++i)
+        {
+            float const angle = 2.0f * M_PI * i / g_RouteJitterSlots;
+            float const radius = g_RouteJitterRadius * ((i % 2) ? 1.0f : 0.5f);
+            Waypoint slot = { stop.x + radius * std::cos(angle), stop.y + radius * std::sin(angle), stop.z };
+
+            if (SampleRouteGround(map, slot.x, slot.y, slot.z))
+                slots.push_back(slot);
+        }
+
+        if (slots.empty())
+            slots.push_back(stop);
+
+        route->stopSlots.push_back(std::move(slots));
+    }
+
+    std::unique_ptr<PathGenerator> path;
+    if (pathSource)
+        path = std::make_unique<PathGenerator>(pathSource);
+
+    for (size_t i = 0; i + 1 < route->stops.size(); ++i)
+    {
+        Waypoint const& from = route->stops[i];
+        Waypoint const& to = route->stops[i + 1];
+        std::vector<Waypoint> segment;
+
+        // Prefer the navmesh path between the stops
+        if (path && path->CalculatePath(from.x, from.y, from.z, to.x, to.y, to.z, false) &&
+            (path->GetPathType() & PATHFIND_NORMAL) && path->GetPath().size() >= 2)
+        {
+            for (G3D::Vector3 const& point : path->GetPath())
+            {
+                Waypoint node = { point.x, point.y, point.z };
+                SampleRouteGround(map, node.x, node.y, node.z);
+                segment.push_back(node);
+            }
+
+            ++route->navmeshSegments;
+        }
+        else
+        {
+            // No navmesh path: sample the straight line, following the ground between the stop heights
+            float const length = std::hypot(to.x - from.x, to.y - from.y);
+            uint32 const steps = std::max<uint32>(1, static_cast<uint32>(length / g_RouteSampleStep));
+
+            for (uint32 step = 0; step <= steps; ++step)
+            {
+                float const t = static_cast<float>(step) / steps;
+                Waypoint node = { from.x + (to.x - from.x) * t, from.y + (to.y - from.y) * t, from.z + (to.z - from.z) * t };
+                SampleRouteGround(map, node.x, node.y, node.z);
+                segment.push_back(node);
+            }
+        }
+
+        segment.front() = from;
+        segment.back() = to;
+        route->segments.push_back(std::move(segment));
+    }
+
+    return route;
+}
+
+/**
+ * @brief Returns a city's compiled route, compiling it on first use.
+ * Routes are only compiled with a path source, so a cached route always had the navmesh available.
+ * @param city The city.
+ * @param map The city's map.
+ * @param pathSource A unit on the map for navmesh queries (only used when the route is compiled).
+ * @return The route, or nullptr if it is not compiled yet and there is no path source.
+ */
+SiegeRoute const* GetSiegeRoute(CityData const& city, Map* map, WorldObject const* pathSource)
+{
+    std::shared_ptr<SiegeRoute const>& route = g_SiegeRoutes[city.id];
+    if (!route && map && pathSource)
+    {
+        route = CompileSiegeRoute(city, map, pathSource);
+
+        if (g_DebugMode)
+        {
+            LOG_INFO("server.loading", "[City Siege] Compiled route for {}: {} stops, {} segments ({} from navmesh)",
+                     city.name, route->stops.size(), route->segments.size(), route->navmeshSegments);
+        }
+    }
+
+    return route.get();
+}
+
+// -----------------------------------------------------------------------------
+// SIEGE MAP WORLD
+// -----------------------------------------------------------------------------
 
-    // Load waypoints for each city
-    for (auto& city : g_Cities)
+/**
+ * @brief The World of CitySiegeUpdate.h on a real map: units are the map's creatures.
+ * Only used by the thread updating the map, or by the world thread while the maps are idle.
+ */
+class SiegeMapWorld
+{
+public:
+    explicit SiegeMapWorld(Map* map) : _map(map) { }
+
+    // Map lookup
+    Creature* FindUnit(ObjectGuid const& guid) const { return _map->GetCreature(guid); }
+    bool IsAlive(Creature* creature) const { return creature->IsAlive(); }
+    bool IsInCombat(Creature* creature) const { return creature->IsInCombat(); }
+    bool IsMoving(Creature* creature) const { return !creature->movespline->Finalized(); }
+
+    bool IsFollowing(Creature* creature) const
     {
-        city.waypoints.clear();
-        
-        // Get waypoint count for this city
-        std::string waypointCountKey = "CitySiege." + city.name + ".WaypointCount";
-        uint32 waypointCount = sConfigMgr->GetOption<uint32>(waypointCountKey, 0);
-        
-        if (g_DebugMode)
+        return creature->GetMotionMaster()->GetCurrentMovementGeneratorType() == FOLLOW_MOTION_TYPE;
+    }
+
+    Waypoint GetPosition(Creature* creature) const
+    {
+        return { creature->GetPositionX(), creature->GetPositionY(), creature->GetPositionZ() };
+    }
+
+    float GetDistance(Creature* creature, Waypoint const& point) const { return creature->GetDistance(point.x, point.y, point.z); }
+    uint32 GetSpreadSeed(Creature* creature) const { return creature->GetGUID().GetCounter(); }
+
+    void AnchorHome(Creature* creature) const
+    {
+        creature->SetHomePosition(creature->GetPositionX(), creature->GetPositionY(), creature->GetPositionZ(), creature->GetOrientation());
+    }
+
+    void EnforceGrounding(Creature* creature) const { EnforceSiegeUnitGrounding(creature); }
+
+    // Height query
+    bool GetGroundHeight(float x, float y, float z, float& groundZ) const
+    {
+        groundZ = _map->GetHeight(x, y, z, true, 50.0f);
+        return groundZ > INVALID_HEIGHT;
+    }
+
+    // Spline launch
+    void MoveTo(Creature* creature, Waypoint const& point) const
+    {
+        Movement::MoveSplineInit init(creature);
+        init.MoveTo(point.x, point.y, point.z, true, true);
+        init.SetWalk(false);
+        init.Launch();
+    }
+
+    void MoveByPath(Creature* creature, std::vector<Waypoint> const& points) const
+    {
+        Movement::PointsArray path;
+        path.reserve(points.size());
+        for (Waypoint const& point : points)
+            path.emplace_back(point.x, point.y, point.z);
+
+        Movement::MoveSplineInit init(creature);
+        init.MovebyPath(path);
+        init.SetWalk(false);
+        init.Launch();
+    }
+
+    void Follow(Creature* follower, Creature* leader, float distance, float angle) const
+    {
+        follower->GetMotionMaster()->MoveFollow(leader, distance, angle);
+    }
+
+    // Player iteration: a cell visit around the point, the map's player list when the range is 0
+    template<class Fn>
+    void ForEachPlayer(float x, float y, float z, float range, Fn&& fn) const
+    {
+        std::vector<Player*> players;
+        if (range > 0.0f)
         {
-            LOG_INFO("server.loading", "[City Siege] Loading {} waypoints for {}", waypointCount, city.name);
+            CitySiege::PlayerInRangeCheck check(x, y, z, range);
+            CitySiege::SimplePlayerListSearcher<CitySiege::PlayerInRangeCheck> searcher(players, check);
+            Cell::VisitObjects(x, y, _map, searcher, range);
         }
-        
-        // Load each waypoint
-        for (uint32 i = 0; i < waypointCount; ++i)
+        else
         {
-            std::string baseKey = "CitySiege." + city.name + ".Waypoint" + std::to_string(i + 1);
-            Waypoint wp;
-            wp.x = sConfigMgr->GetOption<float>(baseKey + ".X", 0.0f);
-            wp.y = sConfigMgr->GetOption<float>(baseKey + ".Y", 0.0f);
-            wp.z = sConfigMgr->GetOption<float>(baseKey + ".Z", 0.0f);
-            
-            // Only add waypoint if coordinates are valid
-            if (wp.x != 0.0f || wp.y != 0.0f || wp.z != 0.0f)
-            {
-                city.waypoints.push_back(wp);
-                
-                if (g_DebugMode)
-                {
-                    LOG_INFO("server.loading", "[City Siege]   Waypoint {}: ({}, {}, {})", 
-                             i + 1, wp.x, wp.y, wp.z);
-                }
-            }
+            Map::PlayerList const& mapPlayers = _map->GetPlayers();
+            for (auto itr = mapPlayers.begin(); itr != mapPlayers.end(); ++itr)
+                if (Player* player = itr->GetSource())
+                    players.push_back(player);
         }
-    }
 
-    if (g_DebugMode)
-    {
-        LOG_INFO("server.loading", "[City Siege] Configuration loaded:");
-        LOG_INFO("server.loading", "[City Siege]   Enabled: {}", g_CitySiegeEnabled);
-        LOG_INFO("server.loading", "[City Siege]   Timer: {}-{} minutes", g_TimerMin / 60, g_TimerMax / 60);
-        LOG_INFO("server.loading", "[City Siege]   Event Duration: {} minutes", g_EventDuration / 60);
+        for (Player* player : players)
+            fn(player->GetGUID(), Waypoint{ player->GetPositionX(), player->GetPositionY(), player->GetPositionZ() });
     }
+
+    // Siege hooks, defined with the map work further down
+    SiegeRoute const* GetRoute(CityData const& city, Creature* creature) const { return GetSiegeRoute(city, _map, creature); }
+    Creature* RespawnUnit(SiegeEvent& event, SiegeParticipant& participant, SiegeEvent::RespawnData const& respawnData,
+        Waypoint const& position) const;
+    void OnWaypointReached(SiegeEvent& event, SiegeParticipant const& participant, Creature* creature) const;
+    void CreditPresence(SiegeEvent& event, ObjectGuid const& guid, uint32 ms) const;
+    bool IsLeaderDefeated(SiegeEvent& event) const;
+    void OnLeaderDefeated(SiegeEvent& event) const;
+    void SampleLeaderHealth(SiegeEvent& event) const;
+    float RandomFloat(float min, float max) const { return frand(min, max); }
+    SiegePerfTimer StartTimer(SiegeEvent& event, SiegeMapWorkPhase phase) const;
+
+private:
+    Map* _map;
+};
+
+/**
+ * @brief Collects the map work configuration from the loaded CitySiege.* options.
+ */
+SiegeMapWorkSettings GetSiegeMapWorkSettings()
+{
+    SiegeMapWorkSettings settings;
+    settings.minUnitsPerSlice = g_SchedulerMinUnitsPerSlice;
+    settings.movementInterval = g_SchedulerMovementInterval;
+    settings.respawnInterval = g_SchedulerRespawnInterval;
+    settings.winCheckInterval = g_SchedulerWinCheckInterval;
+    settings.proximityInterval = g_SchedulerProximityInterval;
+    settings.announceRadius = g_AnnounceRadius;
+    settings.squadSpacing = g_SquadSpacing;
+    settings.respawnEnabled = g_RespawnEnabled;
+    settings.creditPresence = g_ContributionEnabled && g_ContributionPointsPerMinute;
+    return settings;
 }
 
 /**
- * @brief Selects a random city for siege event.
- * @return Pointer to the selected CityData, or nullptr if no cities are available.
+ * @brief Starts a creature along a route segment towards one of the target stop's spread slots.
+ * @param creature The unit to move.
+ * @param route The city's compiled route.
+ * @param targetStop Index of the stop to walk to.
+ * @param reverse true when walking from the leader towards the spawn point (defenders).
  */
-CityData* SelectRandomCity()
+void LaunchSiegeRouteMovement(Creature* creature, SiegeRoute const& route, uint32 targetStop, bool reverse)
 {
-    std::vector<CityData*> availableCities;
+    SiegeMapWorld world(creature->GetMap());
+    LaunchSiegeRouteMovement(world, creature, route, targetStop, reverse);
+}
 
-    for (auto& city : g_Cities)
+// -----------------------------------------------------------------------------
+// SQUADS
+// -----------------------------------------------------------------------------
+
+/**
+ * @brief Groups a siege's units into squads; only squad leaders get route updates from then on.
+ * Consecutive spawns stand next to each other in the spawn rings, so they form the squads.
+ * The highest level unit of each group leads it.
+ * @param event The siege event.
+ * @param map The siege map.
+ */
+void FormSiegeSquads(SiegeEvent& event, Map* map)
+{
+    event.squads.clear();
+    for (SiegeParticipant& participant : event.participants.records)
+        participant.squadId = 0;
+
+    if (g_SquadSize < 2)
+        return;
+
+    for (CitySiegeAPI::SiegeParticipantRole role : { CitySiegeAPI::SiegeParticipantRole::Attacker, CitySiegeAPI::SiegeParticipantRole::Defender })
     {
-        if (g_CityEnabled[city.name])
+        std::vector<ObjectGuid> const& roleList = GetParticipantRoleList(event, role);
+
+        for (size_t first = 0; first + 1 < roleList.size(); first += g_SquadSize)
         {
-            // Check if city already has an active siege (if multiple sieges not allowed)
-            if (!g_AllowMultipleCities)
+            size_t const last = std::min<size_t>(roleList.size(), first + g_SquadSize);
+
+            std::vector<ObjectGuid> members;
+            ObjectGuid leader;
+            uint8 leaderLevel = 0;
+            for (size_t i = first; i < last; ++i)
             {
-                bool alreadyUnderSiege = false;
-                for (const auto& siege : g_ActiveSieges)
-                {
-                    if (siege.isActive && siege.cityId == city.id)
-                    {
-                        alreadyUnderSiege = true;
-                        break;
-                    }
-                }
-                if (!alreadyUnderSiege)
+                Creature* creature = map->GetCreature(roleList[i]);
+                if (!creature || !creature->IsAlive())
+                    continue;
+
+                members.push_back(roleList[i]);
+                if (leader.IsEmpty() || creature->GetLevel() > leaderLevel)
                 {
-                    availableCities.push_back(&city);
+                    leader = roleList[i];
+                    leaderLevel = creature->GetLevel();
                 }
             }
-            else
-            {
-                availableCities.push_back(&city);
-            }
+
+            // A single unit simply moves on its own
+            if (members.size() < 2)
+                continue;
+
+            SiegeSquad squad;
+            squad.leader = leader;
+            for (ObjectGuid const& member : members)
+                if (member != leader)
+                    squad.followers.push_back(member);
+
+            event.squads.push_back(std::move(squad));
+
+            uint32 const squadId = event.squads.size();
+            for (ObjectGuid const& member : members)
+                FindSiegeParticipant(event, member)->squadId = squadId;
         }
     }
 
-    if (availableCities.empty())
+    if (g_DebugMode)
     {
-        return nullptr;
+        LOG_INFO("server.loading", "[City Siege] Formed {} squads for siege of {}", event.squads.size(), g_Cities[event.cityId].name);
     }
+}
 
-    uint32 randomIndex = urand(0, availableCities.size() - 1);
-    return availableCities[randomIndex];
+/**
+ * @brief Puts a follower into its formation slot behind the squad leader, using the core's follow movement.
+ * Slots alternate left and right of the leader, one row further back every two followers.
+ * @param follower The follower.
+ * @param leader The squad leader.
+ * @param formationSlot The follower's position in SiegeSquad::followers.
+ */
+void StartSquadFollow(Creature* follower, Creature* leader, uint32 formationSlot)
+{
+    SiegeMapWorld world(follower->GetMap());
+    StartSquadFollow(world, follower, leader, formationSlot, g_SquadSpacing);
 }
 
 /**
- * @brief Announces a siege event to players.
- * @param city The city being sieged.
- * @param isStart True if siege is starting, false if ending.
+ * @brief Removes a dead unit from its squad. When the leader dies, the first follower takes over
+ * the route where the leader left it and the remaining followers re-form on the new leader.
+ * Respawned units move on their own.
+ * @param event The siege event.
+ * @param map The siege map.
+ * @param guid GUID of the dead unit.
  */
-void AnnounceSiege(const CityData& city, bool isStart)
+void LeaveSiegeSquad(SiegeEvent& event, Map* map, ObjectGuid const& guid)
 {
-    std::string message = ReplacePlaceholder(isStart ? g_MessageSiegeStart : g_MessageSiegeEnd,
-        "{CITYNAME}", city.name);
-    SendSiegeScopedMessage(city, message);
+    SiegeParticipant* participant = FindSiegeParticipant(event, guid);
+    if (!participant || !participant->squadId)
+        return;
 
-    if (g_DebugMode)
+    SiegeSquad& squad = event.squads[participant->squadId - 1];
+    participant->squadId = 0;
+
+    if (squad.leader != guid)
     {
-        LOG_INFO("server.loading", "[City Siege] {}", message);
+        squad.followers.erase(std::remove(squad.followers.begin(), squad.followers.end(), guid), squad.followers.end());
+        return;
+    }
+
+    squad.leader.Clear();
+    if (squad.followers.empty())
+        return;
+
+    squad.leader = squad.followers.front();
+    squad.followers.erase(squad.followers.begin());
+    if (SiegeParticipant* newLeaderRecord = FindSiegeParticipant(event, squad.leader))
+        newLeaderRecord->waypoint = participant->waypoint;
+
+    Creature* newLeader = map->GetCreature(squad.leader);
+    if (!newLeader)
+        return;
+
+    // Drop the follow movement; the next movement pass launches the new leader along the route
+    newLeader->GetMotionMaster()->Clear(false);
+    newLeader->GetMotionMaster()->MoveIdle();
+
+    for (uint32 slot = 0; slot < squad.followers.size(); ++slot)
+    {
+        Creature* follower = map->GetCreature(squad.followers[slot]);
+        if (follower && follower->IsAlive() && !follower->IsInCombat())
+            StartSquadFollow(follower, newLeader, slot);
     }
 }
 
 /**
- * @brief Sends siege data to a specific player's addon.
- * @param player The target player.
- * @param event The siege event to serialize.
- * @param messageType Type of message (START, UPDATE, END).
- * @param winner Winner identifier for END messages.
+ * @brief Validates and corrects ground position before movement to prevent floating/stuck units.
+ * @param x X coordinate
+ * @param y Y coordinate  
+ * @param z Reference to Z coordinate to adjust
+ * @param map Map to check ground height
+ * @return true if position is valid, false if position is invalid/unreachable
  */
-void SendSiegeDataToPlayer(Player* player, const SiegeEvent& event,
-    const std::string& messageType, const std::string& winner = "unknown")
+bool ValidateGroundPosition(float x, float y, float& z, Map* map)
 {
-    if (!player)
-        return;
-
-    const CityData& city = g_Cities[event.cityId];
-    Map* map = sMapMgr->FindMap(city.mapId, 0);
     if (!map)
-        return;
-
-    std::ostringstream ss;
+        return false;
 
-    if (messageType == "START")
+    // Get ground height with generous search range
+    float groundZ = map->GetHeight(x, y, z + 100.0f, true, 100.0f);
+    
+    // If ground height is invalid, try searching from below
+    if (groundZ <= INVALID_HEIGHT)
     {
-        std::string attackingFaction = IsAllianceCity(event.cityId) ? "Horde" : "Alliance";
-        ss << "START:" << static_cast<uint32>(event.cityId) << ":" << attackingFaction
-           << ":" << std::fixed << std::setprecision(2)
-           << city.spawnX << ":" << city.spawnY << ":" << city.spawnZ
-           << ":" << city.leaderX << ":" << city.leaderY << ":" << city.leaderZ
-           << ":" << city.centerX << ":" << city.centerY << ":" << city.centerZ;
+        groundZ = map->GetHeight(x, y, z - 50.0f, true, 100.0f);
     }
-    else if (messageType == "UPDATE")
+    
+    // Still invalid - position is not reachable
+    if (groundZ <= INVALID_HEIGHT)
     {
-        float leaderHealthPct = 0.0f;
-        if (event.cityLeaderGuid)
-        {
-            if (Creature* leader = map->GetCreature(event.cityLeaderGuid))
-            {
-                if (leader->IsAlive())
-                    leaderHealthPct = leader->GetHealthPct();
-            }
-        }
+        return false;
+    }
+    
+    // Clamp Z to be no more than 5 yards from ground (prevent high-altitude floating)
+    if (z > groundZ + 5.0f)
+    {
+        z = groundZ + 0.5f;
+    }
+    else if (z < groundZ - 2.0f)
+    {
+        // Too far below ground, raise to ground level
+        z = groundZ + 0.5f;
+    }
+    
+    return true;
+}
 
-        uint32 attackerCount = event.spawnedCreatures.size();
-        uint32 defenderCount = event.spawnedDefenders.size();
-        uint32 elapsed = time(nullptr) - event.startTime;
-        uint32 remaining = event.endTime > time(nullptr) ? event.endTime - time(nullptr) : 0;
+#ifdef MOD_PLAYERBOTS
+// Travel destinations for one city's route, one per waypoint, shared by every bot marching it.
+// A destination only holds its point and radius, so forward and reverse legs use the same entry.
+// Bots keep raw pointers into the pool, so it lives from the first bot order of a siege until the
+// last teardown stage of every siege of the city, after all their bots were returned and had their target cleared.
+struct SiegeBotTravelPool
+{
+    std::vector<std::unique_ptr<WorldPosition>> positions;
+    std::vector<std::unique_ptr<TravelDestination>> destinations;
+};
 
-        uint32 phase = 1;
-        if (!event.cinematicPhase)
-        {
-            uint32 duration = event.endTime - event.startTime;
-            if (elapsed > duration * 0.75f)
-                phase = 4;
-            else if (elapsed > duration * 0.5f)
-                phase = 3;
-            else if (elapsed > duration * 0.25f)
-                phase = 2;
-        }
+static std::array<std::unique_ptr<SiegeBotTravelPool>, CITY_MAX> g_BotTravelPools;
+static std::array<uint32, CITY_MAX> g_BotTravelPoolUsers{}; // Sieges of the city, running or tearing down
+static uint32 g_BotTravelLiveObjects = 0;                   // Pooled positions and destinations currently allocated
 
-        ss << "UPDATE:" << static_cast<uint32>(event.cityId) << ":" << phase
-           << ":" << attackerCount << ":" << defenderCount
-           << ":" << elapsed << ":" << remaining
-           << ":" << std::fixed << std::setprecision(1) << leaderHealthPct;
+/**
+ * @brief Returns the travel destination pool for a city, building it from the city's waypoints on first use.
+ * @param city The city whose route the bots follow.
+ * @return The pool. A route changed by a config reload mid-siege is picked up by the next siege.
+ */
+SiegeBotTravelPool& GetBotTravelPool(CityData const& city)
+{
+    std::unique_ptr<SiegeBotTravelPool>& pool = g_BotTravelPools[city.id];
+    if (pool)
+        return *pool;
+
+    pool = std::make_unique<SiegeBotTravelPool>();
+    pool->positions.reserve(city.waypoints.size());
+    pool->destinations.reserve(city.waypoints.size());
+    for (Waypoint const& wp : city.waypoints)
+    {
+        pool->positions.push_back(std::make_unique<WorldPosition>(city.mapId, wp.x, wp.y, wp.z, 0.0f));
+        pool->destinations.push_back(std::make_unique<TravelDestination>(0.0f, 5.0f));
+        pool->destinations.back()->addPoint(pool->positions.back().get());
+        g_BotTravelLiveObjects += 2;
+    }
 
-        ss << ":WP:" << city.waypoints.size();
-        for (const auto& wp : city.waypoints)
-            ss << ":" << std::fixed << std::setprecision(2) << wp.x << ":" << wp.y << ":" << wp.z;
+    if (g_DebugMode)
+    {
+        LOG_INFO("server.loading", "[City Siege] Built bot travel pool for {} ({} waypoints, {} objects live)",
+                 city.name, city.waypoints.size(), g_BotTravelLiveObjects);
+    }
 
-        auto appendCreaturePositions = [&](char const* section, std::vector<ObjectGuid> const& guids)
-        {
-            std::vector<std::array<float, 3>> positions;
-            positions.reserve(guids.size());
+    return *pool;
+}
 
-            for (ObjectGuid const& guid : guids)
-            {
-                if (Creature* creature = map->GetCreature(guid))
-                {
-                    if (!creature->IsAlive())
-                        continue;
+/**
+ * @brief Sends a bot toward a waypoint of its siege route using the city's pooled destination.
+ * @param travelTarget The bot's playerbots travel target.
+ * @param city The city being sieged.
+ * @param waypointIndex Index into the city's waypoints.
+ */
+void SetBotSiegeTravelTarget(TravelTarget* travelTarget, CityData const& city, size_t waypointIndex)
+{
+    SiegeBotTravelPool& pool = GetBotTravelPool(city);
+    if (waypointIndex >= pool.destinations.size())
+        return;
 
-                    positions.push_back({
-                        creature->GetPositionX(),
-                        creature->GetPositionY(),
-                        creature->GetPositionZ()
-                    });
-                }
-            }
+    travelTarget->setTarget(pool.destinations[waypointIndex].get(), pool.positions[waypointIndex].get());
+    travelTarget->setForced(true);
+}
 
-            ss << ":" << section << ":" << positions.size();
-            for (std::array<float, 3> const& position : positions)
-                ss << ":" << std::fixed << std::setprecision(2)
-                   << position[0] << ":" << position[1] << ":" << position[2];
-        };
+/**
+ * @brief Drops a bot's forced siege travel target so it no longer points into the city's pool.
+ * @param bot The bot leaving the siege.
+ */
+void ClearBotSiegeTravelTarget(Player* bot)
+{
+    PlayerbotAI* botAI = PlayerbotsMgr::instance().GetPlayerbotAI(bot);
+    if (!botAI)
+        return;
 
-        auto appendBotPositions = [&](char const* section, std::vector<ObjectGuid> const& guids)
-        {
-            std::vector<std::array<float, 3>> positions;
-            positions.reserve(guids.size());
+    TravelTarget* travelTarget = botAI->GetAiObjectContext()->GetValue<TravelTarget*>("travel target")->Get();
+    if (!travelTarget)
+        return;
 
-            for (ObjectGuid const& guid : guids)
-            {
-                if (Player* bot = ObjectAccessor::FindPlayer(guid))
-                {
-                    if (!bot->IsInWorld() || !bot->IsAlive())
-                        continue;
+    travelTarget->setTarget(TravelMgr::instance().nullTravelDestination, TravelMgr::instance().nullWorldPosition);
+    travelTarget->setForced(false);
+}
 
-                    positions.push_back({
-                        bot->GetPositionX(),
-                        bot->GetPositionY(),
-                        bot->GetPositionZ()
-                    });
-                }
-            }
+/**
+ * @brief Registers a siege as a user of its city's travel destination pool.
+ * @param cityId The city the siege started in.
+ */
+void AcquireBotTravelPool(CityId cityId)
+{
+    ++g_BotTravelPoolUsers[cityId];
+}
 
-            ss << ":" << section << ":" << positions.size();
-            for (std::array<float, 3> const& position : positions)
-                ss << ":" << std::fixed << std::setprecision(2)
-                   << position[0] << ":" << position[1] << ":" << position[2];
-        };
+/**
+ * @brief Drops a siege's use of its city's travel destination pool and frees the pool once no siege
+ * of the city is left, so bots of another siege of the same city keep valid targets.
+ * @param cityId The city whose siege ended.
+ */
+void ReleaseBotTravelPool(CityId cityId)
+{
+    if (g_BotTravelPoolUsers[cityId])
+        --g_BotTravelPoolUsers[cityId];
 
-        appendCreaturePositions("ATK", event.spawnedCreatures);
-        appendCreaturePositions("DEF", event.spawnedDefenders);
-        appendBotPositions("BATK", event.attackerBots);
-        appendBotPositions("BDEF", event.defenderBots);
-    }
-    else if (messageType == "END")
+    std::unique_ptr<SiegeBotTravelPool>& pool = g_BotTravelPools[cityId];
+    if (!pool || g_BotTravelPoolUsers[cityId])
+        return;
+
+    g_BotTravelLiveObjects -= pool->positions.size() + pool->destinations.size();
+
+    if (g_DebugMode)
     {
-        ss << "END:" << static_cast<uint32>(event.cityId) << ":" << winner;
+        LOG_INFO("server.loading", "[City Siege] Released bot travel pool for {} ({} destinations)",
+                 g_Cities[cityId].name, pool->destinations.size());
     }
 
-    SendAddonMessageToPlayer(player, ss.str());
+    pool.reset();
+}
+
+// Why a random bot cannot join a siege right now
+enum SiegeBotRejectReason : uint8
+{
+    SIEGE_BOT_ELIGIBLE = 0,
+    SIEGE_BOT_REJECT_OFFLINE,
+    SIEGE_BOT_REJECT_LEVEL,
+    SIEGE_BOT_REJECT_DEAD,
+    SIEGE_BOT_REJECT_COMBAT,
+    SIEGE_BOT_REJECT_INSTANCE,
+    SIEGE_BOT_REJECT_GROUPED, // Bots in a party or raid are usually alts, not free random bots
+    SIEGE_BOT_REJECT_MAX
+};
+
+/**
+ * @brief Checks whether a bot can be pulled into a siege.
+ * @param bot The bot to check.
+ * @return SIEGE_BOT_ELIGIBLE, or the first filter the bot fails.
+ */
+SiegeBotRejectReason GetBotRejectReason(Player* bot)
+{
+    if (!bot || !bot->IsInWorld())
+        return SIEGE_BOT_REJECT_OFFLINE;
+
+    if (bot->GetLevel() < g_PlayerbotsMinLevel)
+        return SIEGE_BOT_REJECT_LEVEL;
+
+    if (!bot->IsAlive())
+        return SIEGE_BOT_REJECT_DEAD;
+
+    if (bot->IsInCombat())
+        return SIEGE_BOT_REJECT_COMBAT;
+
+    if (bot->GetMap()->IsDungeon() || bot->GetMap()->IsBattleground())
+        return SIEGE_BOT_REJECT_INSTANCE;
+
+    if (bot->GetGroup())
+        return SIEGE_BOT_REJECT_GROUPED;
+
+    return SIEGE_BOT_ELIGIBLE;
 }
 
 /**
- * @brief Broadcasts siege data to clients via addon messages
- * @param event The siege event to broadcast
- * @param messageType Type of message (START, UPDATE, END, POSITION)
+ * @brief Saves a bot's position, PvP flag and RPG strategy, then teleports it to its side of the siege.
+ * @param city The city being sieged.
+ * @param event The siege event.
+ * @param bot The bot to teleport.
+ * @param isDefender Defenders go near the city leader (throne room), attackers to the siege spawn point.
  */
-void BroadcastSiegeDataToAddon(const SiegeEvent& event, const std::string& messageType,
-    const std::string& winner)
+void TeleportBotToSiege(CityData const& city, SiegeEvent& event, Player* bot, bool isDefender)
 {
-    // Send SILENTLY to ALL online players (addon users will intercept it)
-    std::shared_lock<std::shared_mutex> lock(*HashMapHolder<Player>::GetLock());
-    HashMapHolder<Player>::MapType const& players = ObjectAccessor::GetPlayers();
+    char const* side = isDefender ? "defender" : "attacker";
+
+    // Store original position and PvP status for return later
+    SiegeEvent::BotReturnPosition returnPos;
+    returnPos.botGuid = bot->GetGUID();
+    returnPos.mapId = bot->GetMapId();
+    returnPos.x = bot->GetPositionX();
+    returnPos.y = bot->GetPositionY();
+    returnPos.z = bot->GetPositionZ();
+    returnPos.o = bot->GetOrientation();
+    returnPos.wasPvPFlagged = bot->IsPvP(); // Store original PvP status
     
-    for (auto const& pair : players)
+    // Check for and store RPG strategy
+    PlayerbotAI* botAI = PlayerbotsMgr::instance().GetPlayerbotAI(bot);
+    if (botAI)
     {
-        if (Player* player = pair.second)
+        // Check for "rpg" or "new rpg" strategy
+        if (botAI->HasStrategy("new rpg", BOT_STATE_NON_COMBAT))
+        {
+            returnPos.rpgStrategy = "new rpg";
+            botAI->ChangeStrategy("-new rpg", BOT_STATE_NON_COMBAT); // Remove RPG strategy during siege
+            if (g_DebugMode)
+            {
+                LOG_INFO("server.loading", "[City Siege] Removed 'new rpg' strategy from {} bot {}", side, bot->GetName());
+            }
+        }
+        else if (botAI->HasStrategy("rpg", BOT_STATE_NON_COMBAT))
         {
-            if (player->IsInWorld())
-                SendSiegeDataToPlayer(player, event, messageType, winner);
+            returnPos.rpgStrategy = "rpg";
+            botAI->ChangeStrategy("-rpg", BOT_STATE_NON_COMBAT); // Remove RPG strategy during siege
+            if (g_DebugMode)
+            {
+                LOG_INFO("server.loading", "[City Siege] Removed 'rpg' strategy from {} bot {}", side, bot->GetName());
+            }
         }
     }
-}
-
-/**
- * @brief Sends map data (waypoints and leader position) to a player's addon
- * @param player The player to send data to
- * @param cityId The city ID
- */
-void SendMapDataToPlayer(Player* player, CityId cityId)
-{
-    if (!player || cityId >= CITY_MAX)
-        return;
-        
-    const CityData& city = g_Cities[cityId];
-    Map* map = sMapMgr->FindMap(city.mapId, 0);
-    if (!map)
-        return;
     
-    std::ostringstream ss;
+    event.botReturnPositions.push_back(returnPos);
     
-    // Format: MAP_DATA:cityID:WP:count:x:y:z...:LEADER:x:y:z
-    ss << "MAP_DATA:" << static_cast<uint32>(cityId);
+    // Randomize position within ~10 yards of the leader (defenders) or the spawn point (attackers)
+    float angle = frand(0.0f, 2.0f * M_PI);
+    float distance = frand(0.0f, 10.0f);
+    float x = (isDefender ? city.leaderX : city.spawnX) + distance * std::cos(angle);
+    float y = (isDefender ? city.leaderY : city.spawnY) + distance * std::sin(angle);
+    float z = isDefender ? city.leaderZ : city.spawnZ; // Will be adjusted by server
     
-    // Add waypoint data
-    ss << ":WP:" << city.waypoints.size();
-    for (const auto& wp : city.waypoints)
+    bot->TeleportTo(city.mapId, x, y, z, 0.0f);
+    (isDefender ? event.defenderBots : event.attackerBots).push_back(bot->GetGUID());
+    event.botSides[bot->GetGUID()] = isDefender;
+    ++event.recruitment.teleported;
+    
+    if (g_DebugMode)
     {
-        ss << ":" << std::fixed << std::setprecision(2) << wp.x << ":" << wp.y << ":" << wp.z;
+        LOG_INFO("server.loading", "[City Siege] Recruited {} bot {} (Level {}) for siege on {} at [{:.2f}, {:.2f}, {:.2f}] (will return to map {} at [{:.2f}, {:.2f}, {:.2f}])", 
+                 side, bot->GetName(), bot->GetLevel(), city.name, x, y, z, returnPos.mapId, returnPos.x, returnPos.y, returnPos.z);
     }
-    
-    // Add leader position
-    ss << ":LEADER:" << std::fixed << std::setprecision(2) 
-       << city.leaderX << ":" << city.leaderY << ":" << city.leaderZ;
-    
-    SendAddonMessageToPlayer(player, ss.str());
 }
+#endif
 
 /**
- * @brief Broadcasts position updates for siege participants
- * @param event The siege event
- * @param guid The GUID of the unit
- * @param x X coordinate
- * @param y Y coordinate  
- * @param z Z coordinate
- * @param unitType Type of unit (ATTACKER, DEFENDER, NPC)
+ * @brief Picks defending and attacking playerbots in a single pass over the random bots.
+ * The bots are only queued here; ProcessBotTeleportBatch brings them in batches spread over the RP phase.
+ * @param city The city being sieged.
+ * @param event The siege event.
  */
-void BroadcastPositionUpdate(const SiegeEvent& event, ObjectGuid guid, float x, float y, float z, const std::string& unitType)
+void RecruitSiegePlayerbots(CityData const& city, SiegeEvent& event)
 {
-    const CityData& city = g_Cities[event.cityId];
-    Map* map = sMapMgr->FindMap(city.mapId, 0);
-    if (!map)
+#ifdef MOD_PLAYERBOTS
+    if (!g_PlayerbotsEnabled)
+    {
         return;
-        
-    std::ostringstream ss;
-    ss << "POS:" << static_cast<uint32>(event.cityId) << ":" 
-       << guid.GetRawValue() << ":" 
-       << std::fixed << std::setprecision(2) << x << ":" << y << ":" << z 
-       << ":" << unitType;
-       
-    std::string message = ss.str();
-    std::string addonMessage = "CITYSIEGE_" + message;
+    }
+    
+    TeamId const defendingFaction = (city.id <= CITY_EXODAR) ? TEAM_ALLIANCE : TEAM_HORDE;
     
-    // Send to ALL online players with addon (no distance restriction)
-    std::shared_lock<std::shared_mutex> lock(*HashMapHolder<Player>::GetLock());
-    HashMapHolder<Player>::MapType const& players = ObjectAccessor::GetPlayers();
+    // Candidate index: eligible bots bucketed by faction, built in one scan
+    std::array<std::vector<Player*>, 2> candidates;
+    std::array<uint32, SIEGE_BOT_REJECT_MAX> rejections{};
     
-    for (auto const& pair : players)
+    auto allBots = sRandomPlayerbotMgr.GetAllBots();
+    for (auto& pair : allBots)
     {
-        if (Player* player = pair.second)
+        Player* bot = pair.second;
+        ++event.recruitment.scanned;
+        
+        SiegeBotRejectReason const reason = GetBotRejectReason(bot);
+        if (reason != SIEGE_BOT_ELIGIBLE)
         {
-            if (player->IsInWorld())
-            {
-                ChatHandler(player->GetSession()).PSendSysMessage(addonMessage.c_str());
-            }
+            ++rejections[reason];
+            continue;
         }
+        
+        TeamId const team = bot->GetTeamId();
+        if (team == TEAM_ALLIANCE || team == TEAM_HORDE)
+            candidates[team].push_back(bot);
     }
-}
-
-/**
- * @brief Spawns siege creatures for a city siege event.
- * @param event The siege event to spawn creatures for.
- */
-void SpawnSiegeCreatures(SiegeEvent& event)
-{
-    const CityData& city = g_Cities[event.cityId];
+    
+    event.recruitment.eligible = candidates[TEAM_ALLIANCE].size() + candidates[TEAM_HORDE].size();
+    for (uint32 count : rejections)
+        event.recruitment.rejected += count;
     
     if (g_DebugMode)
     {
-        LOG_INFO("server.loading", "[City Siege] Spawning creatures for siege at {}", city.name);
-        LOG_INFO("server.loading", "[City Siege]   Minions: {}", g_SpawnCountMinions);
-        LOG_INFO("server.loading", "[City Siege]   Elites: {}", g_SpawnCountElites);
-        LOG_INFO("server.loading", "[City Siege]   Mini-Bosses: {}", g_SpawnCountMiniBosses);
-        LOG_INFO("server.loading", "[City Siege]   Leaders: {}", g_SpawnCountLeaders);
+        LOG_INFO("server.loading", "[City Siege] Recruitment scan for {} - Total bots: {}, Offline: {}, Too low level: {}, Dead: {}, In combat: {}, In instance: {}, Grouped: {}, Eligible: {} Alliance / {} Horde", 
+                 city.name, event.recruitment.scanned, rejections[SIEGE_BOT_REJECT_OFFLINE], rejections[SIEGE_BOT_REJECT_LEVEL],
+                 rejections[SIEGE_BOT_REJECT_DEAD], rejections[SIEGE_BOT_REJECT_COMBAT], rejections[SIEGE_BOT_REJECT_INSTANCE],
+                 rejections[SIEGE_BOT_REJECT_GROUPED], candidates[TEAM_ALLIANCE].size(), candidates[TEAM_HORDE].size());
     }
-
-    Map* map = sMapMgr->FindMap(city.mapId, 0);
-    if (!map)
+    
+    // Shuffle and take up to the configured number of bots per side
+    std::random_device rd;
+    std::mt19937 g(rd());
+    std::vector<Player*>& defenders = candidates[defendingFaction];
+    std::vector<Player*>& attackers = candidates[defendingFaction == TEAM_ALLIANCE ? TEAM_HORDE : TEAM_ALLIANCE];
+    
+    if (defenders.size() > g_PlayerbotsMaxDefenders)
     {
-        LOG_ERROR("server.loading", "[City Siege] Failed to find map {} for {}", city.mapId, city.name);
-        return;
+        std::shuffle(defenders.begin(), defenders.end(), g);
+        defenders.resize(g_PlayerbotsMaxDefenders);
     }
-
-    // Define creature entries based on city faction
-    // If it's an Alliance city, spawn Horde attackers (and vice versa)
-    bool isAllianceCity = (event.cityId <= CITY_EXODAR);
-    
-    // Use configured creature entries - spawn OPPOSITE faction as attackers
-    uint32 minionEntry = isAllianceCity ? g_CreatureHordeMinion : g_CreatureAllianceMinion;
-    uint32 eliteEntry = isAllianceCity ? g_CreatureHordeElite : g_CreatureAllianceElite;
-    uint32 miniBossEntry = isAllianceCity ? g_CreatureHordeMiniBoss : g_CreatureAllianceMiniBoss;
     
-    // Randomly select a city leader from the opposing faction's leader pool
-    uint32 leaderEntry;
-    if (isAllianceCity)
+    if (attackers.size() > g_PlayerbotsMaxAttackers)
     {
-        // Horde attacking Alliance city - pick random Horde leader
-        uint32 randomIndex = urand(0, g_HordeCityLeaders.size() - 1);
-        leaderEntry = g_HordeCityLeaders[randomIndex];
-        
-        if (g_DebugMode)
-        {
-            LOG_INFO("server.loading", "[City Siege] Randomly selected Horde leader entry {} for attack on Alliance city {}", 
-                     leaderEntry, city.name);
-        }
+        std::shuffle(attackers.begin(), attackers.end(), g);
+        attackers.resize(g_PlayerbotsMaxAttackers);
     }
-    else
+    
+    // Alternate sides so both grow evenly while the batches come in
+    event.pendingBotTeleports.clear();
+    event.botTeleportCursor = 0;
+    for (size_t i = 0; i < std::max(defenders.size(), attackers.size()); ++i)
     {
-        // Alliance attacking Horde city - pick random Alliance leader
-        uint32 randomIndex = urand(0, g_AllianceCityLeaders.size() - 1);
-        leaderEntry = g_AllianceCityLeaders[randomIndex];
-        
-        if (g_DebugMode)
-        {
-            LOG_INFO("server.loading", "[City Siege] Randomly selected Alliance leader entry {} for attack on Horde city {}", 
-                     leaderEntry, city.name);
-        }
+        if (i < defenders.size())
+            event.pendingBotTeleports.push_back({ defenders[i]->GetGUID(), true });
+        if (i < attackers.size())
+            event.pendingBotTeleports.push_back({ attackers[i]->GetGUID(), false });
     }
     
-    // Military formation setup - organized ranks like a real army assault
-    // Leaders at center, mini-bosses forming command circle, elites in mid-rank, minions in outer perimeter
-    float baseRadius = 35.0f;
+    // Spread the batches over the first half of the RP phase, leaving the late ones time to arrive
+    uint32 const batchSize = g_PlayerbotsTeleportBatchSize ? g_PlayerbotsTeleportBatchSize : std::max<uint32>(1, event.pendingBotTeleports.size());
+    uint32 const batches = (event.pendingBotTeleports.size() + batchSize - 1) / batchSize;
+    event.botTeleportInterval = batches > 1 ? (g_CinematicDelay * 1000 / 2) / (batches - 1) : 0;
     
-    // === RANK 1: LEADERS (Center/Command Post) ===
-    // Leaders spawn at the very center in a tight formation
-    float leaderRadius = 3.0f;
-    float leaderAngleStep = (2 * M_PI) / std::max(1u, g_SpawnCountLeaders);
-    for (uint32 i = 0; i < g_SpawnCountLeaders; ++i)
-    {
-        float angle = leaderAngleStep * i;
-        float x = city.spawnX + leaderRadius * cos(angle);
-        float y = city.spawnY + leaderRadius * sin(angle);
-        float z = city.spawnZ;
-        
-        // Get proper ground height
-        float groundZ = map->GetHeight(x, y, z + 50.0f, true, 50.0f);
-        if (groundZ > INVALID_HEIGHT)
-            z = groundZ + 0.5f;
-        
-        if (Creature* creature = map->SummonCreature(leaderEntry, Position(x, y, z, 0)))
-        {
-            creature->SetLevel(g_LevelLeader);
-            creature->SetObjectScale(g_ScaleLeader);
-            creature->SetDisableGravity(false);
-            creature->SetCanFly(false);
-            creature->SetHover(false);
-            creature->RemoveUnitMovementFlag(MOVEMENTFLAG_CAN_FLY | MOVEMENTFLAG_DISABLE_GRAVITY | MOVEMENTFLAG_FLYING | MOVEMENTFLAG_SWIMMING | MOVEMENTFLAG_HOVER);
-            creature->SetReactState(REACT_PASSIVE);
-            creature->SetFaction(35); // Neutral during cinematic
-            creature->SetUnitFlag(UNIT_FLAG_NON_ATTACKABLE);
-            
-            // Prevent return to home position after combat
-            creature->SetWalk(false);
-            creature->GetMotionMaster()->Clear(false);
-            creature->GetMotionMaster()->MoveIdle();
-            
-            // Set home position to spawn location to prevent evading back
-            creature->SetHomePosition(x, y, z, 0.0f);
-            
-            // Enforce ground position immediately after spawn
-            creature->UpdateGroundPositionZ(x, y, z);
-            
-            event.spawnedCreatures.push_back(creature->GetGUID());
-            
-            // Parse leader spawn yells from configuration (semicolon separated for random selection)
-            std::vector<std::string> spawnYells;
-            std::string yellStr = g_YellLeaderSpawn;
-            size_t pos = 0;
-            while ((pos = yellStr.find(';')) != std::string::npos)
-            {
-                std::string yell = yellStr.substr(0, pos);
-                if (!yell.empty())
-                {
-                    spawnYells.push_back(yell);
-                }
-                yellStr.erase(0, pos + 1);
-            }
-            if (!yellStr.empty())
-            {
-                spawnYells.push_back(yellStr);
-            }
-            
-            // Yell a random spawn message
-            if (!spawnYells.empty() && creature->IsAlive())
-            {
-                uint32 randomIndex = urand(0, spawnYells.size() - 1);
-                creature->Yell(spawnYells[randomIndex].c_str(), LANG_UNIVERSAL);
-            }
-        }
+    if (g_DebugMode)
+    {
+        LOG_INFO("server.loading", "[City Siege] Queued {} defender and {} attacker bots for {} in {} batch(es), {} ms apart", 
+                 defenders.size(), attackers.size(), city.name, batches, event.botTeleportInterval);
     }
+#endif
+}
+
+/**
+ * @brief Teleports the next batch of recruited bots. Bots whose state changed since the recruitment
+ * pass (died, entered combat or an instance, logged out...) are dropped.
+ * @param event The siege event.
+ * @param flushAll Teleport everything still queued (used when combat begins).
+ */
+void ProcessBotTeleportBatch(SiegeEvent& event, bool flushAll = false)
+{
+#ifdef MOD_PLAYERBOTS
+    if (event.pendingBotTeleports.empty())
+        return;
 
-    // === RANK 2: MINI-BOSSES (Command Circle) ===
-    // Form a protective circle around the leaders
-    float miniBossRadius = baseRadius * 0.3f; // ~10.5 yards
-    float miniBossAngleStep = (2 * M_PI) / std::max(1u, g_SpawnCountMiniBosses);
-    for (uint32 i = 0; i < g_SpawnCountMiniBosses; ++i)
+    CityData const& city = g_Cities[event.cityId];
+    uint32 remaining = (flushAll || !g_PlayerbotsTeleportBatchSize) ? std::numeric_limits<uint32>::max() : g_PlayerbotsTeleportBatchSize;
+
+    while (remaining && event.botTeleportCursor < event.pendingBotTeleports.size())
     {
-        float angle = miniBossAngleStep * i;
-        float x = city.spawnX + miniBossRadius * cos(angle);
-        float y = city.spawnY + miniBossRadius * sin(angle);
-        float z = city.spawnZ;
-        
-        float groundZ = map->GetHeight(x, y, z + 50.0f, true, 50.0f);
-        if (groundZ > INVALID_HEIGHT)
-            z = groundZ + 0.5f;
-        
-        if (Creature* creature = map->SummonCreature(miniBossEntry, Position(x, y, z, 0)))
-        {
-            creature->SetLevel(g_LevelMiniBoss);
-            creature->SetObjectScale(g_ScaleMiniBoss);
-            creature->SetDisableGravity(false);
-            creature->SetCanFly(false);
-            creature->SetHover(false);
-            creature->RemoveUnitMovementFlag(MOVEMENTFLAG_CAN_FLY | MOVEMENTFLAG_DISABLE_GRAVITY | MOVEMENTFLAG_FLYING | MOVEMENTFLAG_SWIMMING | MOVEMENTFLAG_HOVER);
-            creature->SetReactState(REACT_PASSIVE);
-            creature->SetFaction(35); // Neutral during cinematic
-            creature->SetUnitFlag(UNIT_FLAG_NON_ATTACKABLE);
-            
-            // Prevent return to home position after combat
-            creature->SetWalk(false);
-            creature->GetMotionMaster()->Clear(false);
-            creature->GetMotionMaster()->MoveIdle();
-            
-            // Set home position to spawn location to prevent evading back
-            creature->SetHomePosition(x, y, z, 0);
-            
-            // Enforce ground position immediately after spawn
-            creature->UpdateGroundPositionZ(x, y, z);
-            
-            event.spawnedCreatures.push_back(creature->GetGUID());
+        SiegeEvent::PendingBotTeleport const pending = event.pendingBotTeleports[event.botTeleportCursor++];
+
+        Player* bot = ObjectAccessor::FindPlayer(pending.botGuid);
+        if (GetBotRejectReason(bot) != SIEGE_BOT_ELIGIBLE)
+        {
+            ++event.recruitment.rejected;
+            continue;
         }
+
+        TeleportBotToSiege(city, event, bot, pending.isDefender);
+        RecordSiegeReplay(event, CitySiegeReplay::EventType::BotRecruit,
+            pending.isDefender ? CitySiegeAPI::SiegeParticipantRole::Defender : CitySiegeAPI::SiegeParticipantRole::Attacker,
+            0, pending.botGuid.GetCounter());
+        --remaining;
     }
 
-    // === RANK 3: ELITES (Mid-Rank Officers) ===
-    // Form the middle rank in an organized formation
-    float eliteRadius = baseRadius * 0.6f; // ~21 yards
-    float eliteAngleStep = (2 * M_PI) / std::max(1u, g_SpawnCountElites);
-    for (uint32 i = 0; i < g_SpawnCountElites; ++i)
+    if (event.botTeleportCursor >= event.pendingBotTeleports.size())
     {
-        float angle = eliteAngleStep * i;
-        float x = city.spawnX + eliteRadius * cos(angle);
-        float y = city.spawnY + eliteRadius * sin(angle);
-        float z = city.spawnZ;
-        
-        float groundZ = map->GetHeight(x, y, z + 50.0f, true, 50.0f);
-        if (groundZ > INVALID_HEIGHT)
-            z = groundZ + 0.5f;
-        
-        if (Creature* creature = map->SummonCreature(eliteEntry, Position(x, y, z, 0)))
-        {
-            creature->SetLevel(g_LevelElite);
-            creature->SetDisableGravity(false);
-            creature->SetCanFly(false);
-            creature->SetHover(false);
-            creature->RemoveUnitMovementFlag(MOVEMENTFLAG_CAN_FLY | MOVEMENTFLAG_DISABLE_GRAVITY | MOVEMENTFLAG_FLYING | MOVEMENTFLAG_SWIMMING | MOVEMENTFLAG_HOVER);
-            creature->SetReactState(REACT_PASSIVE);
-            creature->SetFaction(35); // Neutral during cinematic
-            creature->SetUnitFlag(UNIT_FLAG_NON_ATTACKABLE);
-            
-            // Prevent return to home position after combat
-            creature->SetWalk(false);
-            creature->GetMotionMaster()->Clear(false);
-            creature->GetMotionMaster()->MoveIdle();
-            
-            // Set home position to spawn location to prevent evading back
-            creature->SetHomePosition(x, y, z, 0);
-            
-            // Enforce ground position immediately after spawn
-            creature->UpdateGroundPositionZ(x, y, z);
-            
-            event.spawnedCreatures.push_back(creature->GetGUID());
+        event.pendingBotTeleports.clear();
+        event.botTeleportCursor = 0;
+
+        if (g_DebugMode)
+        {
+            LOG_INFO("server.loading", "[City Siege] Bot recruitment for {} complete: {} defenders, {} attackers teleported, {} rejected", 
+                     city.name, event.defenderBots.size(), event.attackerBots.size(), event.recruitment.rejected);
         }
     }
+#endif
+}
 
-    // === RANK 4: MINIONS (Front Line / Outer Perimeter) ===
-    // Form the outer perimeter - the main fighting force
-    float minionRadius = baseRadius; // Full 35 yards
-    float minionAngleStep = (2 * M_PI) / std::max(1u, g_SpawnCountMinions);
-    for (uint32 i = 0; i < g_SpawnCountMinions; ++i)
+/**
+ * @brief Activates siege combat mode for playerbots
+ * @param event The siege event
+ * Puts bots into combat mode and gives them initial movement orders
+ */
+void ActivatePlayerbotsForSiege(SiegeEvent& event)
+{
+#ifdef MOD_PLAYERBOTS
+    if (!g_PlayerbotsEnabled)
     {
-        float angle = minionAngleStep * i;
-        float x = city.spawnX + minionRadius * cos(angle);
-        float y = city.spawnY + minionRadius * sin(angle);
-        float z = city.spawnZ;
-        
-        float groundZ = map->GetHeight(x, y, z + 50.0f, true, 50.0f);
-        if (groundZ > INVALID_HEIGHT)
-            z = groundZ + 0.5f;
-        
-        if (Creature* creature = map->SummonCreature(minionEntry, Position(x, y, z, 0)))
-        {
-            creature->SetLevel(g_LevelMinion);
-            creature->SetDisableGravity(false);
-            creature->SetCanFly(false);
-            creature->SetHover(false);
-            creature->RemoveUnitMovementFlag(MOVEMENTFLAG_CAN_FLY | MOVEMENTFLAG_DISABLE_GRAVITY | MOVEMENTFLAG_FLYING | MOVEMENTFLAG_SWIMMING | MOVEMENTFLAG_HOVER);
-            creature->SetReactState(REACT_PASSIVE);
-            creature->SetFaction(35); // Neutral during cinematic
-            creature->SetUnitFlag(UNIT_FLAG_NON_ATTACKABLE);
-            
-            // Prevent return to home position after combat
-            creature->SetWalk(false);
-            creature->GetMotionMaster()->Clear(false);
-            creature->GetMotionMaster()->MoveIdle();
-            
-            // Set home position to spawn location to prevent evading back
-            creature->SetHomePosition(x, y, z, 0);
-            creature->GetMotionMaster()->Clear(false);
-            creature->GetMotionMaster()->MoveIdle();
-            
-            // Enforce ground position immediately after spawn
-            creature->UpdateGroundPositionZ(x, y, z);
-            
-            event.spawnedCreatures.push_back(creature->GetGUID());
-            
-            if (g_DebugMode)
-            {
-                LOG_INFO("server.loading", "[City Siege] Spawned minion at ({}, {}, {})", x, y, z);
-            }
+        return;
+    }
+    
+    CityData const* city = nullptr;
+    for (auto& c : g_Cities)
+    {
+        if (c.id == event.cityId)
+        {
+            city = &c;
+            break;
         }
     }
-
-    LOG_INFO("server.loading", "[City Siege] Spawned {} total attacker creatures in military formation for siege at {}", 
-             event.spawnedCreatures.size(), city.name);
     
-    // === SPAWN DEFENDERS ===
-    // Defenders spawn near the leader and march towards the attackers (reverse waypoint order)
-    if (g_DefendersEnabled && g_DefendersCount > 0)
+    if (!city)
+        return;
+    
+    // Activate defender bots - move them toward spawn to intercept attackers
+    if (!city->waypoints.empty())
     {
-        // Determine defender entry based on city faction (same faction as city)
-        bool isAllianceCity = (event.cityId <= CITY_EXODAR);
-        uint32 defenderEntry = isAllianceCity ? g_CreatureAllianceDefender : g_CreatureHordeDefender;
-        
-        // Spawn defenders in a formation near the leader position
-        float defenderRadius = 10.0f; // Spawn in 10-yard radius around leader
-        float defenderAngleStep = (2 * M_PI) / std::max(1u, g_DefendersCount);
+        // Defenders start at leader and move backward along waypoints toward spawn
+        size_t defenderWaypoint = city->waypoints.size() - 1; // Start at last waypoint (near leader)
         
-        for (uint32 i = 0; i < g_DefendersCount; ++i)
+        for (const auto& botGuid : event.defenderBots)
         {
-            float angle = defenderAngleStep * i;
-            float x = city.leaderX + defenderRadius * cos(angle);
-            float y = city.leaderY + defenderRadius * sin(angle);
-            float z = city.leaderZ;
+            Player* bot = ObjectAccessor::FindPlayer(botGuid);
+            if (!bot || !bot->IsInWorld())
+                continue;
+                
+            PlayerbotAI* botAI = PlayerbotsMgr::instance().GetPlayerbotAI(bot);
+            if (!botAI)
+                continue;
             
-            float groundZ = map->GetHeight(x, y, z, true, 50.0f);
-            if (groundZ > INVALID_HEIGHT)
-                z = groundZ + 0.5f;
+            // Enable PvP mode for siege combat
+            bot->SetPvP(true);
+            
+            // Remove away status to ensure bot is active
+            bot->RemovePlayerFlag(PLAYER_FLAGS_AFK);
             
-            if (Creature* creature = map->SummonCreature(defenderEntry, Position(x, y, z, 0)))
+            // Enable PvP strategy so bots attack enemy players while traveling
+            if (!botAI->HasStrategy("pvp", BOT_STATE_NON_COMBAT))
             {
-                creature->SetLevel(g_LevelDefender);
-                creature->SetDisableGravity(false);
-                creature->SetCanFly(false);
-                creature->SetHover(false);
-                creature->RemoveUnitMovementFlag(MOVEMENTFLAG_CAN_FLY | MOVEMENTFLAG_DISABLE_GRAVITY | MOVEMENTFLAG_FLYING | MOVEMENTFLAG_SWIMMING | MOVEMENTFLAG_HOVER);
-                creature->SetReactState(REACT_PASSIVE);
-                creature->SetFaction(35); // Neutral during cinematic
-                creature->SetUnitFlag(UNIT_FLAG_NON_ATTACKABLE);
-                
-                // Prevent return to home position after combat
-                creature->SetWalk(false);
-                creature->GetMotionMaster()->Clear(false);
-                creature->GetMotionMaster()->MoveIdle();
-                
-                // Set home position to spawn location
-                creature->SetHomePosition(x, y, z, 0);
-                
-                // Enforce ground position immediately after spawn
-                creature->UpdateGroundPositionZ(x, y, z);
-                
-                event.spawnedDefenders.push_back(creature->GetGUID());
+                botAI->ChangeStrategy("+pvp", BOT_STATE_NON_COMBAT);
+            }
+            
+            // Initialize waypoint tracking for defenders
+            event.botWaypointProgress[botGuid] = defenderWaypoint;
+            
+            // Move bot toward a waypoint closer to spawn (backward movement) using playerbots travel system
+            if (defenderWaypoint > 0)
+            {
+                // Set travel destination using playerbots travel manager
+                TravelTarget* travelTarget = botAI->GetAiObjectContext()->GetValue<TravelTarget*>("travel target")->Get();
+                if (travelTarget)
+                    SetBotSiegeTravelTarget(travelTarget, *city, defenderWaypoint - 1);
                 
-                if (g_DebugMode)
+                // Enable travel strategy for proper pathfinding
+                if (!botAI->HasStrategy("travel", BOT_STATE_NON_COMBAT))
                 {
-                    LOG_INFO("server.loading", "[City Siege] Spawned defender at ({}, {}, {})", x, y, z);
+                    botAI->ChangeStrategy("+travel", BOT_STATE_NON_COMBAT);
                 }
             }
         }
-        
-        LOG_INFO("server.loading", "[City Siege] Spawned {} defender creatures for {}", 
-                 event.spawnedDefenders.size(), city.name);
     }
-}
-
-/**
- * @brief Despawns all creatures from a siege event.
- * @param event The siege event to clean up.
- */
-void DespawnSiegeCreatures(SiegeEvent& event)
-{
-    const CityData& city = g_Cities[event.cityId];
-    Map* map = sMapMgr->FindMap(city.mapId, 0);
     
-    if (map)
+    // Activate attacker bots - move them toward leader along waypoints
+    if (!city->waypoints.empty())
     {
-        for (const auto& guid : event.spawnedCreatures)
+        // Attackers start at spawn and move forward along waypoints toward leader
+        for (const auto& botGuid : event.attackerBots)
         {
-            if (Creature* creature = map->GetCreature(guid))
+            Player* bot = ObjectAccessor::FindPlayer(botGuid);
+            if (!bot || !bot->IsInWorld())
+                continue;
+                
+            PlayerbotAI* botAI = PlayerbotsMgr::instance().GetPlayerbotAI(bot);
+            if (!botAI)
+                continue;
+            
+            // Enable PvP mode for siege combat
+            bot->SetPvP(true);
+            
+            // Remove away status to ensure bot is active
+            bot->RemovePlayerFlag(PLAYER_FLAGS_AFK);
+            
+            // Enable PvP strategy so bots attack enemy players while traveling
+            if (!botAI->HasStrategy("pvp", BOT_STATE_NON_COMBAT))
             {
-                creature->DespawnOrUnsummon();
+                botAI->ChangeStrategy("+pvp", BOT_STATE_NON_COMBAT);
             }
-        }
-        
-        // Despawn defenders
-        for (const ObjectGuid& guid : event.spawnedDefenders)
-        {
-            if (Creature* creature = map->GetCreature(guid))
+            
+            // Initialize waypoint tracking for attackers (start at first waypoint)
+            event.botWaypointProgress[botGuid] = 0;
+            
+            // Move bot toward first waypoint using playerbots travel system
+            // Set travel destination using playerbots travel manager
+            TravelTarget* travelTarget = botAI->GetAiObjectContext()->GetValue<TravelTarget*>("travel target")->Get();
+            if (travelTarget)
+                SetBotSiegeTravelTarget(travelTarget, *city, 0);
+            
+            // Enable travel strategy for proper pathfinding
+            if (!botAI->HasStrategy("travel", BOT_STATE_NON_COMBAT))
             {
-                creature->DespawnOrUnsummon();
+                botAI->ChangeStrategy("+travel", BOT_STATE_NON_COMBAT);
             }
         }
     }
     
-    event.spawnedCreatures.clear();
-    event.spawnedDefenders.clear();
-
     if (g_DebugMode)
     {
-        LOG_INFO("server.loading", "[City Siege] Despawned attackers and defenders for siege at {}", city.name);
+        LOG_INFO("server.loading", "[City Siege] Activated {} defender and {} attacker bots for siege on {}",
+                 event.defenderBots.size(), event.attackerBots.size(), city->name);
     }
+#endif
 }
 
+#ifdef MOD_PLAYERBOTS
 /**
- * @brief Starts a new siege event in a random city.
- */
-/**
- * @brief Randomize a position within a radius to prevent creatures from bunching up.
- * @param x Original X coordinate
- * @param y Original Y coordinate
- * @param z Original Z coordinate (will be updated with proper ground height)
- * @param map Map to check ground height
- * @param radius Random radius (default 5.0 yards)
+ * @brief Takes a bot out of siege mode: resurrects it, restores its PvP flag and RPG strategy and teleports it back.
+ * @param bot The bot to return.
+ * @param returnPos The position and state saved when the bot was recruited.
+ * @return False if the bot could not be returned right now (instance or teleport in progress).
  */
-void RandomizePosition(float& x, float& y, float& z, Map* map, float radius = 5.0f)
+bool ReturnBotFromSiege(Player* bot, SiegeEvent::BotReturnPosition const& returnPos)
 {
-    // Generate random offset within radius
-    float angle = frand(0.0f, 2.0f * M_PI);
-    float dist = frand(0.0f, radius);
-    
-    x += dist * cos(angle);
-    y += dist * sin(angle);
-    
-    // Update Z to proper ground height
-    if (map)
-    {
-        float groundZ = map->GetHeight(x, y, z + 50.0f, true, 50.0f);
-        if (groundZ > INVALID_HEIGHT)
-            z = groundZ + 0.5f;
-    }
-}
+    // Released even if the bot cannot be moved, the pool its target points into is freed at teardown
+    ClearBotSiegeTravelTarget(bot);
 
-/**
- * @brief Validates and corrects ground position before movement to prevent floating/stuck units.
- * @param x X coordinate
- * @param y Y coordinate  
- * @param z Reference to Z coordinate to adjust
- * @param map Map to check ground height
- * @return true if position is valid, false if position is invalid/unreachable
- */
-bool ValidateGroundPosition(float x, float y, float& z, Map* map)
-{
-    if (!map)
-        return false;
+    if (!bot->IsAlive())
+    {
+        bot->ResurrectPlayer(1.0f);
+        bot->SpawnCorpseBones();
 
-    // Get ground height with generous search range
-    float groundZ = map->GetHeight(x, y, z + 100.0f, true, 100.0f);
+        if (g_DebugMode)
+        {
+            LOG_INFO("server.loading", "[City Siege] Resurrected bot {} before returning it from siege", bot->GetName());
+        }
+    }
     
-    // If ground height is invalid, try searching from below
-    if (groundZ <= INVALID_HEIGHT)
+    // Don't teleport if bot is in a dungeon, raid, arena, or battleground
+    if (bot->GetMap()->IsDungeon() || bot->GetMap()->IsRaid() || 
+        bot->GetMap()->IsBattleground() || bot->GetMap()->IsBattleArena())
     {
-        groundZ = map->GetHeight(x, y, z - 50.0f, true, 100.0f);
+        if (g_DebugMode)
+        {
+            LOG_INFO("server.loading", "[City Siege] Skipping return for bot {} - currently in instance/raid/arena/bg", 
+                     bot->GetName());
+        }
+        return false;
     }
     
-    // Still invalid - position is not reachable
-    if (groundZ <= INVALID_HEIGHT)
+    // Don't teleport if bot is being teleported or loading
+    if (bot->IsBeingTeleported())
     {
+        if (g_DebugMode)
+        {
+            LOG_INFO("server.loading", "[City Siege] Skipping return for bot {} - already being teleported", 
+                     bot->GetName());
+        }
         return false;
     }
     
-    // Clamp Z to be no more than 5 yards from ground (prevent high-altitude floating)
-    if (z > groundZ + 5.0f)
+    // Stop combat first
+    bot->CombatStop(true);
+    
+    // Restore original PvP flag status
+    bot->SetPvP(returnPos.wasPvPFlagged);
+    
+    // Restore RPG strategy if bot had one
+    if (!returnPos.rpgStrategy.empty())
     {
-        z = groundZ + 0.5f;
+        PlayerbotAI* botAI = PlayerbotsMgr::instance().GetPlayerbotAI(bot);
+        if (botAI)
+        {
+            botAI->ChangeStrategy("+" + returnPos.rpgStrategy, BOT_STATE_NON_COMBAT);
+            if (g_DebugMode)
+            {
+                LOG_INFO("server.loading", "[City Siege] Restored '{}' strategy to bot {}", 
+                         returnPos.rpgStrategy, bot->GetName());
+            }
+        }
     }
-    else if (z < groundZ - 2.0f)
+    
+    // Teleport back to original position
+    bot->TeleportTo(returnPos.mapId, returnPos.x, returnPos.y, returnPos.z, returnPos.o);
+    
+    if (g_DebugMode)
     {
-        // Too far below ground, raise to ground level
-        z = groundZ + 0.5f;
+        LOG_INFO("server.loading", "[City Siege] Returned bot {} to original location (map {} at [{:.2f}, {:.2f}, {:.2f}]) and restored PvP flag to {}", 
+                 bot->GetName(), returnPos.mapId, returnPos.x, returnPos.y, returnPos.z, returnPos.wasPvPFlagged ? "ON" : "OFF");
     }
-    
+
     return true;
 }
+#endif
 
 /**
- * @brief Recruits defending playerbots to teleport to the city being sieged
- * @param city The city structure containing position and faction info
- * @param event The siege event to store bot return positions
- * @return Vector of GUIDs of recruited defender bots
+ * @brief Deactivates siege combat mode for playerbots and releases them, a batch per call
+ * @param event The siege event; event.teardownCursor tracks progress across calls
+ * @param budget Tick budget; at least g_SchedulerMinUnitsPerSlice bots are returned per call
+ * Stops combat, teleports bots back to original locations, and releases all participating bots
+ * @return True once every bot has been returned
  */
-std::vector<ObjectGuid> RecruitDefendingPlayerbots(CityData const& city, SiegeEvent& event)
+bool DeactivatePlayerbotsFromSiege(SiegeEvent& event, SiegeTickBudget const& budget)
 {
-    std::vector<ObjectGuid> recruitedBots;
-    
 #ifdef MOD_PLAYERBOTS
     if (!g_PlayerbotsEnabled)
     {
-        return recruitedBots;
-    }
-    
-    // Get the defending faction for this city
-    TeamId defendingFaction = (city.id <= CITY_EXODAR) ? TEAM_ALLIANCE : TEAM_HORDE;
-    
-    if (g_DebugMode)
-    {
-        LOG_INFO("server.loading", "[City Siege] Recruiting defenders for {} - Need faction: {} ({})", 
-                 city.name, defendingFaction == TEAM_HORDE ? "HORDE" : "ALLIANCE", static_cast<int>(defendingFaction));
+        return true;
     }
     
-    // Get all playerbots from RandomPlayerbotMgr
-    auto allBots = sRandomPlayerbotMgr.GetAllBots();
-    std::vector<Player*> eligibleBots;
-    
-    uint32 totalBots = 0, wrongFaction = 0, tooLowLevel = 0, notAlive = 0, inCombat = 0, inInstance = 0;
-    
-    for (auto& pair : allBots)
+    SiegePerfTimer perfTimer(SIEGE_PERF_TEARDOWN_BOTS, &event.perf);
+
+    // Teleport bots back to their original positions
+    uint32 processed = 0;
+    while (event.teardownCursor < event.botReturnPositions.size())
     {
-        Player* bot = pair.second;
-        totalBots++;
-        
-        if (!bot || !bot->IsInWorld())
-            continue;
-            
-        // Check if bot is correct faction
-        if (bot->GetTeamId() != defendingFaction)
-        {
-            wrongFaction++;
-            continue;
-        }
-            
-        // Check level requirement
-        if (bot->GetLevel() < g_PlayerbotsMinLevel)
-        {
-            tooLowLevel++;
-            continue;
-        }
-            
-        // Check if alive
-        if (!bot->IsAlive())
-        {
-            notAlive++;
-            continue;
-        }
-            
-        // Check if not in combat
-        if (bot->IsInCombat())
-        {
-            inCombat++;
-            continue;
-        }
-            
-        // Check if not in instance/battleground
-        if (bot->GetMap()->IsDungeon() || bot->GetMap()->IsBattleground())
-        {
-            inInstance++;
+        if (processed >= g_SchedulerMinUnitsPerSlice && budget.Exhausted())
+            break;
+
+        SiegeEvent::BotReturnPosition const& returnPos = event.botReturnPositions[event.teardownCursor++];
+        ++processed;
+
+        Player* bot = ObjectAccessor::FindPlayer(returnPos.botGuid);
+        if (!bot)
             continue;
-        }
 
-        // Skip bots that are in a party or raid (we want free random bots, not alts)
-        if (Group* group = bot->GetGroup())
+        if (!bot->IsInWorld())
         {
-            // If the bot is in any group (party or raid), skip it
-            inInstance++; // reuse counter for grouped
+            ClearBotSiegeTravelTarget(bot);
             continue;
         }
-            
-        eligibleBots.push_back(bot);
+
+        ReturnBotFromSiege(bot, returnPos);
     }
+
+    perfTimer.AddItems(processed);
+    if (event.teardownCursor < event.botReturnPositions.size())
+        return false;
+    
+    // Clear all bot tracking data
+    event.defenderBots.clear();
+    event.attackerBots.clear();
+    event.botSides.clear();
+    event.botReturnPositions.clear();
     
     if (g_DebugMode)
     {
-        LOG_INFO("server.loading", "[City Siege] Defender recruitment stats - Total bots: {}, Wrong faction: {}, Too low level: {}, Dead: {}, In combat: {}, In instance: {}, Eligible: {}", 
-                 totalBots, wrongFaction, tooLowLevel, notAlive, inCombat, inInstance, eligibleBots.size());
+        LOG_INFO("server.loading", "[City Siege] Deactivated all playerbots from siege and returned them to original locations");
     }
-    
-    // Shuffle and take up to max defenders
-    if (eligibleBots.size() > g_PlayerbotsMaxDefenders)
+#else
+    (void)event;
+    (void)budget;
+#endif
+    return true;
+}
+
+// -----------------------------------------------------------------------------
+// SIEGE CHECKPOINTS
+// -----------------------------------------------------------------------------
+
+// Interrupted sieges with less time left than this are rolled back even when resuming is enabled
+static constexpr uint32 RECOVERY_MIN_RESUME_TIME = 120;
+
+/**
+ * @brief Writes checkpoints on a background thread so the world thread never waits on the disk.
+ * Only the newest snapshot is kept while the writer is busy, and snapshots equal to the previous one are skipped.
+ */
+class SiegeCheckpointWriter
+{
+public:
+    ~SiegeCheckpointWriter() { Stop(); }
+
+    void Start(std::string const& path)
     {
-        std::random_device rd;
-        std::mt19937 g(rd());
-        std::shuffle(eligibleBots.begin(), eligibleBots.end(), g);
-        eligibleBots.resize(g_PlayerbotsMaxDefenders);
+        Stop();
+        _path = path;
+        _stopping = false;
+        _thread = std::thread(&SiegeCheckpointWriter::Run, this);
     }
-    
-    // Store original positions and teleport bots to city center
-    for (Player* bot : eligibleBots)
-    {
-        // Store original position and PvP status for return later
-        SiegeEvent::BotReturnPosition returnPos;
-        returnPos.botGuid = bot->GetGUID();
-        returnPos.mapId = bot->GetMapId();
-        returnPos.x = bot->GetPositionX();
-        returnPos.y = bot->GetPositionY();
-        returnPos.z = bot->GetPositionZ();
-        returnPos.o = bot->GetOrientation();
-        returnPos.wasPvPFlagged = bot->IsPvP(); // Store original PvP status
-        
-        // Check for and store RPG strategy
-        PlayerbotAI* botAI = PlayerbotsMgr::instance().GetPlayerbotAI(bot);
-        if (botAI)
+
+    bool IsRunning() const { return _thread.joinable(); }
+
+    void Submit(std::string snapshot)
+    {
         {
-            // Check for "rpg" or "new rpg" strategy
-            if (botAI->HasStrategy("new rpg", BOT_STATE_NON_COMBAT))
-            {
-                returnPos.rpgStrategy = "new rpg";
-                botAI->ChangeStrategy("-new rpg", BOT_STATE_NON_COMBAT); // Remove RPG strategy during siege
-                if (g_DebugMode)
-                {
-                    LOG_INFO("server.loading", "[City Siege] Removed 'new rpg' strategy from defender bot {}", bot->GetName());
-                }
-            }
-            else if (botAI->HasStrategy("rpg", BOT_STATE_NON_COMBAT))
+            std::lock_guard<std::mutex> guard(_lock);
+            if (snapshot == _lastSubmitted)
+                return;
+
+            _lastSubmitted = snapshot;
+            _pending = std::move(snapshot);
+            _hasPending = true;
+        }
+        _wakeup.notify_one();
+    }
+
+    // Flushes the pending snapshot and joins the writer thread
+    void Stop()
+    {
+        if (!_thread.joinable())
+            return;
+
+        {
+            std::lock_guard<std::mutex> guard(_lock);
+            _stopping = true;
+        }
+        _wakeup.notify_one();
+        _thread.join();
+    }
+
+private:
+    void Run()
+    {
+        std::unique_lock<std::mutex> lock(_lock);
+        while (true)
+        {
+            _wakeup.wait(lock, [this] { return _hasPending || _stopping; });
+
+            if (_hasPending)
             {
-                returnPos.rpgStrategy = "rpg";
-                botAI->ChangeStrategy("-rpg", BOT_STATE_NON_COMBAT); // Remove RPG strategy during siege
-                if (g_DebugMode)
-                {
-                    LOG_INFO("server.loading", "[City Siege] Removed 'rpg' strategy from defender bot {}", bot->GetName());
-                }
+                std::string snapshot = std::move(_pending);
+                _hasPending = false;
+
+                lock.unlock();
+                WriteFile(snapshot);
+                lock.lock();
+                continue;
             }
-            else
+
+            return; // Stopping with nothing left to write
+        }
+    }
+
+    void WriteFile(std::string const& snapshot) const
+    {
+        // Write next to the checkpoint and swap it in, so a crash mid-write keeps the previous checkpoint intact
+        std::string const tempPath = _path + ".tmp";
+        {
+            std::ofstream out(tempPath, std::ios::trunc);
+            out << snapshot;
+            if (!out)
             {
-                returnPos.rpgStrategy = ""; // No RPG strategy active
+                LOG_ERROR("server.loading", "[City Siege] Could not write checkpoint file {}", tempPath);
+                return;
             }
         }
-        
-        event.botReturnPositions.push_back(returnPos);
-        
-        // Randomize position within ~10 yards of the leader
-        float angle = frand(0.0f, 2.0f * M_PI);
-        float distance = frand(0.0f, 10.0f);
-        float defenderX = city.leaderX + distance * std::cos(angle);
-        float defenderY = city.leaderY + distance * std::sin(angle);
-        float defenderZ = city.leaderZ; // Keep same Z as leader (will be adjusted by server)
-        
-        // Teleport to randomized position near city leader (throne room)
-        bot->TeleportTo(city.mapId, defenderX, defenderY, defenderZ, 0.0f);
-        recruitedBots.push_back(bot->GetGUID());
-        
-        if (g_DebugMode)
+
+        std::error_code error;
+        std::filesystem::rename(tempPath, _path, error);
+        if (error)
+            LOG_ERROR("server.loading", "[City Siege] Could not replace checkpoint file {}: {}", _path, error.message());
+    }
+
+    std::string _path;
+    std::thread _thread;
+    std::mutex _lock;
+    std::condition_variable _wakeup;
+    std::string _pending;
+    std::string _lastSubmitted;
+    bool _hasPending = false;
+    bool _stopping = false;
+};
+
+/**
+ * @brief A siege found in the checkpoint at startup, kept until its city leader can be checked.
+ */
+struct RecoveredSiege
+{
+    CityId cityId = CITY_STORMWIND;
+    uint32 startTime = 0;
+    uint32 endTime = 0;
+    bool cinematicPhase = false;
+    uint32 rpScriptIndex = 0;
+    uint32 attackers = 0;
+    uint32 defenders = 0;
+};
+
+static SiegeCheckpointWriter g_CheckpointWriter;
+static uint32 g_CheckpointElapsed = 0;
+static std::vector<RecoveredSiege> g_RecoveredSieges;
+
+// Bots of interrupted sieges, returned to their saved positions when they next log in
+static std::unordered_map<ObjectGuid, SiegeEvent::BotReturnPosition> g_PendingBotReturns;
+
+/**
+ * @brief Serializes everything needed to recover from a crash: the siege timer, every active (or still
+ * unresolved recovered) siege and the return positions of all bots that were pulled into a siege.
+ */
+std::string BuildSiegeCheckpoint()
+{
+    std::ostringstream out;
+    out << std::fixed << std::setprecision(2);
+    out << "CITYSIEGE_CHECKPOINT 1\n";
+    out << "NEXT " << g_NextSiegeTime << "\n";
+
+    auto writeBot = [&out](SiegeEvent::BotReturnPosition const& returnPos)
+    {
+        out << "BOT " << returnPos.botGuid.GetRawValue() << ' ' << returnPos.mapId << ' '
+            << returnPos.x << ' ' << returnPos.y << ' ' << returnPos.z << ' ' << returnPos.o << ' '
+            << (returnPos.wasPvPFlagged ? 1 : 0) << ' ' << returnPos.rpgStrategy << "\n";
+    };
+
+    for (SiegeEvent const& event : g_ActiveSieges)
+    {
+        if (!event.isActive)
         {
-            LOG_INFO("server.loading", "[City Siege] Recruited defender bot {} (Level {}) to {} near leader at [{:.2f}, {:.2f}, {:.2f}] (will return to map {} at [{:.2f}, {:.2f}, {:.2f}])", 
-                     bot->GetName(), bot->GetLevel(), city.name, defenderX, defenderY, defenderZ, returnPos.mapId, returnPos.x, returnPos.y, returnPos.z);
+            // Ended sieges still returning bots: the remaining ones are returned on their next login
+            if (event.teardownStage == SIEGE_TEARDOWN_BOTS)
+            {
+                for (size_t i = event.teardownCursor; i < event.botReturnPositions.size(); ++i)
+                    writeBot(event.botReturnPositions[i]);
+            }
+            continue;
         }
+
+        out << "SIEGE " << static_cast<uint32>(event.cityId) << ' ' << event.startTime << ' ' << event.endTime << ' '
+            << (event.cinematicPhase ? 1 : 0) << ' ' << event.rpScriptIndex << ' '
+            << event.spawnedCreatures.size() << ' ' << event.spawnedDefenders.size() << "\n";
+
+        for (SiegeEvent::BotReturnPosition const& returnPos : event.botReturnPositions)
+            writeBot(returnPos);
     }
-    
-    if (g_DebugMode && !recruitedBots.empty())
+
+    for (RecoveredSiege const& recovered : g_RecoveredSieges)
     {
-        LOG_INFO("server.loading", "[City Siege] Total {} defender bots recruited to {}", 
-                 recruitedBots.size(), city.name);
+        out << "SIEGE " << static_cast<uint32>(recovered.cityId) << ' ' << recovered.startTime << ' ' << recovered.endTime << ' '
+            << (recovered.cinematicPhase ? 1 : 0) << ' ' << recovered.rpScriptIndex << ' '
+            << recovered.attackers << ' ' << recovered.defenders << "\n";
     }
-#endif
-    
-    return recruitedBots;
+
+    for (auto const& [guid, returnPos] : g_PendingBotReturns)
+        writeBot(returnPos);
+
+    return out.str();
 }
 
 /**
- * @brief Recruits attacking playerbots to teleport to the spawn point
- * @param city The city structure containing spawn position
- * @param event The siege event to store bot return positions
- * @return Vector of GUIDs of recruited attacker bots
+ * @brief Reads the checkpoint left by the previous run. Sieges in it were interrupted by a crash;
+ * they are resumed or rolled back by ProcessSiegeRecovery once their city is loaded.
  */
-std::vector<ObjectGuid> RecruitAttackingPlayerbots(CityData const& city, SiegeEvent& event)
+void LoadSiegeCheckpoint()
 {
-    std::vector<ObjectGuid> recruitedBots;
-    
-#ifdef MOD_PLAYERBOTS
-    if (!g_PlayerbotsEnabled)
-    {
-        return recruitedBots;
-    }
-    
-    // Get the attacking faction (opposite of defending)
-    TeamId attackingFaction = (city.id <= CITY_EXODAR) ? TEAM_HORDE : TEAM_ALLIANCE;
-    
-    if (g_DebugMode)
+    std::ifstream in(g_RecoveryFile);
+    if (!in)
+        return;
+
+    std::string line;
+    if (!std::getline(in, line) || line != "CITYSIEGE_CHECKPOINT 1")
     {
-        LOG_INFO("server.loading", "[City Siege] Recruiting attackers for {} - Need faction: {} ({})", 
-                 city.name, attackingFaction == TEAM_HORDE ? "HORDE" : "ALLIANCE", static_cast<int>(attackingFaction));
+        LOG_ERROR("server.loading", "[City Siege] Ignoring checkpoint file {} with unknown format", g_RecoveryFile);
+        return;
     }
-    
-    // Get all playerbots from RandomPlayerbotMgr
-    auto allBots = sRandomPlayerbotMgr.GetAllBots();
-    std::vector<Player*> eligibleBots;
-    
-    uint32 totalBots = 0, wrongFaction = 0, tooLowLevel = 0, notAlive = 0, inCombat = 0, inInstance = 0;
-    
-    for (auto& pair : allBots)
+
+    uint32 const currentTime = time(nullptr);
+    while (std::getline(in, line))
     {
-        Player* bot = pair.second;
-        totalBots++;
-        
-        if (!bot || !bot->IsInWorld())
-            continue;
-            
-        // Check if bot is correct faction
-        if (bot->GetTeamId() != attackingFaction)
-        {
-            wrongFaction++;
-            continue;
-        }
-            
-        // Check level requirement
-        if (bot->GetLevel() < g_PlayerbotsMinLevel)
-        {
-            tooLowLevel++;
-            continue;
-        }
-            
-        // Check if alive
-        if (!bot->IsAlive())
-        {
-            notAlive++;
-            continue;
-        }
-            
-        // Check if not in combat
-        if (bot->IsInCombat())
+        std::istringstream fields(line);
+        std::string type;
+        fields >> type;
+
+        if (type == "NEXT")
         {
-            inCombat++;
-            continue;
+            uint32 nextSiegeTime = 0;
+            if (fields >> nextSiegeTime && nextSiegeTime > currentTime)
+                g_NextSiegeTime = nextSiegeTime;
         }
-            
-        // Check if not in instance/battleground
-        if (bot->GetMap()->IsDungeon() || bot->GetMap()->IsBattleground())
+        else if (type == "SIEGE")
         {
-            inInstance++;
-            continue;
+            RecoveredSiege recovered;
+            uint32 cityId = CITY_MAX;
+            fields >> cityId >> recovered.startTime >> recovered.endTime >> recovered.cinematicPhase
+                   >> recovered.rpScriptIndex >> recovered.attackers >> recovered.defenders;
+            if (!fields || cityId >= CITY_MAX)
+                continue;
+
+            recovered.cityId = static_cast<CityId>(cityId);
+            g_RecoveredSieges.push_back(recovered);
         }
-            
-        // Skip bots that are in a party or raid (avoid recruiting alts)
-        if (Group* group = bot->GetGroup())
+        else if (type == "BOT")
         {
-            inInstance++; // reuse counter for grouped
-            continue;
+            SiegeEvent::BotReturnPosition returnPos;
+            uint64 rawGuid = 0;
+            fields >> rawGuid >> returnPos.mapId >> returnPos.x >> returnPos.y >> returnPos.z >> returnPos.o >> returnPos.wasPvPFlagged;
+            if (!fields || !rawGuid)
+                continue;
+
+            // The strategy name is the rest of the line and may contain spaces ("new rpg")
+            fields >> std::ws;
+            std::getline(fields, returnPos.rpgStrategy);
+
+            returnPos.botGuid = ObjectGuid(rawGuid);
+            g_PendingBotReturns[returnPos.botGuid] = returnPos;
         }
-            
-        eligibleBots.push_back(bot);
     }
-    
-    if (g_DebugMode)
+
+    if (!g_RecoveredSieges.empty() || !g_PendingBotReturns.empty())
     {
-        LOG_INFO("server.loading", "[City Siege] Attacker recruitment stats - Total bots: {}, Wrong faction: {}, Too low level: {}, Dead: {}, In combat: {}, In instance: {}, Eligible: {}", 
-                 totalBots, wrongFaction, tooLowLevel, notAlive, inCombat, inInstance, eligibleBots.size());
+        LOG_INFO("server.loading", "[City Siege] Checkpoint found: {} interrupted siege(s) to {}, {} bot(s) to return",
+                 g_RecoveredSieges.size(), g_RecoveryResume ? "resume" : "roll back", g_PendingBotReturns.size());
     }
-    
-    // Shuffle and take up to max attackers
-    if (eligibleBots.size() > g_PlayerbotsMaxAttackers)
+}
+
+/**
+ * @brief Restarts an interrupted siege with its original end time and RP progress.
+ * Creatures are spawned fresh; if combat had already begun, the RP phase is skipped.
+ * @return True if the siege could be started again.
+ */
+bool ResumeRecoveredSiege(RecoveredSiege const& recovered)
+{
+    size_t const siegeCount = g_ActiveSieges.size();
+    StartSiegeEvent(recovered.cityId);
+    if (g_ActiveSieges.size() == siegeCount)
+        return false; // City disabled or another siege is running
+
+    SiegeEvent& event = g_ActiveSieges.back();
+    event.startTime = recovered.startTime;
+    event.cinematicStartTime = recovered.startTime;
+    event.endTime = recovered.endTime;
+    event.rpScriptIndex = std::min<uint32>(recovered.rpScriptIndex, event.activeRPScript.size());
+
+    if (!recovered.cinematicPhase)
     {
-        std::random_device rd;
-        std::mt19937 g(rd());
-        std::shuffle(eligibleBots.begin(), eligibleBots.end(), g);
-        eligibleBots.resize(g_PlayerbotsMaxAttackers);
+        event.countdown75Announced = true;
+        event.countdown50Announced = true;
+        event.countdown25Announced = true;
     }
-    
-    // Store original positions and teleport bots to spawn point (randomized within radius)
-    for (Player* bot : eligibleBots)
-    {
-        // Store original position and PvP status for return later
-        SiegeEvent::BotReturnPosition returnPos;
-        returnPos.botGuid = bot->GetGUID();
-        returnPos.mapId = bot->GetMapId();
-        returnPos.x = bot->GetPositionX();
-        returnPos.y = bot->GetPositionY();
-        returnPos.z = bot->GetPositionZ();
-        returnPos.o = bot->GetOrientation();
-        returnPos.wasPvPFlagged = bot->IsPvP(); // Store original PvP status
-        
-        // Check for and store RPG strategy
-        PlayerbotAI* botAI = PlayerbotsMgr::instance().GetPlayerbotAI(bot);
-        if (botAI)
+
+    return true;
+}
+
+/**
+ * @brief Resumes or rolls back sieges found in the checkpoint. A siege is only handled once its city
+ * leader is reachable, since a leader killed before the crash has to be respawned either way.
+ * Summoned creatures and weather overrides do not survive a restart, so there is nothing else to undo.
+ */
+void ProcessSiegeRecovery()
+{
+    uint32 const currentTime = time(nullptr);
+
+    for (auto itr = g_RecoveredSieges.begin(); itr != g_RecoveredSieges.end();)
+    {
+        CityData const& city = g_Cities[itr->cityId];
+        Map* map = sMapMgr->FindMap(city.mapId, 0);
+        Creature* leader = map ? FindCityLeaderInGrid(city, map, false) : nullptr;
+        if (!leader)
         {
-            // Check for "rpg" or "new rpg" strategy
-            if (botAI->HasStrategy("new rpg", BOT_STATE_NON_COMBAT))
-            {
-                returnPos.rpgStrategy = "new rpg";
-                botAI->ChangeStrategy("-new rpg", BOT_STATE_NON_COMBAT); // Remove RPG strategy during siege
-                if (g_DebugMode)
-                {
-                    LOG_INFO("server.loading", "[City Siege] Removed 'new rpg' strategy from attacker bot {}", bot->GetName());
-                }
-            }
-            else if (botAI->HasStrategy("rpg", BOT_STATE_NON_COMBAT))
-            {
-                returnPos.rpgStrategy = "rpg";
-                botAI->ChangeStrategy("-rpg", BOT_STATE_NON_COMBAT); // Remove RPG strategy during siege
-                if (g_DebugMode)
-                {
-                    LOG_INFO("server.loading", "[City Siege] Removed 'rpg' strategy from attacker bot {}", bot->GetName());
-                }
-            }
-            else
-            {
-                returnPos.rpgStrategy = ""; // No RPG strategy active
-            }
+            ++itr; // Map or leader grid not loaded yet, try again on the next checkpoint
+            continue;
         }
-        
-        event.botReturnPositions.push_back(returnPos);
-        
-        // Randomize position within ~10 yards of the spawn point
-        float angle = frand(0.0f, 2.0f * M_PI);
-        float distance = frand(0.0f, 10.0f);
-        float spawnX = city.spawnX + distance * std::cos(angle);
-        float spawnY = city.spawnY + distance * std::sin(angle);
-        float spawnZ = city.spawnZ; // Keep same Z as spawn (will be adjusted by server)
-        
-        // Teleport to randomized spawn point
-        bot->TeleportTo(city.mapId, spawnX, spawnY, spawnZ, 0.0f);
-        recruitedBots.push_back(bot->GetGUID());
-        
-        if (g_DebugMode)
+
+        if (!leader->IsAlive())
+            leader->Respawn();
+
+        bool const resume = g_RecoveryResume && g_CitySiegeEnabled &&
+            itr->endTime > currentTime + RECOVERY_MIN_RESUME_TIME;
+
+        if (resume && ResumeRecoveredSiege(*itr))
+        {
+            LOG_INFO("server.loading", "[City Siege] Resumed interrupted siege of {} ({} seconds left)",
+                     city.name, itr->endTime - currentTime);
+        }
+        else
         {
-            LOG_INFO("server.loading", "[City Siege] Recruited attacker bot {} (Level {}) for siege on {} at [{:.2f}, {:.2f}, {:.2f}] (will return to map {} at [{:.2f}, {:.2f}, {:.2f}])", 
-                     bot->GetName(), bot->GetLevel(), city.name, spawnX, spawnY, spawnZ, returnPos.mapId, returnPos.x, returnPos.y, returnPos.z);
+            LOG_INFO("server.loading", "[City Siege] Rolled back interrupted siege of {} ({} attackers, {} defenders lost)",
+                     city.name, itr->attackers, itr->defenders);
         }
+
+        itr = g_RecoveredSieges.erase(itr);
+        g_CheckpointRequested = true;
     }
-    
-    if (g_DebugMode && !recruitedBots.empty())
+}
+
+/**
+ * @brief Returns a bot to its saved position if its siege was interrupted by a crash.
+ * @param player The player that logged in.
+ */
+void ReturnRecoveredBot(Player* player)
+{
+    auto itr = g_PendingBotReturns.find(player->GetGUID());
+    if (itr == g_PendingBotReturns.end())
+        return;
+
+#ifdef MOD_PLAYERBOTS
+    if (ReturnBotFromSiege(player, itr->second))
     {
-        LOG_INFO("server.loading", "[City Siege] Total {} attacker bots recruited for siege on {}", 
-                 recruitedBots.size(), city.name);
+        LOG_INFO("server.loading", "[City Siege] Returned bot {} from an interrupted siege", player->GetName());
     }
 #endif
-    
-    return recruitedBots;
+
+    g_PendingBotReturns.erase(itr);
+    g_CheckpointRequested = true;
 }
 
 /**
- * @brief Activates siege combat mode for playerbots
- * @param event The siege event
- * Puts bots into combat mode and gives them initial movement orders
+ * @brief Runs recovery and hands a fresh checkpoint to the writer every checkpoint interval,
+ * or right away after a siege started or ended.
+ * @param diff Time since last update in milliseconds.
  */
-void ActivatePlayerbotsForSiege(SiegeEvent& event)
+void UpdateSiegeCheckpoints(uint32 diff)
 {
-#ifdef MOD_PLAYERBOTS
-    if (!g_PlayerbotsEnabled)
-    {
+    if (!g_RecoveryEnabled || !g_CheckpointWriter.IsRunning())
         return;
+
+    g_CheckpointElapsed += diff;
+    if (!g_CheckpointRequested && g_CheckpointElapsed < g_RecoveryCheckpointInterval)
+        return;
+
+    g_CheckpointElapsed = 0;
+    g_CheckpointRequested = false;
+
+    if (!g_RecoveredSieges.empty())
+        ProcessSiegeRecovery();
+
+    g_CheckpointWriter.Submit(BuildSiegeCheckpoint());
+}
+
+// -----------------------------------------------------------------------------
+// SIEGE REPLAYS
+// -----------------------------------------------------------------------------
+
+/**
+ * @brief Records drained from one siege's replay buffer, appended to its replay file by the writer thread.
+ */
+struct SiegeReplayChunk
+{
+    std::string path;
+    bool create = false; // First chunk of the siege: truncate the file and write the header
+    CitySiegeReplay::FileHeader header{};
+    std::vector<CitySiegeReplay::Record> records;
+};
+
+/**
+ * @brief Appends replay chunks to their files on a background thread, in the order they were submitted.
+ */
+class SiegeReplayWriter
+{
+public:
+    ~SiegeReplayWriter() { Stop(); }
+
+    void Start()
+    {
+        Stop();
+        _stopping = false;
+        _thread = std::thread(&SiegeReplayWriter::Run, this);
     }
-    
-    CityData const* city = nullptr;
-    for (auto& c : g_Cities)
+
+    bool IsRunning() const { return _thread.joinable(); }
+
+    void Submit(SiegeReplayChunk chunk)
     {
-        if (c.id == event.cityId)
         {
-            city = &c;
-            break;
+            std::lock_guard<std::mutex> guard(_lock);
+            _queue.push_back(std::move(chunk));
         }
+        _wakeup.notify_one();
     }
-    
-    if (!city)
-        return;
-    
-    // Activate defender bots - move them toward spawn to intercept attackers
-    if (!city->waypoints.empty())
+
+    // Writes every queued chunk and joins the writer thread
+    void Stop()
     {
-        // Defenders start at leader and move backward along waypoints toward spawn
-        size_t defenderWaypoint = city->waypoints.size() - 1; // Start at last waypoint (near leader)
-        
-        for (const auto& botGuid : event.defenderBots)
+        if (!_thread.joinable())
+            return;
+
         {
-            Player* bot = ObjectAccessor::FindPlayer(botGuid);
-            if (!bot || !bot->IsInWorld())
-                continue;
-                
-            PlayerbotAI* botAI = PlayerbotsMgr::instance().GetPlayerbotAI(bot);
-            if (!botAI)
-                continue;
-            
-            // Enable PvP mode for siege combat
-            bot->SetPvP(true);
-            
-            // Remove away status to ensure bot is active
-            bot->RemovePlayerFlag(PLAYER_FLAGS_AFK);
-            
-            // Enable PvP strategy so bots attack enemy players while traveling
-            if (!botAI->HasStrategy("pvp", BOT_STATE_NON_COMBAT))
-            {
-                botAI->ChangeStrategy("+pvp", BOT_STATE_NON_COMBAT);
-            }
-            
-            // Initialize waypoint tracking for defenders
-            event.creatureWaypointProgress[botGuid] = defenderWaypoint;
-            
-            // Move bot toward a waypoint closer to spawn (backward movement) using playerbots travel system
-            if (defenderWaypoint > 0)
-            {
-                const Waypoint& targetWP = city->waypoints[defenderWaypoint - 1];
-                
-                // Set travel destination using playerbots travel manager
-                TravelTarget* travelTarget = botAI->GetAiObjectContext()->GetValue<TravelTarget*>("travel target")->Get();
-                if (travelTarget)
-                {
-                    // Create destination position
-                    WorldPosition* destPos = new WorldPosition(city->mapId, targetWP.x, targetWP.y, targetWP.z, 0.0f);
-                    
-                    // Create a simple travel destination with 5 yard radius
-                    TravelDestination* siegeDest = new TravelDestination(0.0f, 5.0f);
-                    siegeDest->addPoint(destPos);
-                    
-                    // Set target with both destination and position
-                    travelTarget->setTarget(siegeDest, destPos);
-                    travelTarget->setForced(true);
-                }
-                
-                // Enable travel strategy for proper pathfinding
-                if (!botAI->HasStrategy("travel", BOT_STATE_NON_COMBAT))
-                {
-                    botAI->ChangeStrategy("+travel", BOT_STATE_NON_COMBAT);
-                }
-                
-                // if (g_DebugMode)
-                // {
-                //     LOG_INFO("server.loading", "[City Siege] Defender bot {} flagged for PvP and traveling to waypoint {} [{:.2f}, {:.2f}, {:.2f}]",
-                //              bot->GetName(), defenderWaypoint - 1, targetWP.x, targetWP.y, targetWP.z);
-                // }
-            }
+            std::lock_guard<std::mutex> guard(_lock);
+            _stopping = true;
         }
+        _wakeup.notify_one();
+        _thread.join();
     }
-    
-    // Activate attacker bots - move them toward leader along waypoints
-    if (!city->waypoints.empty())
+
+private:
+    void Run()
     {
-        // Attackers start at spawn and move forward along waypoints toward leader
-        for (const auto& botGuid : event.attackerBots)
+        std::unique_lock<std::mutex> lock(_lock);
+        while (true)
         {
-            Player* bot = ObjectAccessor::FindPlayer(botGuid);
-            if (!bot || !bot->IsInWorld())
-                continue;
-                
-            PlayerbotAI* botAI = PlayerbotsMgr::instance().GetPlayerbotAI(bot);
-            if (!botAI)
-                continue;
-            
-            // Enable PvP mode for siege combat
-            bot->SetPvP(true);
-            
-            // Remove away status to ensure bot is active
-            bot->RemovePlayerFlag(PLAYER_FLAGS_AFK);
-            
-            // Enable PvP strategy so bots attack enemy players while traveling
-            if (!botAI->HasStrategy("pvp", BOT_STATE_NON_COMBAT))
-            {
-                botAI->ChangeStrategy("+pvp", BOT_STATE_NON_COMBAT);
-            }
-            
-            // Initialize waypoint tracking for attackers (start at first waypoint)
-            event.creatureWaypointProgress[botGuid] = 0;
-            
-            // Move bot toward first waypoint using playerbots travel system
-            const Waypoint& targetWP = city->waypoints[0];
-            
-            // Set travel destination using playerbots travel manager
-            TravelTarget* travelTarget = botAI->GetAiObjectContext()->GetValue<TravelTarget*>("travel target")->Get();
-            if (travelTarget)
-            {
-                WorldPosition* destPos = new WorldPosition(city->mapId, targetWP.x, targetWP.y, targetWP.z, 0.0f);
-                
-                TravelDestination* siegeDest = new TravelDestination(0.0f, 5.0f);
-                siegeDest->addPoint(destPos);
-                
-                travelTarget->setTarget(siegeDest, destPos);
-                travelTarget->setForced(true);
-            }
-            
-            // Enable travel strategy for proper pathfinding
-            if (!botAI->HasStrategy("travel", BOT_STATE_NON_COMBAT))
+            _wakeup.wait(lock, [this] { return !_queue.empty() || _stopping; });
+
+            if (!_queue.empty())
             {
-                botAI->ChangeStrategy("+travel", BOT_STATE_NON_COMBAT);
+                SiegeReplayChunk chunk = std::move(_queue.front());
+                _queue.pop_front();
+
+                lock.unlock();
+                WriteChunk(chunk);
+                lock.lock();
+                continue;
             }
-            
-            // if (g_DebugMode)
-            // {
-            //     LOG_INFO("server.loading", "[City Siege] Attacker bot {} flagged for PvP and traveling to waypoint 0 [{:.2f}, {:.2f}, {:.2f}]",
-            //              bot->GetName(), targetWP.x, targetWP.y, targetWP.z);
-            // }
+
+            return; // Stopping with nothing left to write
         }
     }
-    
-    if (g_DebugMode)
+
+    void WriteChunk(SiegeReplayChunk const& chunk) const
     {
-        LOG_INFO("server.loading", "[City Siege] Activated {} defender and {} attacker bots for siege on {}",
-                 event.defenderBots.size(), event.attackerBots.size(), city->name);
+        std::ios::openmode mode = std::ios::binary | std::ios::out;
+        if (chunk.create)
+        {
+            std::error_code error;
+            std::filesystem::create_directories(std::filesystem::path(chunk.path).parent_path(), error);
+            mode |= std::ios::trunc;
+        }
+        else
+        {
+            mode |= std::ios::app;
+        }
+
+        std::ofstream out(chunk.path, mode);
+        if (chunk.create)
+            out.write(reinterpret_cast<char const*>(&chunk.header), sizeof(chunk.header));
+        if (!chunk.records.empty())
+            out.write(reinterpret_cast<char const*>(chunk.records.data()), chunk.records.size() * sizeof(CitySiegeReplay::Record));
+
+        if (!out)
+            LOG_ERROR("server.loading", "[City Siege] Could not write replay file {}", chunk.path);
     }
-#endif
+
+    std::thread _thread;
+    std::mutex _lock;
+    std::condition_variable _wakeup;
+    std::deque<SiegeReplayChunk> _queue;
+    bool _stopping = false;
+};
+
+static SiegeReplayWriter g_ReplayWriter;
+
+/**
+ * @brief Starts recording a siege if CitySiege.Replay.Enable is on. The file is named after the city and start time.
+ * @param event The siege that just started.
+ */
+void StartSiegeReplay(SiegeEvent& event)
+{
+    if (!g_ReplayEnabled)
+        return;
+
+    if (!g_ReplayWriter.IsRunning())
+        g_ReplayWriter.Start();
+
+    std::string cityName = g_Cities[event.cityId].name;
+    std::replace(cityName.begin(), cityName.end(), ' ', '_');
+
+    SiegeReplayBuffer& replay = event.replay;
+    replay.ring.assign(g_ReplayBufferSize, CitySiegeReplay::Record{});
+    replay.written = 0;
+    replay.drained = 0;
+    replay.dropped = 0;
+    replay.startTime = time(nullptr);
+    replay.start = std::chrono::steady_clock::now();
+    replay.path = g_ReplayDirectory + "/" + cityName + "_" + std::to_string(replay.startTime) + CitySiegeReplay::FILE_EXTENSION;
+    replay.headerWritten = false;
 }
 
 /**
- * @brief Deactivates siege combat mode for playerbots and releases them
- * @param event The siege event
- * Stops combat, teleports bots back to original locations, and releases all participating bots
+ * @brief Hands the buffered replay records of a siege to the writer thread.
+ * @param event The siege being recorded.
+ * @param final Stop recording after this flush (the siege is torn down).
  */
-void DeactivatePlayerbotsFromSiege(SiegeEvent& event)
+void FlushSiegeReplay(SiegeEvent& event, bool final)
 {
-#ifdef MOD_PLAYERBOTS
-    if (!g_PlayerbotsEnabled)
-    {
+    SiegeReplayBuffer& replay = event.replay;
+    if (!replay.IsRecording())
         return;
+
+    SiegeReplayChunk chunk;
+    chunk.path = replay.path;
+    chunk.create = !replay.headerWritten;
+    if (chunk.create)
+    {
+        std::copy(std::begin(CitySiegeReplay::FILE_MAGIC), std::end(CitySiegeReplay::FILE_MAGIC), chunk.header.magic);
+        chunk.header.version = CitySiegeReplay::FILE_VERSION;
+        chunk.header.recordSize = sizeof(CitySiegeReplay::Record);
+        chunk.header.cityId = static_cast<uint32>(event.cityId);
+        chunk.header.startTime = replay.startTime;
     }
-    
-    // Teleport all bots back to their original positions
-    for (const auto& returnPos : event.botReturnPositions)
+    replay.Drain(chunk.records);
+
+    if (chunk.create || !chunk.records.empty())
     {
-        Player* bot = ObjectAccessor::FindPlayer(returnPos.botGuid);
-        if (!bot || !bot->IsInWorld())
-            continue;
-            
-        if (!bot->IsAlive())
-        {
-            bot->ResurrectPlayer(1.0f);
-            bot->SpawnCorpseBones();
+        g_ReplayWriter.Submit(std::move(chunk));
+        replay.headerWritten = true;
+    }
 
-            if (g_DebugMode)
-            {
-                LOG_INFO("server.loading", "[City Siege] Resurrected bot {} before returning it from siege", bot->GetName());
-            }
-        }
-        
-        // Don't teleport if bot is in a dungeon, raid, arena, or battleground
-        if (bot->GetMap()->IsDungeon() || bot->GetMap()->IsRaid() || 
-            bot->GetMap()->IsBattleground() || bot->GetMap()->IsBattleArena())
-        {
-            if (g_DebugMode)
-            {
-                LOG_INFO("server.loading", "[City Siege] Skipping return for bot {} - currently in instance/raid/arena/bg", 
-                         bot->GetName());
-            }
-            continue;
-        }
-        
-        // Don't teleport if bot is being teleported or loading
-        if (bot->IsBeingTeleported())
-        {
-            if (g_DebugMode)
-            {
-                LOG_INFO("server.loading", "[City Siege] Skipping return for bot {} - already being teleported", 
-                         bot->GetName());
-            }
-            continue;
-        }
-        
-        // Stop combat first
-        bot->CombatStop(true);
-        
-        // Restore original PvP flag status
-        bot->SetPvP(returnPos.wasPvPFlagged);
-        
-        // Restore RPG strategy if bot had one
-        if (!returnPos.rpgStrategy.empty())
-        {
-            PlayerbotAI* botAI = PlayerbotsMgr::instance().GetPlayerbotAI(bot);
-            if (botAI)
-            {
-                botAI->ChangeStrategy("+" + returnPos.rpgStrategy, BOT_STATE_NON_COMBAT);
-                if (g_DebugMode)
-                {
-                    LOG_INFO("server.loading", "[City Siege] Restored '{}' strategy to bot {}", 
-                             returnPos.rpgStrategy, bot->GetName());
-                }
-            }
-        }
-        
-        // Teleport back to original position
-        bot->TeleportTo(returnPos.mapId, returnPos.x, returnPos.y, returnPos.z, returnPos.o);
-        
+    if (final)
+    {
         if (g_DebugMode)
         {
-            LOG_INFO("server.loading", "[City Siege] Returned bot {} to original location (map {} at [{:.2f}, {:.2f}, {:.2f}]) and restored PvP flag to {}", 
-                     bot->GetName(), returnPos.mapId, returnPos.x, returnPos.y, returnPos.z, returnPos.wasPvPFlagged ? "ON" : "OFF");
+            LOG_INFO("server.loading", "[City Siege] Replay of {} siege written to {} ({} records)",
+                     g_Cities[event.cityId].name, replay.path, replay.written);
         }
+
+        // Release the ring; the siege is no longer recorded
+        std::vector<CitySiegeReplay::Record>().swap(replay.ring);
     }
-    
-    // Clear all bot tracking data
-    event.defenderBots.clear();
-    event.attackerBots.clear();
-    event.botReturnPositions.clear();
-    
-    if (g_DebugMode)
-    {
-        LOG_INFO("server.loading", "[City Siege] Deactivated all playerbots from siege and returned them to original locations");
-    }
-#endif
 }
 
 /**
@@ -2228,6 +4908,15 @@ void StartSiegeEvent(int targetCityId = -1)
             }
             return;
         }
+
+        if (IsCityUnderSiege(city->id))
+        {
+            if (g_DebugMode)
+            {
+                LOG_INFO("server.loading", "[City Siege] Cannot start siege - {} is already under siege", city->name);
+            }
+            return;
+        }
     }
     else
     {
@@ -2259,30 +4948,27 @@ void StartSiegeEvent(int targetCityId = -1)
     newEvent.countdown25Announced = false;
     newEvent.rpScriptIndex = 0; // Start RP script at first line
     newEvent.weatherOverridden = false; // Initialize weather override flag
-    newEvent.lastAddonBroadcast = 0; // Initialize addon broadcast timer
+    newEvent.scheduler.Reset();
+    newEvent.scheduler.elapsed[SIEGE_SUBSYSTEM_BROADCAST] = g_SchedulerBroadcastInterval; // First addon UPDATE goes out on the next tick
+    newEvent.scheduler.elapsed[SIEGE_SUBSYSTEM_SUMMARY] = g_AddonSummaryInterval;
     
     // First, find and store the city leader's GUID and name
     Map* map = sMapMgr->FindMap(city->mapId, 0);
     if (map)
     {
-        std::list<Creature*> leaderList;
-        CitySiege::CreatureEntryCheck check(city->targetLeaderEntry);
-        CitySiege::SimpleCreatureListSearcher<CitySiege::CreatureEntryCheck> searcher(leaderList, check);
-        Cell::VisitObjects(city->leaderX, city->leaderY, map, searcher, 100.0f);
-        
-        for (Creature* leader : leaderList)
+        // Resolve the leader once; from here on the cached GUID plus the death/removal hooks track it
+        if (Creature* leader = FindCityLeaderInGrid(*city, map, true))
         {
-            if (leader && leader->IsAlive())
+            newEvent.cityLeaderGuid = leader->GetGUID();
+            newEvent.cityLeaderName = leader->GetName();
+
+            // First siege of this city: compile its route, using the leader for navmesh queries
+            GetSiegeRoute(*city, map, leader);
+            
+            if (g_DebugMode)
             {
-                newEvent.cityLeaderGuid = leader->GetGUID();
-                newEvent.cityLeaderName = leader->GetName();
-                
-                if (g_DebugMode)
-                {
-                    LOG_INFO("server.loading", "[City Siege] Found city leader: {} (Entry: {}, GUID: {})",
-                             leader->GetName(), city->targetLeaderEntry, leader->GetGUID().ToString());
-                }
-                break;
+                LOG_INFO("server.loading", "[City Siege] Found city leader: {} (Entry: {}, GUID: {})",
+                         leader->GetName(), city->targetLeaderEntry, leader->GetGUID().ToString());
             }
         }
         
@@ -2293,82 +4979,21 @@ void StartSiegeEvent(int targetCityId = -1)
         }
     }
     
-    // Now choose and process RP script with leader name replacement
+    // Now choose an RP script (compiled at config load) and render it with the leader and city names
     bool isAllianceCity = (city->id <= CITY_EXODAR);
-    std::string rpScriptsConfig = isAllianceCity ? g_RPScriptsHorde : g_RPScriptsAlliance;
-    
-    // Parse available scripts (pipe-separated)
-    std::vector<std::string> availableScripts;
-    std::string scriptsStr = rpScriptsConfig;
-    size_t pipePos = 0;
-    while ((pipePos = scriptsStr.find('|')) != std::string::npos)
-    {
-        std::string script = scriptsStr.substr(0, pipePos);
-        if (!script.empty())
-        {
-            availableScripts.push_back(script);
-        }
-        scriptsStr.erase(0, pipePos + 1);
-    }
-    if (!scriptsStr.empty())
-    {
-        availableScripts.push_back(scriptsStr);
-    }
+    std::vector<std::vector<SiegeTextTemplate>> const& availableScripts = isAllianceCity ? g_TextRPScriptsHorde : g_TextRPScriptsAlliance;
     
     // Pick a random script
     if (!availableScripts.empty())
     {
         uint32 randomScriptIndex = urand(0, availableScripts.size() - 1);
-        std::string chosenScript = availableScripts[randomScriptIndex];
-        
-        // Parse the chosen script into lines (semicolon-separated)
-        std::string lineStr = chosenScript;
-        size_t semiPos = 0;
-        while ((semiPos = lineStr.find(';')) != std::string::npos)
-        {
-            std::string line = lineStr.substr(0, semiPos);
-            if (!line.empty())
-            {
-                // Replace {LEADER} placeholder with actual leader name
-                size_t pos = 0;
-                while ((pos = line.find("{LEADER}", pos)) != std::string::npos)
-                {
-                    line.replace(pos, 8, newEvent.cityLeaderName.empty() ? "the leader" : newEvent.cityLeaderName);
-                    pos += newEvent.cityLeaderName.length();
-                }
-                
-                // Replace {CITY} placeholder with actual city name
-                pos = 0;
-                while ((pos = line.find("{CITY}", pos)) != std::string::npos)
-                {
-                    line.replace(pos, 6, city->name);
-                    pos += city->name.length();
-                }
-                
-                newEvent.activeRPScript.push_back(line);
-            }
-            lineStr.erase(0, semiPos + 1);
-        }
-        if (!lineStr.empty())
-        {
-            // Replace {LEADER} placeholder in last line
-            size_t pos = 0;
-            while ((pos = lineStr.find("{LEADER}", pos)) != std::string::npos)
-            {
-                lineStr.replace(pos, 8, newEvent.cityLeaderName.empty() ? "the leader" : newEvent.cityLeaderName);
-                pos += newEvent.cityLeaderName.length();
-            }
-            
-            // Replace {CITY} placeholder in last line
-            pos = 0;
-            while ((pos = lineStr.find("{CITY}", pos)) != std::string::npos)
-            {
-                lineStr.replace(pos, 6, city->name);
-                pos += city->name.length();
-            }
-            
-            newEvent.activeRPScript.push_back(lineStr);
-        }
+
+        SiegeTextArgs args;
+        args.city = city->name;
+        args.leader = newEvent.cityLeaderName.empty() ? std::string_view("the leader") : std::string_view(newEvent.cityLeaderName);
+
+        for (SiegeTextTemplate const& line : availableScripts[randomScriptIndex])
+            newEvent.activeRPScript.push_back(RenderSiegeText(line, args));
         
         if (g_DebugMode)
         {
@@ -2382,7 +5007,24 @@ void StartSiegeEvent(int targetCityId = -1)
     std::string preAnnounce = "|cffff0000[City Siege]|r |cffFFFF00WARNING!|r A siege force is preparing to attack " + city->name + "! The battle will begin in " + std::to_string(g_CinematicDelay) + " seconds. Defenders, prepare yourselves!";
     SendSiegeScopedMessage(*city, preAnnounce);
 
+    // Size the ledger for whoever could show up: the configured estimate or everyone already on the map
+    uint32 expectedContributors = g_ContributionExpectedPlayers;
+    if (map)
+        expectedContributors = std::max<uint32>(expectedContributors, map->GetPlayers().getSize());
+    if (g_ContributionEnabled)
+        newEvent.contributions.Reserve(expectedContributors);
     g_ActiveSieges.push_back(newEvent);
+    StartSiegeReplay(g_ActiveSieges.back());
+#ifdef MOD_PLAYERBOTS
+    AcquireBotTravelPool(city->id); // Released by the last teardown stage
+#endif
+
+    // Index the players around the city right away so the opening announcements already use the proximity grid
+    if (Map* map = sMapMgr->FindMap(city->mapId, 0))
+    {
+        SiegeMapWorld world(map);
+        RefreshSiegePlayerIndex(g_ActiveSieges.back(), world, *city, GetSiegeMapWorkSettings(), SiegeTickBudget(0));
+    }
 
     // Broadcast siege start to addons
     BroadcastSiegeDataToAddon(g_ActiveSieges.back(), "START");
@@ -2394,8 +5036,9 @@ void StartSiegeEvent(int targetCityId = -1)
     // Recruit playerbots if enabled
     if (g_PlayerbotsEnabled)
     {
-        g_ActiveSieges.back().defenderBots = RecruitDefendingPlayerbots(*city, g_ActiveSieges.back());
-        g_ActiveSieges.back().attackerBots = RecruitAttackingPlayerbots(*city, g_ActiveSieges.back());
+        // Pick bots in one pass; the first batch is teleported right away, the rest during the RP phase
+        RecruitSiegePlayerbots(*city, g_ActiveSieges.back());
+        ProcessBotTeleportBatch(g_ActiveSieges.back());
     }
 #endif
 
@@ -2409,17 +5052,8 @@ void StartSiegeEvent(int targetCityId = -1)
         if (map)
         {
             // Send music to players within announce radius
-            Map::PlayerList const& players = map->GetPlayers();
-            for (auto itr = players.begin(); itr != players.end(); ++itr)
-            {
-                if (Player* player = itr->GetSource())
-                {
-                    if (IsPlayerInAnnounceScope(player, *city))
-                    {
-                        player->SendDirectMessage(WorldPackets::Misc::PlayMusic(g_RPMusicId).Write());
-                    }
-                }
-            }
+            for (Player* player : GetPlayersInAnnounceScope(*city))
+                player->SendDirectMessage(WorldPackets::Misc::PlayMusic(g_RPMusicId).Write());
             
             if (g_DebugMode)
             {
@@ -2428,6 +5062,8 @@ void StartSiegeEvent(int targetCityId = -1)
         }
     }
 
+    g_CheckpointRequested = true;
+
     if (g_DebugMode)
     {
         LOG_INFO("server.loading", "[City Siege] Started siege event at {}", city->name);
@@ -2455,8 +5091,8 @@ void EndSiegeEvent(SiegeEvent& event, int winningTeam = -1)
     
     if (map && event.cityLeaderGuid)
     {
-        // Use the stored GUID to get the actual leader creature
-        Creature* cityLeader = map->GetCreature(event.cityLeaderGuid);
+        // Use the cached leader handle (falls back to a grid search if it went stale)
+        Creature* cityLeader = ResolveSiegeLeader(event, map);
         
         if (cityLeader && cityLeader->IsAlive())
         {
@@ -2505,270 +5141,544 @@ void EndSiegeEvent(SiegeEvent& event, int winningTeam = -1)
         {
             LOG_INFO("server.loading", "[City Siege] GM override: winningTeam = {}", winningTeam);
         }
-    }
+    }
+
+    int resolvedWinningTeam = defendersWon ? defendingTeam : attackingTeam;
+    std::string resolvedWinningFaction = GetTeamName(resolvedWinningTeam);
+
+    AnnounceSiege(city, false);
+
+    // Announce the winner (using same logic as AnnounceSiege)
+    std::string winnerAnnouncement;
+    if (defendersWon)
+    {
+        winnerAnnouncement = "|cff00ff00[City Siege]|r The " + resolvedWinningFaction + " has successfully defended " + city.name + "! Victory to the defenders!";
+    }
+    else
+    {
+        winnerAnnouncement = "|cffff0000[City Siege]|r The " + resolvedWinningFaction + " has conquered " + city.name + "! The city has fallen!";
+    }
+    
+    // Send announcement (same logic as AnnounceSiege)
+    SendSiegeScopedMessage(city, winnerAnnouncement);
+    
+    if (g_DebugMode)
+    {
+        LOG_INFO("server.loading", "[City Siege] {}", winnerAnnouncement);
+    }
+
+    // Play victory or defeat music if enabled
+    if (g_MusicEnabled)
+    {
+        Map* map = sMapMgr->FindMap(city.mapId, 0);
+        if (map)
+        {
+            if (defendersWon && g_VictoryMusicId > 0)
+            {
+                for (Player* player : GetPlayersInAnnounceScope(city))
+                    player->SendDirectMessage(WorldPackets::Misc::PlayMusic(g_VictoryMusicId).Write());
+                
+                if (g_DebugMode)
+                {
+                    LOG_INFO("server.loading", "[City Siege] Playing victory music (ID: {}) for defenders' victory at {}", g_VictoryMusicId, city.name);
+                }
+            }
+            else if (!defendersWon && g_DefeatMusicId > 0)
+            {
+                for (Player* player : GetPlayersInAnnounceScope(city))
+                    player->SendDirectMessage(WorldPackets::Misc::PlayMusic(g_DefeatMusicId).Write());
+                
+                if (g_DebugMode)
+                {
+                    LOG_INFO("server.loading", "[City Siege] Playing defeat music (ID: {}) for attackers' victory at {}", g_DefeatMusicId, city.name);
+                }
+            }
+        }
+    }
+
+    if (g_RewardOnDefense)
+        DistributeRewards(event, city, resolvedWinningTeam);
+
+    RecordSiegeReplay(event, CitySiegeReplay::EventType::End, CitySiegeAPI::SiegeParticipantRole::None,
+        static_cast<uint16>(resolvedWinningTeam), event.attackerDeaths, event.defenderDeaths);
+
+    FinalizeSiegeCleanup(event, resolvedWinningFaction);
+
+    if (g_DebugMode)
+    {
+        LOG_INFO("server.loading", "[City Siege] Ended siege event at {} - {} won", 
+                 city.name, defendersWon ? "Defenders" : "Attackers");
+    }
+}
+
+// ---------------------------------------------------------------------------
+// REWARD PAYOUTS
+// ---------------------------------------------------------------------------
+
+/**
+ * @brief One player's reward for one siege, computed when the siege ends.
+ * (cityId, siegeStartTime, playerGuid) identifies the payout in the city_siege_rewards journal.
+ */
+struct SiegeRewardPayout
+{
+    CityId cityId = CITY_STORMWIND;
+    uint32 siegeStartTime = 0;
+    ObjectGuid playerGuid;
+    uint32 honor = 0;
+    uint32 gold = 0;   // Copper
+    uint32 points = 0; // Contribution points
+    uint32 scale = 0;  // Percentage of the full reward, 0 = did not contribute enough (notice only)
+    bool defendingTeamWon = false;
+    bool journaled = false; // Its journal row exists; paying it also flags that row paid
+};
+
+/**
+ * @brief The payouts of one ended siege, paid in batches of CitySiege.Reward.BatchSize per world update.
+ */
+struct SiegeRewardJob
+{
+    std::vector<SiegeRewardPayout> payouts;
+    uint32 cursor = 0;          // Next payout to pay
+    bool journalPending = false; // True until the commit of the journal rows has reported back
+    uint32 paid = 0;
+};
+
+static std::deque<std::shared_ptr<SiegeRewardJob>> g_RewardJobs;
+// Payouts of players that were offline when their batch came up, paid when they log in
+static std::unordered_map<ObjectGuid, std::vector<SiegeRewardPayout>> g_OfflineRewards;
+// Journal transactions waiting for their commit result
+static AsyncCallbackProcessor<TransactionCallback> g_RewardJournalCallbacks;
+
+/**
+ * @brief The journal makes payouts survive a crash; it is kept along with the checkpoints (CitySiege.Recovery.Enable).
+ */
+bool IsRewardJournalEnabled()
+{
+    return g_RecoveryEnabled;
+}
+
+/**
+ * @brief Gives a player one payout and tells them about it.
+ * For journaled payouts the character's money and honor are saved together with the payout's paid flag
+ * in one transaction, so after a crash the payout is either in both the character and the journal or in neither.
+ * @param player The rewarded player, in world.
+ * @param payout The payout.
+ */
+void PaySiegeReward(Player* player, SiegeRewardPayout const& payout)
+{
+    CityData const& city = g_Cities[payout.cityId];
+
+    if (!payout.scale)
+    {
+        ChatHandler(player->GetSession()).PSendSysMessage(("|cffff0000[City Siege]|r You did not contribute enough to the siege of " + city.name +
+            " to earn a reward (" + std::to_string(payout.points) + "/" + std::to_string(g_RewardMinContribution) + " points).").c_str());
+        return;
+    }
+
+    if (payout.honor > 0)
+        player->RewardHonor(nullptr, 1, payout.honor);
+
+    if (payout.gold > 0)
+        player->ModifyMoney(payout.gold);
+
+    if (payout.journaled)
+    {
+        // Only the columns the reward changed; a full character save per payout costs far more than the reward itself
+        CharacterDatabaseTransaction trans = CharacterDatabase.BeginTransaction();
+        trans->Append("UPDATE characters SET money = {}, totalHonorPoints = {} WHERE guid = {}",
+            player->GetMoney(), player->GetHonorPoints(), player->GetGUID().GetCounter());
+        trans->Append("INSERT INTO city_siege_rewards (city, start_time, guid, honor, gold, points, scale, defended, paid) "
+            "VALUES ({}, {}, {}, {}, {}, {}, {}, {}, 1) ON DUPLICATE KEY UPDATE paid = 1",
+            static_cast<uint32>(payout.cityId), payout.siegeStartTime, payout.playerGuid.GetCounter(),
+            payout.honor, payout.gold, payout.points, payout.scale, payout.defendingTeamWon ? 1 : 0);
+        CharacterDatabase.CommitTransaction(trans);
+    }
+
+    // Send detailed confirmation message with rewards
+    uint32 goldCoins = payout.gold / 10000;
+    uint32 silverCoins = (payout.gold % 10000) / 100;
+    uint32 copperCoins = payout.gold % 100;
+
+    std::ostringstream rewardMessage;
+    SiegeTextArgs rewardArgs;
+    rewardArgs.city = city.name;
+    rewardArgs.action = payout.defendingTeamWon ? "defending" : "conquering";
+    rewardMessage << RenderSiegeText(g_TextReward, rewardArgs);
+
+    if (payout.honor > 0 || payout.gold > 0)
+        rewardMessage << " Received:";
+
+    if (payout.honor > 0)
+        rewardMessage << " |cffFFD700" << payout.honor << " Honor|r";
+
+    if (payout.gold > 0)
+    {
+        if (payout.honor > 0)
+            rewardMessage << " and";
+
+        rewardMessage << " |cffFFD700";
+        if (goldCoins > 0)
+            rewardMessage << goldCoins << "g ";
+        if (silverCoins > 0 || goldCoins > 0)
+            rewardMessage << silverCoins << "s ";
+        rewardMessage << copperCoins << "c|r";
+    }
+
+    if (g_ContributionEnabled)
+        rewardMessage << " (contribution: " << payout.points << " points, " << payout.scale << "% reward)";
+
+    ChatHandler(player->GetSession()).PSendSysMessage(rewardMessage.str().c_str());
+}
+
+/**
+ * @brief Queues the payouts of an ended siege. With the journal enabled, the unpaid payouts are written
+ * to city_siege_rewards first and paying starts once that commit succeeded.
+ * @param job The snapshot of the siege's payouts.
+ */
+void QueueSiegeRewardJob(std::shared_ptr<SiegeRewardJob> job)
+{
+    if (job->payouts.empty())
+        return;
+
+    if (IsRewardJournalEnabled())
+    {
+        CharacterDatabaseTransaction trans = CharacterDatabase.BeginTransaction();
+
+        // Multi-row inserts keep the statement count low with thousands of players in range
+        constexpr uint32 ROWS_PER_STATEMENT = 500;
+        std::ostringstream sql;
+        uint32 rows = 0;
+        for (SiegeRewardPayout const& payout : job->payouts)
+        {
+            if (!payout.scale)
+                continue; // Notices are not worth journaling
+
+            sql << (rows ? ", " : "INSERT IGNORE INTO city_siege_rewards (city, start_time, guid, honor, gold, points, scale, defended, paid) VALUES ")
+                << '(' << static_cast<uint32>(payout.cityId) << ", " << payout.siegeStartTime << ", " << payout.playerGuid.GetCounter() << ", "
+                << payout.honor << ", " << payout.gold << ", " << payout.points << ", " << payout.scale << ", "
+                << (payout.defendingTeamWon ? 1 : 0) << ", 0)";
+
+            if (++rows == ROWS_PER_STATEMENT)
+            {
+                trans->Append(sql.str());
+                sql.str("");
+                rows = 0;
+            }
+        }
 
-    int resolvedWinningTeam = defendersWon ? defendingTeam : attackingTeam;
-    std::string resolvedWinningFaction = GetTeamName(resolvedWinningTeam);
+        if (rows)
+            trans->Append(sql.str());
 
-    AnnounceSiege(city, false);
+        // Payouts are only paid through the journal if its rows were committed; otherwise (for example when
+        // city_siege_rewards is missing) the paid flag would roll back the character save along with it
+        job->journalPending = true;
+        g_RewardJournalCallbacks.AddCallback(CharacterDatabase.AsyncCommitTransaction(trans)).AfterComplete([job](bool success)
+        {
+            if (success)
+            {
+                for (SiegeRewardPayout& payout : job->payouts)
+                    payout.journaled = payout.scale != 0;
+            }
+            else
+                LOG_ERROR("server.loading", "[City Siege] Could not journal {} siege rewards, paying them without crash protection", job->payouts.size());
 
-    // Announce the winner (using same logic as AnnounceSiege)
-    std::string winnerAnnouncement;
-    if (defendersWon)
-    {
-        winnerAnnouncement = "|cff00ff00[City Siege]|r The " + resolvedWinningFaction + " has successfully defended " + city.name + "! Victory to the defenders!";
-    }
-    else
-    {
-        winnerAnnouncement = "|cffff0000[City Siege]|r The " + resolvedWinningFaction + " has conquered " + city.name + "! The city has fallen!";
-    }
-    
-    // Send announcement (same logic as AnnounceSiege)
-    SendSiegeScopedMessage(city, winnerAnnouncement);
-    
-    if (g_DebugMode)
-    {
-        LOG_INFO("server.loading", "[City Siege] {}", winnerAnnouncement);
+            job->journalPending = false;
+        });
     }
 
-    // Play victory or defeat music if enabled
-    if (g_MusicEnabled)
+    g_RewardJobs.push_back(std::move(job));
+}
+
+/**
+ * @brief Pays the next batch of queued siege rewards. Payouts of offline players are kept until they log in.
+ * @param flushAll Pay everything that is left (used on shutdown).
+ */
+void ProcessSiegeRewardJobs(bool flushAll = false)
+{
+    g_RewardJournalCallbacks.ProcessReadyCallbacks();
+
+    uint32 budget = flushAll ? std::numeric_limits<uint32>::max() : g_RewardBatchSize;
+    while (!g_RewardJobs.empty() && budget)
     {
-        Map* map = sMapMgr->FindMap(city.mapId, 0);
-        if (map)
+        SiegeRewardJob& job = *g_RewardJobs.front();
+        if (job.journalPending)
+            return; // Nothing is paid before the journal commit reported back
+
+        while (job.cursor < job.payouts.size() && budget)
         {
-            if (defendersWon && g_VictoryMusicId > 0)
-            {
-                Map::PlayerList const& players = map->GetPlayers();
-                for (auto itr = players.begin(); itr != players.end(); ++itr)
-                {
-                    if (Player* player = itr->GetSource())
-                    {
-                        if (IsPlayerInAnnounceScope(player, city))
-                        {
-                            player->SendDirectMessage(WorldPackets::Misc::PlayMusic(g_VictoryMusicId).Write());
-                        }
-                    }
-                }
-                
-                if (g_DebugMode)
-                {
-                    LOG_INFO("server.loading", "[City Siege] Playing victory music (ID: {}) for defenders' victory at {}", g_VictoryMusicId, city.name);
-                }
-            }
-            else if (!defendersWon && g_DefeatMusicId > 0)
+            SiegeRewardPayout const& payout = job.payouts[job.cursor++];
+            --budget;
+
+            Player* player = ObjectAccessor::FindPlayer(payout.playerGuid);
+            if (player && player->IsInWorld())
             {
-                Map::PlayerList const& players = map->GetPlayers();
-                for (auto itr = players.begin(); itr != players.end(); ++itr)
-                {
-                    if (Player* player = itr->GetSource())
-                    {
-                        if (IsPlayerInAnnounceScope(player, city))
-                        {
-                            player->SendDirectMessage(WorldPackets::Misc::PlayMusic(g_DefeatMusicId).Write());
-                        }
-                    }
-                }
-                
-                if (g_DebugMode)
-                {
-                    LOG_INFO("server.loading", "[City Siege] Playing defeat music (ID: {}) for attackers' victory at {}", g_DefeatMusicId, city.name);
-                }
+                PaySiegeReward(player, payout);
+                ++job.paid;
             }
+            else if (payout.scale)
+                g_OfflineRewards[payout.playerGuid].push_back(payout);
+        }
+
+        if (job.cursor < job.payouts.size())
+            return;
+
+        if (g_DebugMode)
+        {
+            LOG_INFO("server.loading", "[City Siege] Paid {} of {} siege rewards, {} players are offline",
+                     job.paid, job.payouts.size(), g_OfflineRewards.size());
         }
+
+        g_RewardJobs.pop_front();
     }
+}
 
-    if (g_RewardOnDefense)
-        DistributeRewards(event, city, resolvedWinningTeam);
+/**
+ * @brief Pays the siege rewards a player missed while offline.
+ * @param player The player that logged in.
+ */
+void PayOfflineSiegeRewards(Player* player)
+{
+    auto itr = g_OfflineRewards.find(player->GetGUID());
+    if (itr == g_OfflineRewards.end())
+        return;
 
-    FinalizeSiegeCleanup(event, resolvedWinningFaction);
+    for (SiegeRewardPayout const& payout : itr->second)
+        PaySiegeReward(player, payout);
 
-    if (g_DebugMode)
+    g_OfflineRewards.erase(itr);
+}
+
+/**
+ * @brief Reloads the payouts a crash or shutdown interrupted from the journal. Paid rows are pruned first;
+ * the remaining payouts are queued again and paid as their players come online.
+ */
+void LoadSiegeRewardJournal()
+{
+    CharacterDatabase.Execute("DELETE FROM city_siege_rewards WHERE paid = 1");
+
+    QueryResult result = CharacterDatabase.Query("SELECT city, start_time, guid, honor, gold, points, scale, defended FROM city_siege_rewards WHERE paid = 0");
+    if (!result)
+        return;
+
+    auto job = std::make_shared<SiegeRewardJob>();
+    do
     {
-        LOG_INFO("server.loading", "[City Siege] Ended siege event at {} - {} won", 
-                 city.name, defendersWon ? "Defenders" : "Attackers");
-    }
+        Field* fields = result->Fetch();
+        uint32 const cityId = fields[0].Get<uint32>();
+        if (cityId >= CITY_MAX)
+            continue;
+
+        SiegeRewardPayout payout;
+        payout.cityId = static_cast<CityId>(cityId);
+        payout.siegeStartTime = fields[1].Get<uint32>();
+        payout.playerGuid = ObjectGuid::Create<HighGuid::Player>(fields[2].Get<uint32>());
+        payout.honor = fields[3].Get<uint32>();
+        payout.gold = fields[4].Get<uint32>();
+        payout.points = fields[5].Get<uint32>();
+        payout.scale = fields[6].Get<uint32>();
+        payout.defendingTeamWon = fields[7].Get<uint8>() != 0;
+        payout.journaled = true;
+        job->payouts.push_back(payout);
+    } while (result->NextRow());
+
+    LOG_INFO("server.loading", "[City Siege] Reward journal: {} unpaid siege reward(s) from the previous run", job->payouts.size());
+    g_RewardJobs.push_back(std::move(job));
 }
 
 /**
- * @brief Distributes rewards to players who defended the city.
+ * @brief Snapshots the rewards of the winning side, scaled by their siege contribution, and queues them for payout.
+ * Players in the announce area are candidates, as well as contributors that left it but are still on the city's map.
  * @param event The siege event that ended.
  * @param city The city that was defended.
  * @param winningTeam The team ID to reward (0=Alliance, 1=Horde, -1=all players)
  */
-void DistributeRewards(const SiegeEvent& /*event*/, const CityData& city, int winningTeam)
+void DistributeRewards(const SiegeEvent& event, const CityData& city, int winningTeam)
 {
-    Map* map = sMapMgr->FindMap(city.mapId, 0);
-    if (!map)
+    std::vector<Player*> candidates = GetPlayersInAnnounceScope(city);
+    if (g_ContributionEnabled)
     {
-        return;
+        event.contributions.ForEach([&](ObjectGuid const& guid, SiegeContribution const& /*contribution*/)
+        {
+            Player* player = ObjectAccessor::FindPlayer(guid);
+            if (player && player->IsInWorld() && player->GetMapId() == city.mapId && !IsPlayerInAnnounceScope(player, city))
+                candidates.push_back(player);
+        });
     }
 
-    uint32 rewardedPlayers = 0;
-    Map::PlayerList const& players = map->GetPlayers();
-    
-    for (auto itr = players.begin(); itr != players.end(); ++itr)
+    auto job = std::make_shared<SiegeRewardJob>();
+    job->payouts.reserve(candidates.size());
+    bool const defendingTeamWon = (winningTeam == (IsAllianceCity(city.id) ? 0 : 1));
+
+    for (Player* player : candidates)
     {
-        if (Player* player = itr->GetSource())
+        // If winningTeam is specified, only reward players of that faction
+        if (winningTeam != -1 && player->GetTeamId() != winningTeam)
         {
-            // If winningTeam is specified, only reward players of that faction
-            if (winningTeam != -1 && player->GetTeamId() != winningTeam)
-            {
-                continue;
-            }
-            
-            // Check if player is in range and appropriate level
-            if (IsPlayerInAnnounceScope(player, city) &&
-                player->GetLevel() >= g_MinimumLevel)
-            {
-                uint32 honorAwarded = 0;
-                uint32 goldAwarded = 0;
-                bool defendingTeamWon = (winningTeam == (IsAllianceCity(city.id) ? 0 : 1));
-                const char* victoryAction = defendingTeamWon ? "defending" : "conquering";
-                
-                // Award honor
-                if (g_RewardHonor > 0)
-                {
-                    player->RewardHonor(nullptr, 1, g_RewardHonor);
-                    honorAwarded = g_RewardHonor;
-                }
-                
-                // Award gold scaled by player level
-                if (g_RewardGoldBase > 0 || g_RewardGoldPerLevel > 0)
-                {
-                    goldAwarded = g_RewardGoldBase + (g_RewardGoldPerLevel * player->GetLevel());
-                    player->ModifyMoney(goldAwarded);
-                }
-                
-                // Send detailed confirmation message with rewards
-                uint32 goldCoins = goldAwarded / 10000;
-                uint32 silverCoins = (goldAwarded % 10000) / 100;
-                uint32 copperCoins = goldAwarded % 100;
-
-                std::ostringstream rewardMessage;
-                rewardMessage << ReplacePlaceholder(
-                    ReplacePlaceholder(g_MessageReward, "{CITYNAME}", city.name),
-                    "{ACTION}", victoryAction);
+            continue;
+        }
+        
+        if (player->GetLevel() < g_MinimumLevel)
+            continue;
 
-                if (honorAwarded > 0 || goldAwarded > 0)
-                    rewardMessage << " Received:";
+        SiegeContribution const* contribution = event.contributions.Find(player->GetGUID());
 
-                if (honorAwarded > 0)
-                    rewardMessage << " |cffFFD700" << honorAwarded << " Honor|r";
+        SiegeRewardPayout payout;
+        payout.cityId = event.cityId;
+        payout.siegeStartTime = event.startTime;
+        payout.playerGuid = player->GetGUID();
+        payout.points = contribution ? GetContributionPoints(*contribution) : 0;
+        payout.scale = GetContributionRewardScale(payout.points);
+        payout.defendingTeamWon = defendingTeamWon;
 
-                if (goldAwarded > 0)
-                {
-                    if (honorAwarded > 0)
-                        rewardMessage << " and";
-
-                    rewardMessage << " |cffFFD700";
-                    if (goldCoins > 0)
-                        rewardMessage << goldCoins << "g ";
-                    if (silverCoins > 0 || goldCoins > 0)
-                        rewardMessage << silverCoins << "s ";
-                    rewardMessage << copperCoins << "c|r";
-                }
+        if (payout.scale)
+        {
+            payout.honor = g_RewardHonor * payout.scale / 100;
 
-                ChatHandler(player->GetSession()).PSendSysMessage(rewardMessage.str().c_str());
-                
-                rewardedPlayers++;
-            }
+            // Gold scaled by player level
+            if (g_RewardGoldBase > 0 || g_RewardGoldPerLevel > 0)
+                payout.gold = uint32(uint64(g_RewardGoldBase + (g_RewardGoldPerLevel * player->GetLevel())) * payout.scale / 100);
         }
+
+        job->payouts.push_back(payout);
     }
     
     if (g_DebugMode)
     {
-        LOG_INFO("server.loading", "[City Siege] Rewarded {} players for the siege of {}", 
-                 rewardedPlayers, city.name);
+        LOG_INFO("server.loading", "[City Siege] Queued rewards for {} players for the siege of {}", 
+                 job->payouts.size(), city.name);
+    }
+
+    QueueSiegeRewardJob(std::move(job));
+}
+
+/**
+ * @brief Finds the active siege running in a city.
+ * @return The siege event, or nullptr if the city is not under siege.
+ */
+SiegeEvent* GetActiveSiegeForCity(CityId cityId)
+{
+    for (SiegeEvent& event : g_ActiveSieges)
+    {
+        if (event.cityId == cityId && event.isActive)
+            return &event;
     }
+
+    return nullptr;
 }
 
-#ifdef MOD_PLAYERBOTS
 /**
- * @brief Checks for dead bots during siege and adds them to respawn queue
- * @param event The siege event
+ * @brief Handles the death of a siege creature: queues it for respawn and updates the death counters.
+ * Called from the unit death hook, so respawn timers start at the exact moment of death.
+ * @param creature The creature that died.
  */
-void CheckBotDeaths(SiegeEvent& event)
+void HandleSiegeCreatureDeath(Creature* creature, Unit* killer)
 {
-    if (!g_PlayerbotsEnabled)
-        return;
-        
-    uint32 currentTime = time(nullptr);
-    
-    // Check defender bots for deaths
-    for (const auto& botGuid : event.defenderBots)
+    ObjectGuid const guid = creature->GetGUID();
+
+    // The city leader is not a participant; its death decides the siege on the next win check.
+    // Sieges on other maps are skipped before reading their fields: their map threads may be writing them.
+    for (SiegeEvent& event : g_ActiveSieges)
     {
-        Player* bot = ObjectAccessor::FindPlayer(botGuid);
-        if (!bot || !bot->IsInWorld())
+        if (g_Cities[event.cityId].mapId != creature->GetMapId())
             continue;
-            
-        // If bot is dead and not already in respawn queue
-        if (!bot->IsAlive())
+
+        if (event.isActive && event.cityLeaderGuid == guid)
         {
-            // Check if already in respawn queue
-            bool alreadyQueued = false;
-            for (const auto& deadBot : event.deadBots)
-            {
-                if (deadBot.botGuid == botGuid)
-                {
-                    alreadyQueued = true;
-                    break;
-                }
-            }
-            
-            if (!alreadyQueued)
-            {
-                SiegeEvent::BotRespawnData respawnData;
-                respawnData.botGuid = botGuid;
-                respawnData.deathTime = currentTime;
-                respawnData.isDefender = true;
-                event.deadBots.push_back(respawnData);
-                
-                if (g_DebugMode)
-                {
-                    LOG_INFO("server.loading", "[City Siege] Defender bot {} died, will respawn in {} seconds",
-                             bot->GetName(), g_PlayerbotsRespawnDelay);
-                }
-            }
+            event.leaderDefeated = true;
+            CreditSiegeKill(event, killer);
+            return;
         }
     }
-    
-    // Check attacker bots for deaths
-    for (const auto& botGuid : event.attackerBots)
+
+    CityId cityId;
+    if (!FindParticipantCity(guid, cityId))
+        return;
+
+    SiegeEvent* event = GetActiveSiegeForCity(cityId);
+    if (!event)
+        return;
+
+    SiegeParticipant const* participant = FindSiegeParticipant(*event, guid);
+    if (!participant)
+        return;
+
+    bool const isDefender = participant->role == CitySiegeAPI::SiegeParticipantRole::Defender;
+    if (isDefender)
+        ++event->defenderDeaths;
+    else
+        ++event->attackerDeaths;
+
+    RecordSiegeReplay(*event, CitySiegeReplay::EventType::Death, participant->role, 0, guid.GetCounter(), creature->GetEntry(),
+        creature->GetPositionX(), creature->GetPositionY());
+
+    CreditSiegeKill(*event, killer);
+
+    LeaveSiegeSquad(*event, creature->GetMap(), guid);
+
+    if (!g_RespawnEnabled)
+        return;
+
+    uint32 const currentTime = time(nullptr);
+
+    SiegeEvent::RespawnData respawnData;
+    respawnData.guid = guid;
+    respawnData.entry = creature->GetEntry();
+    respawnData.deathTime = currentTime;
+    respawnData.isDefender = isDefender;
+
+    uint32 const respawnDelay = GetCreatureRespawnDelay(participant->tier);
+    if (event->deadCreatures.Push(guid, currentTime + respawnDelay, respawnData) && g_DebugMode)
     {
-        Player* bot = ObjectAccessor::FindPlayer(botGuid);
-        if (!bot || !bot->IsInWorld())
+        LOG_INFO("server.loading", "[City Siege] {} {} (entry {}) died, will respawn {} in {} seconds",
+                 isDefender ? "Defender" : "Attacker", guid.ToString(), respawnData.entry,
+                 isDefender ? "near leader position" : "at siege spawn point", respawnDelay);
+    }
+}
+
+#ifdef MOD_PLAYERBOTS
+/**
+ * @brief Handles the death of a playerbot: adds it to the respawn queue of its siege
+ * @param bot The player that died
+ */
+void HandleSiegeBotDeath(Player* bot, Unit* killer)
+{
+    if (!g_PlayerbotsEnabled)
+        return;
+
+    ObjectGuid const botGuid = bot->GetGUID();
+    for (SiegeEvent& event : g_ActiveSieges)
+    {
+        if (!event.isActive || g_Cities[event.cityId].mapId != bot->GetMapId())
             continue;
-            
-        // If bot is dead and not already in respawn queue
-        if (!bot->IsAlive())
+
+        auto sideItr = event.botSides.find(botGuid);
+        if (sideItr == event.botSides.end())
+            continue;
+
+        bool const isDefender = sideItr->second;
+        CreditSiegeKill(event, killer);
+
+        uint32 const currentTime = time(nullptr);
+
+        SiegeEvent::BotRespawnData respawnData;
+        respawnData.botGuid = botGuid;
+        respawnData.deathTime = currentTime;
+        respawnData.isDefender = isDefender;
+
+        if (event.deadBots.Push(botGuid, currentTime + g_PlayerbotsRespawnDelay, respawnData))
         {
-            // Check if already in respawn queue
-            bool alreadyQueued = false;
-            for (const auto& deadBot : event.deadBots)
-            {
-                if (deadBot.botGuid == botGuid)
-                {
-                    alreadyQueued = true;
-                    break;
-                }
-            }
-            
-            if (!alreadyQueued)
+            ++event.botDeaths;
+            RecordSiegeReplay(event, CitySiegeReplay::EventType::BotDeath,
+                isDefender ? CitySiegeAPI::SiegeParticipantRole::Defender : CitySiegeAPI::SiegeParticipantRole::Attacker,
+                0, botGuid.GetCounter(), 0, bot->GetPositionX(), bot->GetPositionY());
+
+            if (g_DebugMode)
             {
-                SiegeEvent::BotRespawnData respawnData;
-                respawnData.botGuid = botGuid;
-                respawnData.deathTime = currentTime;
-                respawnData.isDefender = false;
-                event.deadBots.push_back(respawnData);
-                
-                if (g_DebugMode)
-                {
-                    LOG_INFO("server.loading", "[City Siege] Attacker bot {} died, will respawn in {} seconds",
-                             bot->GetName(), g_PlayerbotsRespawnDelay);
-                }
+                LOG_INFO("server.loading", "[City Siege] {} bot {} died, will respawn in {} seconds",
+                         isDefender ? "Defender" : "Attacker", bot->GetName(), g_PlayerbotsRespawnDelay);
             }
         }
+        return;
     }
 }
 
@@ -2778,133 +5688,112 @@ void CheckBotDeaths(SiegeEvent& event)
  */
 void ProcessBotRespawns(SiegeEvent& event)
 {
-    if (!g_PlayerbotsEnabled || event.deadBots.empty())
+    if (!g_PlayerbotsEnabled || event.deadBots.Empty())
         return;
         
     uint32 currentTime = time(nullptr);
     const CityData& city = g_Cities[event.cityId];
     
-    // Process respawns (iterate backwards so we can safely erase)
-    for (auto it = event.deadBots.begin(); it != event.deadBots.end();)
+    // Process only the respawns that are due (the queue is ordered by due time)
+    std::vector<SiegeEvent::BotRespawnData> retry;
+    while (event.deadBots.HasDue(currentTime))
     {
-        if (currentTime - it->deathTime >= g_PlayerbotsRespawnDelay)
-        {
-            Player* bot = ObjectAccessor::FindPlayer(it->botGuid);
+        SiegeEvent::BotRespawnData const respawnData = event.deadBots.Pop();
+        Player* bot = ObjectAccessor::FindPlayer(respawnData.botGuid);
 
-            // If the Player object is not present or not in world anymore, keep the entry and try again later
-            if (!bot || !bot->IsInWorld())
-            {
-                ++it;
-                continue;
-            }
+        // If the Player object is not present or not in world anymore, keep the entry and try again later
+        if (!bot || !bot->IsInWorld())
+        {
+            retry.push_back(respawnData);
+            continue;
+        }
 
-            // Determine desired respawn position depending on faction
-            float desiredX, desiredY, desiredZ;
-            if (it->isDefender)
-            {
-                desiredX = city.leaderX;
-                desiredY = city.leaderY;
-                desiredZ = city.leaderZ;
-            }
-            else
-            {
-                desiredX = city.spawnX;
-                desiredY = city.spawnY;
-                desiredZ = city.spawnZ;
-            }
+        // Determine desired respawn position depending on faction
+        float desiredX, desiredY, desiredZ;
+        if (respawnData.isDefender)
+        {
+            desiredX = city.leaderX;
+            desiredY = city.leaderY;
+            desiredZ = city.leaderZ;
+        }
+        else
+        {
+            desiredX = city.spawnX;
+            desiredY = city.spawnY;
+            desiredZ = city.spawnZ;
+        }
 
-            // If bot is alive already, check whether it's at the correct location (not a graveyard)
-            if (bot->IsAlive())
-            {
-                float distToDesired = bot->GetDistance2d(desiredX, desiredY);
-                // If bot is already close to desired respawn location, consider it handled
-                if (distToDesired <= 15.0f)
-                {
-                    it = event.deadBots.erase(it);
-                    continue;
-                }
-                // Otherwise fall through and force-teleport/reissue movement so the bot goes to the siege spawn/leader
-            }
-            else
-            {
-                // Bot is dead: resurrect now
-                bot->ResurrectPlayer(1.0f); // Full health and mana
-                bot->SpawnCorpseBones();
-            }
+        // If bot is alive already, check whether it's at the correct location (not a graveyard)
+        if (bot->IsAlive())
+        {
+            float distToDesired = bot->GetDistance2d(desiredX, desiredY);
+            // If bot is already close to desired respawn location, consider it handled
+            if (distToDesired <= 15.0f)
+                continue;
+            // Otherwise fall through and force-teleport/reissue movement so the bot goes to the siege spawn/leader
+        }
+        else
+        {
+            // Bot is dead: resurrect now
+            bot->ResurrectPlayer(1.0f); // Full health and mana
+            bot->SpawnCorpseBones();
+        }
 
-            // Ensure bot is active and participating
-            bot->RemovePlayerFlag(PLAYER_FLAGS_AFK);
-            bot->SetPvP(true);
+        // Ensure bot is active and participating
+        bot->RemovePlayerFlag(PLAYER_FLAGS_AFK);
+        bot->SetPvP(true);
 
-            // Teleport to desired spawn/leader position with small randomization
-            float angle = frand(0.0f, 2.0f * M_PI);
-            float distance = frand(0.0f, 10.0f);
-            float respawnX = desiredX + distance * std::cos(angle);
-            float respawnY = desiredY + distance * std::sin(angle);
-            bot->TeleportTo(city.mapId, respawnX, respawnY, desiredZ, 0.0f);
+        // Teleport to desired spawn/leader position with small randomization
+        float angle = frand(0.0f, 2.0f * M_PI);
+        float distance = frand(0.0f, 10.0f);
+        float respawnX = desiredX + distance * std::cos(angle);
+        float respawnY = desiredY + distance * std::sin(angle);
+        bot->TeleportTo(city.mapId, respawnX, respawnY, desiredZ, 0.0f);
 
-            // Reinitialize waypoint/travel progress depending on defender/attacker
-            PlayerbotAI* botAI = PlayerbotsMgr::instance().GetPlayerbotAI(bot);
-            if (it->isDefender)
+        // Reinitialize waypoint/travel progress depending on defender/attacker
+        PlayerbotAI* botAI = PlayerbotsMgr::instance().GetPlayerbotAI(bot);
+        if (respawnData.isDefender)
+        {
+            if (!city.waypoints.empty())
             {
-                if (!city.waypoints.empty())
-                {
-                    size_t defenderWaypoint = city.waypoints.size() - 1;
-                    event.creatureWaypointProgress[it->botGuid] = defenderWaypoint;
+                size_t defenderWaypoint = city.waypoints.size() - 1;
+                event.botWaypointProgress[respawnData.botGuid] = defenderWaypoint;
 
-                    if (defenderWaypoint > 0 && botAI)
-                    {
-                        const Waypoint& targetWP = city.waypoints[defenderWaypoint - 1];
-                        TravelTarget* travelTarget = botAI->GetAiObjectContext()->GetValue<TravelTarget*>("travel target")->Get();
-                        if (travelTarget)
-                        {
-                            WorldPosition* destPos = new WorldPosition(city.mapId, targetWP.x, targetWP.y, targetWP.z, 0.0f);
-                            TravelDestination* siegeDest = new TravelDestination(0.0f, 5.0f);
-                            siegeDest->addPoint(destPos);
-                            travelTarget->setTarget(siegeDest, destPos);
-                            travelTarget->setForced(true);
-                        }
+                if (defenderWaypoint > 0 && botAI)
+                {
+                    TravelTarget* travelTarget = botAI->GetAiObjectContext()->GetValue<TravelTarget*>("travel target")->Get();
+                    if (travelTarget)
+                        SetBotSiegeTravelTarget(travelTarget, city, defenderWaypoint - 1);
 
-                        if (!botAI->HasStrategy("travel", BOT_STATE_NON_COMBAT))
-                            botAI->ChangeStrategy("+travel", BOT_STATE_NON_COMBAT);
-                    }
+                    if (!botAI->HasStrategy("travel", BOT_STATE_NON_COMBAT))
+                        botAI->ChangeStrategy("+travel", BOT_STATE_NON_COMBAT);
                 }
             }
-            else
+        }
+        else
+        {
+            if (!city.waypoints.empty())
             {
-                if (!city.waypoints.empty())
+                event.botWaypointProgress[respawnData.botGuid] = 0;
+                if (botAI)
                 {
-                    event.creatureWaypointProgress[it->botGuid] = 0;
-                    if (botAI)
-                    {
-                        const Waypoint& targetWP = city.waypoints[0];
-                        TravelTarget* travelTarget = botAI->GetAiObjectContext()->GetValue<TravelTarget*>("travel target")->Get();
-                        if (travelTarget)
-                        {
-                            WorldPosition* destPos = new WorldPosition(city.mapId, targetWP.x, targetWP.y, targetWP.z, 0.0f);
-                            TravelDestination* siegeDest = new TravelDestination(0.0f, 5.0f);
-                            siegeDest->addPoint(destPos);
-                            travelTarget->setTarget(siegeDest, destPos);
-                            travelTarget->setForced(true);
-                        }
+                    TravelTarget* travelTarget = botAI->GetAiObjectContext()->GetValue<TravelTarget*>("travel target")->Get();
+                    if (travelTarget)
+                        SetBotSiegeTravelTarget(travelTarget, city, 0);
 
-                        if (!botAI->HasStrategy("travel", BOT_STATE_NON_COMBAT))
-                            botAI->ChangeStrategy("+travel", BOT_STATE_NON_COMBAT);
-                    }
+                    if (!botAI->HasStrategy("travel", BOT_STATE_NON_COMBAT))
+                        botAI->ChangeStrategy("+travel", BOT_STATE_NON_COMBAT);
                 }
             }
-
-            // Put back into combat state
-            bot->SetInCombatState(true);
-
-            // Remove from respawn queue
-            it = event.deadBots.erase(it);
-        }
-        else
-        {
-            ++it;
         }
+
+        // Put back into combat state
+        bot->SetInCombatState(true);
     }
+
+    // Bots that were not in world are checked again on the next respawn pass
+    for (SiegeEvent::BotRespawnData const& respawnData : retry)
+        event.deadBots.Push(respawnData.botGuid, currentTime + 1, respawnData);
 }
 
 /**
@@ -2930,8 +5819,8 @@ void UpdateBotWaypointMovement(SiegeEvent& event)
             continue;
         
         // Check if bot has reached their waypoint
-        auto wpIter = event.creatureWaypointProgress.find(botGuid);
-        if (wpIter == event.creatureWaypointProgress.end())
+        auto wpIter = event.botWaypointProgress.find(botGuid);
+        if (wpIter == event.botWaypointProgress.end())
             continue;
         
         uint32 currentWP = wpIter->second;
@@ -2945,15 +5834,7 @@ void UpdateBotWaypointMovement(SiegeEvent& event)
             {
                 // For defenders: if not at spawn (waypoint 0) and not currently traveling, set next waypoint
                 if (currentWP > 0 && !travelTarget->isTraveling())
-                {
-                    const Waypoint& nextWP = city.waypoints[currentWP - 1];
-                    WorldPosition* destPos = new WorldPosition(city.mapId, nextWP.x, nextWP.y, nextWP.z, 0.0f);
-                    TravelDestination* siegeDest = new TravelDestination(0.0f, 5.0f);
-                    siegeDest->addPoint(destPos);
-                    travelTarget->setTarget(siegeDest, destPos);
-                    travelTarget->setForced(true);
-                    
-                }
+                    SetBotSiegeTravelTarget(travelTarget, city, currentWP - 1);
                 
                 // Check if bot reached current target waypoint by distance
                 if (currentWP > 0)
@@ -2966,19 +5847,12 @@ void UpdateBotWaypointMovement(SiegeEvent& event)
                     if (dist <= 10.0f)
                     {
                         currentWP--;
-                        event.creatureWaypointProgress[botGuid] = currentWP;
+                        event.botWaypointProgress[botGuid] = currentWP;
 
 
                         // Immediately set next waypoint if not at spawn
                         if (currentWP > 0)
-                        {
-                            const Waypoint& nextWP = city.waypoints[currentWP - 1];
-                            WorldPosition* destPos = new WorldPosition(city.mapId, nextWP.x, nextWP.y, nextWP.z, 0.0f);
-                            TravelDestination* siegeDest = new TravelDestination(0.0f, 5.0f);
-                            siegeDest->addPoint(destPos);
-                            travelTarget->setTarget(siegeDest, destPos);
-                            travelTarget->setForced(true);
-                        }
+                            SetBotSiegeTravelTarget(travelTarget, city, currentWP - 1);
                     }
                 }
             }
@@ -2993,8 +5867,8 @@ void UpdateBotWaypointMovement(SiegeEvent& event)
             continue;
         
         // Check if bot has reached their waypoint
-        auto wpIter = event.creatureWaypointProgress.find(botGuid);
-        if (wpIter == event.creatureWaypointProgress.end())
+        auto wpIter = event.botWaypointProgress.find(botGuid);
+        if (wpIter == event.botWaypointProgress.end())
             continue;
         
         uint32 currentWP = wpIter->second;
@@ -3008,14 +5882,7 @@ void UpdateBotWaypointMovement(SiegeEvent& event)
             {
                 // For attackers: if not at final waypoint and not currently traveling, set current waypoint
                 if (currentWP < city.waypoints.size() && !travelTarget->isTraveling())
-                {
-                    const Waypoint& currentWPData = city.waypoints[currentWP];
-                    WorldPosition* destPos = new WorldPosition(city.mapId, currentWPData.x, currentWPData.y, currentWPData.z, 0.0f);
-                    TravelDestination* siegeDest = new TravelDestination(0.0f, 5.0f);
-                    siegeDest->addPoint(destPos);
-                    travelTarget->setTarget(siegeDest, destPos);
-                    travelTarget->setForced(true);
-                }
+                    SetBotSiegeTravelTarget(travelTarget, city, currentWP);
                 
                 // Check if bot reached current target waypoint by distance
                 if (currentWP < city.waypoints.size())
@@ -3028,18 +5895,11 @@ void UpdateBotWaypointMovement(SiegeEvent& event)
                     if (dist <= 10.0f)
                     {
                         currentWP++;
-                        event.creatureWaypointProgress[botGuid] = currentWP;
+                        event.botWaypointProgress[botGuid] = currentWP;
 
                         // Immediately set next waypoint if not at leader yet
                         if (currentWP < city.waypoints.size())
-                        {
-                            const Waypoint& nextWP = city.waypoints[currentWP];
-                            WorldPosition* destPos = new WorldPosition(city.mapId, nextWP.x, nextWP.y, nextWP.z, 0.0f);
-                            TravelDestination* siegeDest = new TravelDestination(0.0f, 5.0f);
-                            siegeDest->addPoint(destPos);
-                            travelTarget->setTarget(siegeDest, destPos);
-                            travelTarget->setForced(true);
-                        }
+                            SetBotSiegeTravelTarget(travelTarget, city, currentWP);
                     }
                 }
             }
@@ -3048,31 +5908,264 @@ void UpdateBotWaypointMovement(SiegeEvent& event)
 }
 #endif
 
+/**
+ * @brief Dumps the global and per-siege perf histograms to the log every CitySiege.Perf.LogInterval seconds.
+ * @param diff Time since last update in milliseconds.
+ */
+void UpdateSiegePerfLog(uint32 diff)
+{
+    if (!g_PerfEnabled || !g_PerfLogInterval)
+        return;
+
+    g_PerfLogElapsed += diff;
+    if (g_PerfLogElapsed < g_PerfLogInterval * 1000)
+        return;
+
+    g_PerfLogElapsed = 0;
+    LogSiegePerfStats("global", g_PerfGlobal);
+    for (SiegeEvent const& event : g_ActiveSieges)
+    {
+        if (event.isActive)
+            LogSiegePerfStats(g_Cities[event.cityId].name, event.perf);
+    }
+}
+
+// ---------------------------------------------------------------------------
+// PARALLEL UPDATE
+// ---------------------------------------------------------------------------
+
+/**
+ * @brief Work a map update thread hands back to the world thread.
+ */
+enum SiegeWorldTaskType : uint8
+{
+    SIEGE_TASK_LEADER_DEFEATED = 0, // End the siege with an attacker victory
+};
+
+struct SiegeWorldTask
+{
+    SiegeWorldTaskType type;
+    CityId cityId;
+};
+
+// Filled by map update threads, drained by the world thread
+static MPSCQueue<SiegeWorldTask> g_SiegeWorldTasks;
+
+void QueueSiegeWorldTask(SiegeWorldTaskType type, CityId cityId)
+{
+    g_SiegeWorldTasks.Enqueue(new SiegeWorldTask{ type, cityId });
+}
+
+/**
+ * @brief Runs the world thread side of queued tasks: ending sieges, with their announcements and rewards.
+ */
+void ProcessSiegeWorldTasks()
+{
+    SiegeWorldTask* task = nullptr;
+    while (g_SiegeWorldTasks.Dequeue(task))
+    {
+        std::unique_ptr<SiegeWorldTask> const owned(task);
+
+        SiegeEvent* event = GetActiveSiegeForCity(task->cityId);
+        if (!event)
+            continue;
+
+        switch (task->type)
+        {
+            case SIEGE_TASK_LEADER_DEFEATED:
+            {
+                if (g_DebugMode)
+                {
+                    LOG_INFO("server.loading", "[City Siege] City leader has been killed! Attackers win the siege of {}!", g_Cities[task->cityId].name);
+                }
+
+                // Determine winning team (attackers = opposite of city faction)
+                int winningTeam = IsAllianceCity(task->cityId) ? 1 : 0; // Opposite faction wins
+                EndSiegeEvent(*event, winningTeam);
+                break;
+            }
+        }
+    }
+}
+
+Creature* SiegeMapWorld::RespawnUnit(SiegeEvent& event, SiegeParticipant& participant, SiegeEvent::RespawnData const& respawnData,
+    Waypoint const& position) const
+{
+    float spawnX = position.x;
+    float spawnY = position.y;
+    float spawnZ = position.z;
+
+    Creature* creature = _map->SummonCreature(respawnData.entry, Position(spawnX, spawnY, spawnZ, 0));
+    if (!creature)
+        return nullptr;
+
+    // Defenders fight for the city faction, attackers for the opposing one
+    ApplySiegeUnitProfile(creature, GetSiegeUnitProfile(participant.tier, participant.faction), true);
+    creature->UpdateGroundPositionZ(spawnX, spawnY, spawnZ);
+
+    // Set home position to spawn location to prevent evading back
+    creature->SetHomePosition(spawnX, spawnY, spawnZ, 0);
+
+    // Replace the old GUID with the new one in the participant registry and spawned list
+    ReplaceSiegeParticipant(event, respawnData.guid, creature->GetGUID());
+    RecordSiegeReplay(event, CitySiegeReplay::EventType::Respawn, participant.role, participant.tier,
+        creature->GetGUID().GetCounter(), respawnData.entry, spawnX, spawnY);
+
+    if (g_DebugMode)
+    {
+        LOG_INFO("server.loading", "[City Siege] Respawned {} {} at {} ({}, {}, {}), starting movement to {} waypoint",
+                 respawnData.isDefender ? "defender" : "attacker",
+                 creature->GetGUID().ToString(),
+                 respawnData.isDefender ? "leader position" : "siege spawn point",
+                 spawnX, spawnY, spawnZ,
+                 respawnData.isDefender ? "last" : "first");
+    }
+
+    return creature;
+}
+
+void SiegeMapWorld::OnWaypointReached(SiegeEvent& event, SiegeParticipant const& participant, Creature* creature) const
+{
+    RecordSiegeReplay(event, CitySiegeReplay::EventType::Waypoint, participant.role, participant.waypoint,
+        participant.guid.GetCounter(), creature->GetEntry(), creature->GetPositionX(), creature->GetPositionY());
+}
+
+void SiegeMapWorld::CreditPresence(SiegeEvent& event, ObjectGuid const& guid, uint32 ms) const
+{
+    Player* player = ObjectAccessor::GetPlayer(_map, guid);
+    if (player && player->IsAlive())
+        SiegeContribution::Add(event.contributions.Credit(guid).presenceMs, ms);
+}
+
+bool SiegeMapWorld::IsLeaderDefeated(SiegeEvent& event) const
+{
+    return IsSiegeLeaderDefeated(event, _map);
+}
+
+void SiegeMapWorld::OnLeaderDefeated(SiegeEvent& event) const
+{
+    QueueSiegeWorldTask(SIEGE_TASK_LEADER_DEFEATED, event.cityId);
+}
+
+void SiegeMapWorld::SampleLeaderHealth(SiegeEvent& event) const
+{
+    // The cached handle keeps this a single lookup
+    if (!event.replay.IsRecording() || !event.cityLeaderGuid)
+        return;
+
+    if (Creature* leader = _map->GetCreature(event.cityLeaderGuid))
+        RecordSiegeReplay(event, CitySiegeReplay::EventType::LeaderHealth, CitySiegeAPI::SiegeParticipantRole::None, 0,
+            leader->GetEntry(), static_cast<uint32>(leader->GetHealthPct() * 100.0f), leader->GetPositionX(), leader->GetPositionY());
+}
+
+SiegePerfTimer SiegeMapWorld::StartTimer(SiegeEvent& event, SiegeMapWorkPhase phase) const
+{
+    switch (phase)
+    {
+        case SIEGE_MAP_PHASE_RESPAWN:
+            return SiegePerfTimer(SIEGE_PERF_RESPAWN, &event.perf);
+        case SIEGE_MAP_PHASE_LEADER_CHECK:
+            return SiegePerfTimer(SIEGE_PERF_LEADER_CHECK, &event.perf);
+        default:
+            return SiegePerfTimer(SIEGE_PERF_MOVEMENT, &event.perf);
+    }
+}
+
+/**
+ * @brief Runs the creature side of a siege tick: army spawning, then RunSiegeMapWork (player refresh,
+ * movement pass, creature respawns and the leader check) on the siege's map.
+ * Only touches creatures on the siege's own map, so it may run on that map's update thread.
+ * Anything that needs the world thread is queued with QueueSiegeWorldTask.
+ * @param event The siege event to update.
+ * @param currentTime Current time in seconds.
+ * @param budget Movement budget shared by every siege updated on this thread this tick.
+ */
+void UpdateSiegeMapWork(SiegeEvent& event, uint32 currentTime, SiegeTickBudget const& budget)
+{
+    // Staggered spawning of the army; whatever is left halfway through the cinematic phase is spawned at once
+    if (event.cinematicPhase && event.spawnFormation)
+        ProcessSiegeSpawnJobs(event, currentTime >= event.cinematicStartTime + g_CinematicDelay / 2);
+
+    CityData const& city = g_Cities[event.cityId];
+    Map* map = sMapMgr->FindMap(city.mapId, 0);
+    if (!map)
+        return;
+
+    SiegeMapWorld world(map);
+    RunSiegeMapWork(event, world, city, GetSiegeMapWorkSettings(), currentTime, budget);
+}
+
+/**
+ * @brief Runs the creature work of every siege on a map from that map's update thread (CitySiege.Scheduler.ParallelUpdate).
+ * Sieges are partitioned by CityData::mapId, so each siege is only touched by one thread; the world thread
+ * only runs while the map updates are finished.
+ * @param map The map being updated.
+ */
+void UpdateSiegeMapEvents(Map* map)
+{
+    uint32 const currentTime = time(nullptr);
+    SiegeTickBudget budget(g_SchedulerTickBudget);
+
+    for (SiegeEvent& event : g_ActiveSieges)
+    {
+        if (event.isActive && g_Cities[event.cityId].mapId == map->GetId())
+            UpdateSiegeMapWork(event, currentTime, budget);
+    }
+}
+
 /**
  * @brief Updates all active siege events.
  * @param diff Time since last update in milliseconds.
  */
-void UpdateSiegeEvents(uint32 /*diff*/)
+void UpdateSiegeEvents(uint32 diff)
 {
+    SiegePerfTimer perfTimer(SIEGE_PERF_UPDATE);
     uint32 currentTime = time(nullptr);
 
+    // One budget is shared by every active siege so the total cost per world tick stays bounded
+    SiegeTickBudget budget(g_SchedulerTickBudget);
+
+    // Sieges whose leader fell during the map updates of this tick end first
+    ProcessSiegeWorldTasks();
+
     // Update active sieges
     for (auto& event : g_ActiveSieges)
     {
         if (!event.isActive)
         {
+            // Ended sieges tear down a budgeted step per tick
+            if (event.teardownStage != SIEGE_TEARDOWN_DONE && event.teardownStage != SIEGE_TEARDOWN_NONE)
+                ProcessSiegeTeardown(event, budget);
             continue;
         }
 
-        // Broadcast addon updates every 30 seconds (SILENTLY in background)
-        if ((currentTime - event.lastAddonBroadcast) >= 30)
+        event.scheduler.Advance(diff);
+
+        // Hand the replay buffer to the writer thread on its cadence, or early once it is half full
+        if (event.replay.IsRecording() &&
+            (event.scheduler.ConsumeIfDue(SIEGE_SUBSYSTEM_REPLAY, g_ReplayFlushInterval) || event.replay.Pending() >= event.replay.ring.size() / 2))
+            FlushSiegeReplay(event, false);
+
+        bool const yellsDue = event.scheduler.ConsumeIfDue(SIEGE_SUBSYSTEM_YELLS, g_SchedulerYellInterval);
+
+        // Broadcast addon updates on the broadcast cadence (SILENTLY in background)
+        if (event.scheduler.ConsumeIfDue(SIEGE_SUBSYSTEM_BROADCAST, g_SchedulerBroadcastInterval))
         {
-            event.lastAddonBroadcast = currentTime;
-            BroadcastSiegeDataToAddon(event, "UPDATE");
+            // Distant subscribers only get a summary every g_AddonSummaryInterval
+            bool const summaryDue = event.scheduler.ConsumeIfDue(SIEGE_SUBSYSTEM_SUMMARY, g_AddonSummaryInterval);
+            BroadcastSiegeDataToAddon(event, "UPDATE", "unknown", summaryDue);
+        }
+
+        // Recruited bots arrive in batches during the cinematic phase
+        if (event.cinematicPhase && !event.pendingBotTeleports.empty() &&
+            event.scheduler.ConsumeIfDue(SIEGE_SUBSYSTEM_RECRUIT, event.botTeleportInterval))
+        {
+            SiegePerfTimer botTimer(SIEGE_PERF_BOT_UPDATE, &event.perf);
+            ProcessBotTeleportBatch(event);
         }
 
         // Countdown announcements during cinematic phase (percentage-based)
-        if (event.cinematicPhase)
+        if (event.cinematicPhase && yellsDue)
         {
             const CityData& city = g_Cities[event.cityId];
             uint32 elapsed = currentTime - event.cinematicStartTime;
@@ -3112,1017 +6205,206 @@ void UpdateSiegeEvents(uint32 /*diff*/)
                     const CityData& city = g_Cities[event.cityId];
                     Map* map = sMapMgr->FindMap(city.mapId, 0);
                     if (map)
-                    {
-                        std::vector<Creature*> rpCreatures;
-                        for (const auto& guid : event.spawnedCreatures)
-                        {
-                            if (Creature* creature = map->GetCreature(guid))
-                            {
-                                uint32 entry = creature->GetEntry();
-                                // Only leaders and mini-bosses do RP - check if entry is in leader pools or is a mini-boss
-                                bool isLeader = (std::find(g_AllianceCityLeaders.begin(), g_AllianceCityLeaders.end(), entry) != g_AllianceCityLeaders.end()) ||
-                                               (std::find(g_HordeCityLeaders.begin(), g_HordeCityLeaders.end(), entry) != g_HordeCityLeaders.end());
-                                bool isMiniBoss = (entry == g_CreatureAllianceMiniBoss || entry == g_CreatureHordeMiniBoss);
-                                
-                                if (creature->IsAlive() && (isLeader || isMiniBoss))
-                                {
-                                    rpCreatures.push_back(creature);
-                                }
-                            }
-                        }
-                        
-                        if (!rpCreatures.empty())
-                        {
-                            // Pick a random creature to say the current line
-                            uint32 randomCreatureIndex = urand(0, rpCreatures.size() - 1);
-                            Creature* yellingCreature = rpCreatures[randomCreatureIndex];
-                            yellingCreature->Yell(event.activeRPScript[event.rpScriptIndex], LANG_UNIVERSAL);
-                            
-                            if (g_DebugMode)
-                            {
-                                LOG_INFO("server.loading", "[City Siege] RP Line {}/{}: '{}'",
-                                         event.rpScriptIndex + 1, event.activeRPScript.size(), 
-                                         event.activeRPScript[event.rpScriptIndex]);
-                            }
-                            
-                            // Move to next line in script
-                            event.rpScriptIndex++;
-                        }
-                    }
-                }
-            }
-        }
-
-        // Check if cinematic phase is over
-        if (event.cinematicPhase && (currentTime - event.startTime) >= g_CinematicDelay)
-        {
-            event.cinematicPhase = false;
-            
-            const CityData& city = g_Cities[event.cityId];
-            
-            // Announce battle has begun!
-            std::string battleStart = "|cffff0000[City Siege]|r |cffFF0000THE BATTLE HAS BEGUN!|r The siege of " + city.name + " is now underway! Defenders, to arms!";
-            SendSiegeScopedMessage(city, battleStart);
-            
-            // Play combat phase music if enabled
-            if (g_MusicEnabled && g_CombatMusicId > 0)
-            {
-                Map* map = sMapMgr->FindMap(city.mapId, 0);
-                if (map)
-                {
-                    // Send combat music to players within announce radius
-                    Map::PlayerList const& players = map->GetPlayers();
-                    for (auto itr = players.begin(); itr != players.end(); ++itr)
-                    {
-                        if (Player* player = itr->GetSource())
-                        {
-                            if (IsPlayerInAnnounceScope(player, city))
-                            {
-                                player->SendDirectMessage(WorldPackets::Misc::PlayMusic(g_CombatMusicId).Write());
-                            }
-                        }
-                    }
-                    
-                    if (g_DebugMode)
-                    {
-                        LOG_INFO("server.loading", "[City Siege] Playing combat phase music (ID: {}) for siege of {}", g_CombatMusicId, city.name);
-                    }
-                }
-            }
-            
-            // Activate playerbots for combat
-            ActivatePlayerbotsForSiege(event);
-            
-            if (g_DebugMode)
-            {
-                LOG_INFO("server.loading", "[City Siege] Cinematic phase ended, combat begins");
-            }
-            
-            // Determine the city faction
-            bool isAllianceCity = (event.cityId <= CITY_EXODAR);
-            
-            // Make creatures aggressive after cinematic phase
-            Map* map = sMapMgr->FindMap(city.mapId, 0);
-            if (map)
-            {
-                for (const auto& guid : event.spawnedCreatures)
-                {
-                    if (Creature* creature = map->GetCreature(guid))
-                    {
-                        // End cinematic protection.
-                        creature->RemoveUnitFlag(UNIT_FLAG_NON_ATTACKABLE);
-
-                        // Set proper hostile faction: Horde attacks Alliance cities, Alliance attacks Horde cities
-                        creature->SetFaction(isAllianceCity ? 83 : 84); // 83 = Horde, 84 = Alliance
-                        
-                        // Set react state based on configuration
-                        if (g_AggroPlayers && g_AggroNPCs)
-                        {
-                            creature->SetReactState(REACT_AGGRESSIVE);
-                        }
-                        else if (g_AggroPlayers)
-                        {
-                            creature->SetReactState(REACT_DEFENSIVE);
-                        }
-                        else
-                        {
-                            creature->SetReactState(REACT_DEFENSIVE);
-                        }
-                        
-                        // Ensure creature is grounded and cannot fly
-                        creature->SetDisableGravity(false);
-                        creature->SetCanFly(false);
-                        creature->SetHover(false);
-                        creature->RemoveUnitMovementFlag(MOVEMENTFLAG_CAN_FLY | MOVEMENTFLAG_DISABLE_GRAVITY | MOVEMENTFLAG_FLYING | MOVEMENTFLAG_SWIMMING | MOVEMENTFLAG_HOVER);
-                        
-                        // Force creature to ground level before starting movement
-                        float creatureX = creature->GetPositionX();
-                        float creatureY = creature->GetPositionY();
-                        float creatureZ = creature->GetPositionZ();
-                        float groundZ = creature->GetMap()->GetHeight(creatureX, creatureY, creatureZ + 5.0f, true, 50.0f);
-                        
-                        if (groundZ > INVALID_HEIGHT)
-                        {
-                            creature->UpdateGroundPositionZ(creatureX, creatureY, groundZ);
-                            creature->Relocate(creatureX, creatureY, groundZ, creature->GetOrientation());
-                        }
-                        
-                        // Prevent return to home position after combat - clear motion master
-                        creature->SetWalk(false);
-                        creature->GetMotionMaster()->Clear(false);
-                        creature->GetMotionMaster()->MoveIdle();
-                        
-                        // Initialize waypoint progress for this creature
-                        event.creatureWaypointProgress[guid] = 0;
-                        
-                        // Determine first destination
-                        float destX, destY, destZ;
-                        if (!city.waypoints.empty())
-                        {
-                            // Start with first waypoint
-                            destX = city.waypoints[0].x;
-                            destY = city.waypoints[0].y;
-                            destZ = city.waypoints[0].z;
-                        }
-                        else
-                        {
-                            // No waypoints, go directly to leader
-                            destX = city.leaderX;
-                            destY = city.leaderY;
-                            destZ = city.leaderZ;
-                        }
-                        
-                        // Store original Z coordinate
-                        float waypointZ = destZ;
-                        
-                        // Randomize position within 5 yards to prevent bunching (X/Y only)
-                        Map* creatureMap = creature->GetMap();
-                        RandomizePosition(destX, destY, destZ, creatureMap, 5.0f);
-                        
-                        // Restore original Z to prevent underground pathing
-                        destZ = waypointZ;
-                        
-                        // Update home position before movement to prevent evading
-                        creature->SetHomePosition(creature->GetPositionX(), creature->GetPositionY(), creature->GetPositionZ(), creature->GetOrientation());
-                        
-                        // Use MoveSplineInit for proper pathfinding
-                        Movement::MoveSplineInit init(creature);
-                        init.MoveTo(destX, destY, destZ, true, true);
-                        init.SetWalk(false);
-                        init.Launch();
-                    }
-                }
-                
-                // Initialize defenders - they move in REVERSE order through waypoints
-                for (const auto& guid : event.spawnedDefenders)
-                {
-                    if (Creature* creature = map->GetCreature(guid))
-                    {
-                        // End cinematic protection.
-                        creature->RemoveUnitFlag(UNIT_FLAG_NON_ATTACKABLE);
-
-                        // Set proper defender faction (same as city faction)
-                        creature->SetFaction(isAllianceCity ? 84 : 83); // 84 = Alliance, 83 = Horde
-                        creature->SetReactState(REACT_AGGRESSIVE);
-                        
-                        // Ensure creature is grounded
-                        creature->SetDisableGravity(false);
-                        creature->SetCanFly(false);
-                        creature->SetHover(false);
-                        creature->RemoveUnitMovementFlag(MOVEMENTFLAG_CAN_FLY | MOVEMENTFLAG_DISABLE_GRAVITY | MOVEMENTFLAG_FLYING | MOVEMENTFLAG_SWIMMING | MOVEMENTFLAG_HOVER);
-                        
-                        // Ground the creature
-                        float creatureX = creature->GetPositionX();
-                        float creatureY = creature->GetPositionY();
-                        float creatureZ = creature->GetPositionZ();
-                        float groundZ = creature->GetMap()->GetHeight(creatureX, creatureY, creatureZ + 5.0f, true, 50.0f);
-                        
-                        if (groundZ > INVALID_HEIGHT)
+                    {
+                        std::vector<Creature*> rpCreatures;
+                        for (SiegeParticipant const& participant : event.participants.records)
                         {
-                            creature->UpdateGroundPositionZ(creatureX, creatureY, groundZ);
-                            creature->Relocate(creatureX, creatureY, groundZ, creature->GetOrientation());
+                            // Only leaders and mini-bosses do RP
+                            if (!IsSiegeSpeaker(participant))
+                                continue;
+
+                            Creature* creature = map->GetCreature(participant.guid);
+                            if (creature && creature->IsAlive())
+                                rpCreatures.push_back(creature);
                         }
                         
-                        creature->SetWalk(false);
-                        creature->GetMotionMaster()->Clear(false);
-                        creature->GetMotionMaster()->MoveIdle();
-                        
-                        // Defenders start at the LAST waypoint (highest index) and go backwards
-                        // Set progress to MAX so they start at the end
-                        uint32 startWaypoint = city.waypoints.empty() ? 0 : city.waypoints.size();
-                        event.creatureWaypointProgress[guid] = startWaypoint + 10000; // Add 10000 to mark as defender
-                        
-                        // Determine first destination (last waypoint, or spawn point if no waypoints)
-                        float destX, destY, destZ;
-                        if (!city.waypoints.empty())
-                        {
-                            // Start at last waypoint and move backwards
-                            destX = city.waypoints[city.waypoints.size() - 1].x;
-                            destY = city.waypoints[city.waypoints.size() - 1].y;
-                            destZ = city.waypoints[city.waypoints.size() - 1].z;
-                        }
-                        else
+                        if (!rpCreatures.empty())
                         {
-                            // No waypoints, go directly to spawn point
-                            destX = city.spawnX;
-                            destY = city.spawnY;
-                            destZ = city.spawnZ;
+                            // Pick a random creature to say the current line
+                            uint32 randomCreatureIndex = urand(0, rpCreatures.size() - 1);
+                            Creature* yellingCreature = rpCreatures[randomCreatureIndex];
+                            yellingCreature->Yell(event.activeRPScript[event.rpScriptIndex], LANG_UNIVERSAL);
+                            
+                            if (g_DebugMode)
+                            {
+                                LOG_INFO("server.loading", "[City Siege] RP Line {}/{}: '{}'",
+                                         event.rpScriptIndex + 1, event.activeRPScript.size(), 
+                                         event.activeRPScript[event.rpScriptIndex]);
+                            }
+                            
+                            // Move to next line in script
+                            event.rpScriptIndex++;
                         }
-                        
-                        // Store original Z coordinate
-                        float waypointZ = destZ;
-                        
-                        // Randomize position to prevent bunching (X/Y only)
-                        Map* creatureMap = creature->GetMap();
-                        RandomizePosition(destX, destY, destZ, creatureMap, 5.0f);
-                        
-                        // Restore original Z to prevent underground pathing
-                        destZ = waypointZ;
-                        
-                        // Update home position
-                        creature->SetHomePosition(creature->GetPositionX(), creature->GetPositionY(), creature->GetPositionZ(), creature->GetOrientation());
-                        
-                        // Start movement
-                        Movement::MoveSplineInit init(creature);
-                        init.MoveTo(destX, destY, destZ, true, true);
-                        init.SetWalk(false);
-                        init.Launch();
                     }
                 }
             }
         }
 
-        // Handle periodic yells
-        if ((currentTime - event.lastYellTime) >= g_YellFrequency)
+        // Check if cinematic phase is over
+        if (event.cinematicPhase && (currentTime - event.startTime) >= g_CinematicDelay)
         {
-            event.lastYellTime = currentTime;
+            event.cinematicPhase = false;
+            RecordSiegeReplay(event, CitySiegeReplay::EventType::CombatStart);
             
             const CityData& city = g_Cities[event.cityId];
-            Map* map = sMapMgr->FindMap(city.mapId, 0);
-            if (map)
+            
+            // Announce battle has begun!
+            std::string battleStart = "|cffff0000[City Siege]|r |cffFF0000THE BATTLE HAS BEGUN!|r The siege of " + city.name + " is now underway! Defenders, to arms!";
+            SendSiegeScopedMessage(city, battleStart);
+            
+            // Play combat phase music if enabled
+            if (g_MusicEnabled && g_CombatMusicId > 0)
             {
-                // Make siege leaders yell
-                for (const auto& guid : event.spawnedCreatures)
+                Map* map = sMapMgr->FindMap(city.mapId, 0);
+                if (map)
                 {
-                    if (Creature* creature = map->GetCreature(guid))
+                    // Send combat music to players within announce radius
+                    for (Player* player : GetPlayersInAnnounceScope(city))
+                        player->SendDirectMessage(WorldPackets::Misc::PlayMusic(g_CombatMusicId).Write());
+                    
+                    if (g_DebugMode)
                     {
-                        uint32 entry = creature->GetEntry();
-                        // Only leaders and mini-bosses yell (and they must be alive)
-                        bool isLeader = (std::find(g_AllianceCityLeaders.begin(), g_AllianceCityLeaders.end(), entry) != g_AllianceCityLeaders.end()) ||
-                                       (std::find(g_HordeCityLeaders.begin(), g_HordeCityLeaders.end(), entry) != g_HordeCityLeaders.end());
-                        bool isMiniBoss = (entry == g_CreatureAllianceMiniBoss || entry == g_CreatureHordeMiniBoss);
-                        if (creature->IsAlive() && (isLeader || isMiniBoss))
-                        {
-                            // Parse combat yells from configuration (semicolon separated)
-                            std::vector<std::string> yells;
-                            std::string yellStr = g_YellsCombat;
-                            size_t pos = 0;
-                            while ((pos = yellStr.find(';')) != std::string::npos)
-                            {
-                                std::string yell = yellStr.substr(0, pos);
-                                if (!yell.empty())
-                                {
-                                    yells.push_back(yell);
-                                }
-                                yellStr.erase(0, pos + 1);
-                            }
-                            if (!yellStr.empty())
-                            {
-                                yells.push_back(yellStr);
-                            }
-                            
-                            if (!yells.empty())
-                            {
-                                uint32 randomIndex = urand(0, yells.size() - 1);
-                                creature->Yell(yells[randomIndex].c_str(), LANG_UNIVERSAL);
-                            }
-                            break; // Only one creature yells per cycle
-                        }
+                        LOG_INFO("server.loading", "[City Siege] Playing combat phase music (ID: {}) for siege of {}", g_CombatMusicId, city.name);
                     }
                 }
             }
-        }
+            
+            // Finish the army if it is still being spawned
+            ProcessSiegeSpawnJobs(event, true);
 
-        // Handle waypoint progression - check if creatures have reached their current waypoint
-        if (!event.cinematicPhase)
-        {
-            const CityData& city = g_Cities[event.cityId];
+            // Bring in any bots still waiting for their batch, then activate playerbots for combat
+            ProcessBotTeleportBatch(event, true);
+            ActivatePlayerbotsForSiege(event);
+            
+            if (g_DebugMode)
+            {
+                LOG_INFO("server.loading", "[City Siege] Cinematic phase ended, combat begins");
+            }
+            
+            // Determine the city faction
+            bool isAllianceCity = (event.cityId <= CITY_EXODAR);
+            
+            // Make creatures aggressive after cinematic phase
             Map* map = sMapMgr->FindMap(city.mapId, 0);
             if (map)
             {
+                // The leader serves the navmesh queries if the route was not compiled at siege start, else any siege creature
+                WorldObject const* pathSource = event.cityLeaderGuid ? map->GetCreature(event.cityLeaderGuid) : nullptr;
+                for (size_t i = 0; !pathSource && i < event.spawnedCreatures.size(); ++i)
+                    pathSource = map->GetCreature(event.spawnedCreatures[i]);
+
+                SiegeRoute const* route = GetSiegeRoute(city, map, pathSource);
+                FormSiegeSquads(event, map);
+
                 for (const auto& guid : event.spawnedCreatures)
                 {
                     if (Creature* creature = map->GetCreature(guid))
                     {
-                        // Track dead creatures for respawning
-                        if (!creature->IsAlive())
-                        {
-                            // Check if this specific creature GUID is already in the dead list (avoid duplicates)
-                            bool alreadyTracked = false;
-                            for (const auto& deadData : event.deadCreatures)
-                            {
-                                if (deadData.guid == guid)
-                                {
-                                    alreadyTracked = true;
-                                    break;
-                                }
-                            }
-                            
-                            // Add to dead creatures list if not already tracked
-                            if (!alreadyTracked && g_RespawnEnabled)
-                            {
-                                SiegeEvent::RespawnData respawnData;
-                                respawnData.guid = guid;
-                                respawnData.entry = creature->GetEntry();
-                                respawnData.deathTime = currentTime;
-                                respawnData.isDefender = false; // This is an attacker
-                                event.deadCreatures.push_back(respawnData);
-                                
-                                if (g_DebugMode)
-                                {
-                                    bool isLeader = (std::find(g_AllianceCityLeaders.begin(), g_AllianceCityLeaders.end(), respawnData.entry) != g_AllianceCityLeaders.end()) ||
-                                                   (std::find(g_HordeCityLeaders.begin(), g_HordeCityLeaders.end(), respawnData.entry) != g_HordeCityLeaders.end());
-                                    uint32 respawnTime = isLeader ? g_RespawnTimeLeader :
-                                                         respawnData.entry == g_CreatureAllianceMiniBoss || respawnData.entry == g_CreatureHordeMiniBoss ? g_RespawnTimeMiniBoss :
-                                                         respawnData.entry == g_CreatureAllianceElite || respawnData.entry == g_CreatureHordeElite ? g_RespawnTimeElite :
-                                                         g_RespawnTimeMinion;
-                                    LOG_INFO("server.loading", "[City Siege] Attacker {} (entry {}) died, will respawn at siege spawn point in {} seconds",
-                                             creature->GetGUID().ToString(), respawnData.entry, respawnTime);
-                                }
-                            }
-                            continue;
-                        }
-                        
-                        // IMPORTANT: ALWAYS set home position to current position to prevent evading/returning
-                        // This must be done continuously - even during combat - because combat reset can restore original home
-                        creature->SetHomePosition(creature->GetPositionX(), creature->GetPositionY(), creature->GetPositionZ(), creature->GetOrientation());
-                        
-                        // Skip movement updates if creature is currently in combat
-                        if (creature->IsInCombat())
-                            continue;
-                        
-                        // Check if creature is currently moving - if so, don't interrupt
-                        if (!creature->movespline->Finalized())
-                            continue;
-                        
-                        // Check if creature is currently moving - if so, don't interrupt
-                        if (!creature->movespline->Finalized())
-                            continue;
-                        
-                        // Force creature to ground level to prevent floating/clipping
-                        float creatureX = creature->GetPositionX();
-                        float creatureY = creature->GetPositionY();
-                        float creatureZ = creature->GetPositionZ();
-                        float groundZ = creature->GetMap()->GetHeight(creatureX, creatureY, creatureZ + 5.0f, true, 50.0f);
-                        
-                        // If ground Z is valid and creature is significantly off the ground, update position
-                        if (groundZ > INVALID_HEIGHT && std::abs(creatureZ - groundZ) > 2.0f)
-                        {
-                            creature->UpdateGroundPositionZ(creatureX, creatureY, groundZ);
-                            creature->Relocate(creatureX, creatureY, groundZ, creature->GetOrientation());
-                        }
-                        
-                        // Continuously enforce ground movement flags
-                        creature->SetDisableGravity(false);
-                        creature->SetCanFly(false);
-                        creature->SetHover(false);
-                        creature->RemoveUnitMovementFlag(MOVEMENTFLAG_CAN_FLY | MOVEMENTFLAG_DISABLE_GRAVITY | MOVEMENTFLAG_FLYING | MOVEMENTFLAG_SWIMMING | MOVEMENTFLAG_HOVER);
-                        
-                        // Get current waypoint index
-                        uint32 currentWP = event.creatureWaypointProgress[guid];
-                        
-                        // Check if this is a defender (marked with +10000)
-                        bool isDefender = (currentWP >= 10000);
-                        if (isDefender)
-                            currentWP -= 10000; // Remove marker to get actual waypoint
-                        
-                        // Check if we've reached final destination
-                        if (!isDefender && currentWP > city.waypoints.size())
-                            continue; // Attacker already at leader
-                        if (isDefender && currentWP == 0 && city.waypoints.empty())
-                            continue; // Defender at spawn point with no waypoints
-                        
-                        // Determine current target location
-                        float targetX, targetY, targetZ;
-                        
-                        if (isDefender)
-                        {
-                            // DEFENDERS: Move backwards through waypoints (high to low), then to spawn
-                            if (currentWP > 0 && currentWP <= city.waypoints.size())
-                            {
-                                // Moving towards a waypoint (backwards)
-                                targetX = city.waypoints[currentWP - 1].x;
-                                targetY = city.waypoints[currentWP - 1].y;
-                                targetZ = city.waypoints[currentWP - 1].z;
-                            }
-                            else if (currentWP == 0)
-                            {
-                                // At first waypoint, now go to spawn point
-                                targetX = city.spawnX;
-                                targetY = city.spawnY;
-                                targetZ = city.spawnZ;
-                            }
-                            else
-                            {
-                                continue; // Invalid state
-                            }
-                        }
-                        else
-                        {
-                            // ATTACKERS: Move forwards through waypoints (low to high), then to leader
-                            if (currentWP < city.waypoints.size())
-                            {
-                                targetX = city.waypoints[currentWP].x;
-                                targetY = city.waypoints[currentWP].y;
-                                targetZ = city.waypoints[currentWP].z;
-                            }
-                            else if (currentWP == city.waypoints.size())
-                            {
-                                targetX = city.leaderX;
-                                targetY = city.leaderY;
-                                targetZ = city.leaderZ;
-                            }
-                            else
-                            {
-                                continue;
-                            }
-                        }
-                        
-                        // Check distance to current target
-                        float dist = creature->GetDistance(targetX, targetY, targetZ);
-                        
-                        // If creature is far from target (>10 yards) and not moving, resume movement to current target
-                        if (dist > 10.0f)
-                        {
-                            // Store original waypoint Z to preserve floor height
-                            float waypointZ = targetZ;
-                            
-                            // Randomize target position to prevent bunching (X and Y only)
-                            Map* creatureMap = creature->GetMap();
-                            RandomizePosition(targetX, targetY, targetZ, creatureMap, 5.0f);
-                            
-                            // ALWAYS use the original waypoint Z coordinate to prevent underground pathing
-                            // Do NOT let the pathfinding system adjust Z to terrain/ground level
-                            targetZ = waypointZ;
-                            
-                            // Update home position before movement to prevent evading
-                            creature->SetHomePosition(creature->GetPositionX(), creature->GetPositionY(), creature->GetPositionZ(), creature->GetOrientation());
-                            
-                            Movement::MoveSplineInit init(creature);
-                            init.MoveTo(targetX, targetY, targetZ, true, true);
-                            init.SetWalk(false);
-                            init.Launch();
-                            continue;
-                        }
-                        
-                        // Creature is close to current target (within 10 yards), consider it reached
-                        if (dist <= 10.0f)
+                        SiegeParticipant* participant = FindSiegeParticipant(event, guid);
+
+                        // End cinematic protection: hostile faction (Horde attacks Alliance cities, Alliance attacks Horde cities)
+                        // and the configured react state
+                        ApplySiegeUnitProfile(creature, GetSiegeUnitProfile(participant ? participant->tier : SIEGE_TIER_MINION,
+                            isAllianceCity ? TEAM_HORDE : TEAM_ALLIANCE), true);
+
+                        // Force creature to ground level before starting movement
+                        GroundSiegeUnit(creature);
+
+                        // Start along the route towards the first waypoint (or the leader without waypoints);
+                        // followers fall into formation on the next movement pass
+                        if (participant)
                         {
-                            float nextX, nextY, nextZ;
-                            bool hasNextDestination = false;
-                            uint32 nextWP;
-                            
-                            if (isDefender)
-                            {
-                                // DEFENDERS: Move backwards (decrement waypoint)
-                                if (currentWP > 0)
-                                {
-                                    nextWP = currentWP - 1;
-                                    
-                                    if (nextWP > 0)
-                                    {
-                                        // Move to previous waypoint
-                                        nextX = city.waypoints[nextWP - 1].x;
-                                        nextY = city.waypoints[nextWP - 1].y;
-                                        nextZ = city.waypoints[nextWP - 1].z;
-                                        hasNextDestination = true;
-                                    }
-                                    else
-                                    {
-                                        // Reached first waypoint, now go to spawn
-                                        nextX = city.spawnX;
-                                        nextY = city.spawnY;
-                                        nextZ = city.spawnZ;
-                                        hasNextDestination = true;
-                                    }
-                                    
-                                    nextWP += 10000; // Re-add defender marker
-                                }
-                            }
-                            else
-                            {
-                                // ATTACKERS: Move forwards (increment waypoint)
-                                nextWP = currentWP + 1;
-                                
-                                if (nextWP < city.waypoints.size())
-                                {
-                                    // Move to next waypoint
-                                    nextX = city.waypoints[nextWP].x;
-                                    nextY = city.waypoints[nextWP].y;
-                                    nextZ = city.waypoints[nextWP].z;
-                                    hasNextDestination = true;
-                                }
-                                else if (nextWP == city.waypoints.size())
-                                {
-                                    // All waypoints complete, move to leader
-                                    nextX = city.leaderX;
-                                    nextY = city.leaderY;
-                                    nextZ = city.leaderZ;
-                                    hasNextDestination = true;
-                                }
-                            }
-                            
-                            // Update progress and start movement to next destination
-                            if (hasNextDestination)
-                            {
-                                event.creatureWaypointProgress[guid] = nextWP;
-                                
-                                // Store original waypoint Z
-                                float waypointZ = nextZ;
-                                
-                                // Randomize next position to prevent bunching (X/Y only)
-                                Map* creatureMap = creature->GetMap();
-                                RandomizePosition(nextX, nextY, nextZ, creatureMap, 5.0f);
-                                
-                                // Restore original Z coordinate to prevent underground pathing
-                                nextZ = waypointZ;
-                                
-                                // Update home position before movement to prevent evading
-                                creature->SetHomePosition(creature->GetPositionX(), creature->GetPositionY(), creature->GetPositionZ(), creature->GetOrientation());
-                                
-                                Movement::MoveSplineInit init(creature);
-                                init.MoveTo(nextX, nextY, nextZ, true, true);
-                                init.SetWalk(false);
-                                init.Launch();
-                            }
+                            uint32 const firstStop = ResetParticipantRoute(*participant, city);
+                            if (route && !GetFollowedSquad(event.squads, *participant))
+                                LaunchSiegeRouteMovement(creature, *route, firstStop, false);
                         }
                     }
                 }
                 
-                // Check defenders for deaths (separate tracking from attackers)
+                // Initialize defenders - they move in REVERSE order through waypoints
                 for (const auto& guid : event.spawnedDefenders)
                 {
                     if (Creature* creature = map->GetCreature(guid))
                     {
-                        // Track dead defenders for respawning
-                        if (!creature->IsAlive())
-                        {
-                            // Check if this specific defender GUID is already in the dead list (avoid duplicates)
-                            bool alreadyTracked = false;
-                            for (const auto& deadData : event.deadCreatures)
-                            {
-                                if (deadData.guid == guid)
-                                {
-                                    alreadyTracked = true;
-                                    break;
-                                }
-                            }
-                            
-                            // Add to dead creatures list if not already tracked
-                            if (!alreadyTracked && g_RespawnEnabled)
-                            {
-                                SiegeEvent::RespawnData respawnData;
-                                respawnData.guid = guid;
-                                respawnData.entry = creature->GetEntry();
-                                respawnData.deathTime = currentTime;
-                                respawnData.isDefender = true; // This is a defender
-                                event.deadCreatures.push_back(respawnData);
-                                
-                                if (g_DebugMode)
-                                {
-                                    LOG_INFO("server.loading", "[City Siege] Defender {} (entry {}) died, will respawn near leader position in {} seconds",
-                                             creature->GetGUID().ToString(), respawnData.entry, g_RespawnTimeDefender);
-                                }
-                            }
-                            continue;
-                        }
-                        
-                        // IMPORTANT: ALWAYS set home position to current position to prevent evading/returning
-                        creature->SetHomePosition(creature->GetPositionX(), creature->GetPositionY(), creature->GetPositionZ(), creature->GetOrientation());
-                        
-                        // Skip movement updates if creature is currently in combat
-                        if (creature->IsInCombat())
-                            continue;
-                        
-                        // Check if creature is currently moving - if so, don't interrupt
-                        if (!creature->movespline->Finalized())
-                            continue;
-                        
-                        // Force creature to ground level
-                        float creatureX = creature->GetPositionX();
-                        float creatureY = creature->GetPositionY();
-                        float creatureZ = creature->GetPositionZ();
-                        float groundZ = creature->GetMap()->GetHeight(creatureX, creatureY, creatureZ + 5.0f, true, 50.0f);
-                        
-                        if (groundZ > INVALID_HEIGHT && std::abs(creatureZ - groundZ) > 2.0f)
-                        {
-                            creature->UpdateGroundPositionZ(creatureX, creatureY, groundZ);
-                            creature->Relocate(creatureX, creatureY, groundZ, creature->GetOrientation());
-                        }
-                        
-                        creature->SetDisableGravity(false);
-                        creature->SetCanFly(false);
-                        creature->SetHover(false);
-                        creature->RemoveUnitMovementFlag(MOVEMENTFLAG_CAN_FLY | MOVEMENTFLAG_DISABLE_GRAVITY | MOVEMENTFLAG_FLYING | MOVEMENTFLAG_SWIMMING | MOVEMENTFLAG_HOVER);
-                        
-                        // Get current waypoint - defenders have +10000 marker
-                        uint32 currentWP = event.creatureWaypointProgress[guid];
-                        if (currentWP < 10000)
-                            continue; // Not a defender marker, skip
-                        
-                        currentWP -= 10000; // Remove defender marker
-                        
-                        // Check if defender has reached spawn point (waypoint 0)
-                        if (currentWP == 0 && city.waypoints.empty())
-                            continue; // Already at spawn
-                        
-                        // Defenders move backwards through waypoints
-                        float targetX, targetY, targetZ;
-                        if (currentWP > 0 && currentWP <= city.waypoints.size())
-                        {
-                            // Moving towards previous waypoint
-                            targetX = city.waypoints[currentWP - 1].x;
-                            targetY = city.waypoints[currentWP - 1].y;
-                            targetZ = city.waypoints[currentWP - 1].z;
-                        }
-                        else if (currentWP == 0)
-                        {
-                            // Go to spawn point
-                            targetX = city.spawnX;
-                            targetY = city.spawnY;
-                            targetZ = city.spawnZ;
-                        }
-                        else
-                        {
-                            continue; // Invalid state
-                        }
-                        
-                        // Check distance to target
-                        float dist = creature->GetDistance(targetX, targetY, targetZ);
-                        
-                        // If far from target and not moving, resume movement
-                        if (dist > 10.0f)
-                        {
-                            // Store original waypoint Z to preserve floor height
-                            float waypointZ = targetZ;
-                            
-                            // Randomize X/Y only to prevent bunching
-                            RandomizePosition(targetX, targetY, targetZ, map, 5.0f);
-                            
-                            // ALWAYS use the original waypoint Z coordinate to prevent underground pathing
-                            targetZ = waypointZ;
-                            
-                            creature->SetHomePosition(creature->GetPositionX(), creature->GetPositionY(), creature->GetPositionZ(), creature->GetOrientation());
-                            
-                            Movement::MoveSplineInit init(creature);
-                            init.MoveTo(targetX, targetY, targetZ, true, true);
-                            init.SetWalk(false);
-                            init.Launch();
-                        }
-                        // If close to target waypoint, advance to next
-                        else if (dist <= 5.0f)
-                        {
-                            uint32 nextWP;
-                            float nextX, nextY, nextZ;
-                            
-                            if (currentWP > 0)
-                            {
-                                // Move to previous waypoint
-                                nextWP = currentWP - 1;
-                                if (nextWP > 0)
-                                {
-                                    nextX = city.waypoints[nextWP - 1].x;
-                                    nextY = city.waypoints[nextWP - 1].y;
-                                    nextZ = city.waypoints[nextWP - 1].z;
-                                }
-                                else
-                                {
-                                    // Go to spawn point
-                                    nextX = city.spawnX;
-                                    nextY = city.spawnY;
-                                    nextZ = city.spawnZ;
-                                }
-                            }
-                            else
-                            {
-                                continue; // Already at spawn
-                            }
-                            
-                            // Update progress with defender marker
-                            event.creatureWaypointProgress[guid] = nextWP + 10000;
-                            
-                            // Store original waypoint Z
-                            float waypointZ = nextZ;
-                            
-                            // Randomize X/Y only
-                            RandomizePosition(nextX, nextY, nextZ, map, 5.0f);
-                            
-                            // Restore original Z coordinate
-                            nextZ = waypointZ;
-                            
-                            creature->SetHomePosition(creature->GetPositionX(), creature->GetPositionY(), creature->GetPositionZ(), creature->GetOrientation());
-                            
-                            Movement::MoveSplineInit init(creature);
-                            init.MoveTo(nextX, nextY, nextZ, true, true);
-                            init.SetWalk(false);
-                            init.Launch();
-                        }
-                    }
-                }
-            }
-        }
+                        // End cinematic protection: defenders fight for the city faction
+                        ApplySiegeUnitProfile(creature, GetSiegeUnitProfile(SIEGE_TIER_DEFENDER, isAllianceCity ? TEAM_ALLIANCE : TEAM_HORDE), true);
+                        GroundSiegeUnit(creature);
 
-        // Handle respawning of dead creatures (only during active siege, not during cinematic)
-        if (!event.cinematicPhase && g_RespawnEnabled && !event.deadCreatures.empty())
-        {
-            const CityData& city = g_Cities[event.cityId];
-            Map* map = sMapMgr->FindMap(city.mapId, 0);
-            if (map)
-            {
-                // Check each dead creature to see if it's time to respawn
-                for (auto it = event.deadCreatures.begin(); it != event.deadCreatures.end();)
-                {
-                    const auto& respawnData = *it;
-                    
-                    // Determine respawn time based on creature type and whether it's a defender
-                    uint32 respawnDelay;
-                    
-                    if (respawnData.isDefender)
-                    {
-                        // Defenders use their own respawn time
-                        respawnDelay = g_RespawnTimeDefender;
-                    }
-                    else
-                    {
-                        // Attackers use type-based respawn times
-                        respawnDelay = g_RespawnTimeMinion; // Default
-                        bool isLeader = (std::find(g_AllianceCityLeaders.begin(), g_AllianceCityLeaders.end(), respawnData.entry) != g_AllianceCityLeaders.end()) ||
-                                       (std::find(g_HordeCityLeaders.begin(), g_HordeCityLeaders.end(), respawnData.entry) != g_HordeCityLeaders.end());
-                        if (isLeader)
-                        {
-                            respawnDelay = g_RespawnTimeLeader;
-                        }
-                        else if (respawnData.entry == g_CreatureAllianceMiniBoss || respawnData.entry == g_CreatureHordeMiniBoss)
-                        {
-                            respawnDelay = g_RespawnTimeMiniBoss;
-                        }
-                        else if (respawnData.entry == g_CreatureAllianceElite || respawnData.entry == g_CreatureHordeElite)
+                        // Defenders start at the LAST waypoint (highest index) and walk the route backwards
+                        // (towards the spawn point if there are no waypoints)
+                        if (SiegeParticipant* participant = FindSiegeParticipant(event, guid))
                         {
-                            respawnDelay = g_RespawnTimeElite;
+                            uint32 const firstStop = ResetParticipantRoute(*participant, city);
+                            if (route && !GetFollowedSquad(event.squads, *participant))
+                                LaunchSiegeRouteMovement(creature, *route, firstStop, true);
                         }
                     }
-                    
-                    // Check if enough time has passed
-                    if (currentTime >= (respawnData.deathTime + respawnDelay))
-                    {
-                        // Calculate spawn position based on whether this is a defender or attacker
-                        float spawnX, spawnY, spawnZ;
-                        
-                        if (respawnData.isDefender)
-                        {
-                            // Defenders respawn near the city leader position
-                            spawnX = city.leaderX;
-                            spawnY = city.leaderY;
-                            spawnZ = city.leaderZ;
-                            
-                            // Randomize spawn position in a circle around leader (15 yards)
-                            float angle = frand(0.0f, 2.0f * M_PI);
-                            float dist = frand(10.0f, 15.0f);
-                            spawnX += dist * cos(angle);
-                            spawnY += dist * sin(angle);
-                        }
-                        else
-                        {
-                            // Attackers respawn at the siege spawn point
-                            spawnX = city.spawnX;
-                            spawnY = city.spawnY;
-                            spawnZ = city.spawnZ;
-                        }
-                        
-                        // Get proper ground height at spawn location
-                        float groundZ = map->GetHeight(spawnX, spawnY, spawnZ, true, 50.0f);
-                        if (groundZ > INVALID_HEIGHT)
-                            spawnZ = groundZ + 0.5f;
-                        
-                        // Respawn the creature
-                        if (Creature* creature = map->SummonCreature(respawnData.entry, Position(spawnX, spawnY, spawnZ, 0)))
-                        {
-                            // Set up the respawned creature
-                            bool isAllianceCity = (event.cityId <= CITY_EXODAR);
-                            
-                            // Set level and scale based on creature type
-                            if (respawnData.isDefender)
-                            {
-                                creature->SetLevel(g_LevelDefender);
-                                // Defenders use default scale (1.0)
-                            }
-                            else
-                            {
-                                // Determine attacker level and scale by entry
-                                bool isLeader = (std::find(g_AllianceCityLeaders.begin(), g_AllianceCityLeaders.end(), respawnData.entry) != g_AllianceCityLeaders.end()) ||
-                                               (std::find(g_HordeCityLeaders.begin(), g_HordeCityLeaders.end(), respawnData.entry) != g_HordeCityLeaders.end());
-                                if (isLeader)
-                                {
-                                    creature->SetLevel(g_LevelLeader);
-                                    creature->SetObjectScale(g_ScaleLeader);
-                                }
-                                else if (respawnData.entry == g_CreatureAllianceMiniBoss || respawnData.entry == g_CreatureHordeMiniBoss)
-                                {
-                                    creature->SetLevel(g_LevelMiniBoss);
-                                    creature->SetObjectScale(g_ScaleMiniBoss);
-                                }
-                                else if (respawnData.entry == g_CreatureAllianceElite || respawnData.entry == g_CreatureHordeElite)
-                                {
-                                    creature->SetLevel(g_LevelElite);
-                                    // Elites use default scale (1.0)
-                                }
-                                else
-                                {
-                                    creature->SetLevel(g_LevelMinion);
-                                    // Minions use default scale (1.0)
-                                }
-                            }
-                            
-                            if (respawnData.isDefender)
-                            {
-                                // Defenders use city faction
-                                creature->SetFaction(isAllianceCity ? 84 : 83); // 84 = Alliance, 83 = Horde
-                                creature->SetReactState(REACT_AGGRESSIVE);
-                            }
-                            else
-                            {
-                                // Attackers use opposing faction
-                                creature->SetFaction(isAllianceCity ? 83 : 84); // 83 = Horde, 84 = Alliance
-                                
-                                // Set react state based on configuration
-                                if (g_AggroPlayers && g_AggroNPCs)
-                                {
-                                    creature->SetReactState(REACT_AGGRESSIVE);
-                                }
-                                else if (g_AggroPlayers)
-                                {
-                                    creature->SetReactState(REACT_DEFENSIVE);
-                                }
-                                else
-                                {
-                                    creature->SetReactState(REACT_DEFENSIVE);
-                                }
-                            }
-                            
-                            // Enforce ground movement
-                            creature->SetDisableGravity(false);
-                            creature->SetCanFly(false);
-                            creature->SetHover(false);
-                            creature->RemoveUnitMovementFlag(MOVEMENTFLAG_CAN_FLY | MOVEMENTFLAG_DISABLE_GRAVITY | MOVEMENTFLAG_FLYING | MOVEMENTFLAG_SWIMMING | MOVEMENTFLAG_HOVER);
-                            creature->UpdateGroundPositionZ(spawnX, spawnY, spawnZ);
-                            
-                            // Prevent return to home position after combat - clear motion master
-                            creature->SetWalk(false);
-                            creature->GetMotionMaster()->Clear(false);
-                            creature->GetMotionMaster()->MoveIdle();
-                            
-                            // Set home position to spawn location to prevent evading back
-                            creature->SetHomePosition(spawnX, spawnY, spawnZ, 0);
-                            
-                            // Replace the old GUID with the new one in appropriate spawned list
-                            if (respawnData.isDefender)
-                            {
-                                for (auto& spawnedGuid : event.spawnedDefenders)
-                                {
-                                    if (spawnedGuid == respawnData.guid)
-                                    {
-                                        spawnedGuid = creature->GetGUID();
-                                        break;
-                                    }
-                                }
-                            }
-                            else
-                            {
-                                for (auto& spawnedGuid : event.spawnedCreatures)
-                                {
-                                    if (spawnedGuid == respawnData.guid)
-                                    {
-                                        spawnedGuid = creature->GetGUID();
-                                        break;
-                                    }
-                                }
-                            }
-                            
-                            // Set waypoint progress and initial movement destination
-                            event.creatureWaypointProgress.erase(respawnData.guid); // Remove old GUID
-                            
-                            float destX, destY, destZ;
-                            
-                            if (respawnData.isDefender)
-                            {
-                                // Defenders start at last waypoint and move backwards
-                                uint32 startWaypoint = city.waypoints.empty() ? 0 : city.waypoints.size();
-                                event.creatureWaypointProgress[creature->GetGUID()] = startWaypoint + 10000; // Add defender marker
-                                
-                                // Start moving to last waypoint (or spawn point if no waypoints)
-                                if (!city.waypoints.empty())
-                                {
-                                    destX = city.waypoints[city.waypoints.size() - 1].x;
-                                    destY = city.waypoints[city.waypoints.size() - 1].y;
-                                    destZ = city.waypoints[city.waypoints.size() - 1].z;
-                                }
-                                else
-                                {
-                                    destX = city.spawnX;
-                                    destY = city.spawnY;
-                                    destZ = city.spawnZ;
-                                }
-                            }
-                            else
-                            {
-                                // Attackers start from waypoint 0 and move forward
-                                event.creatureWaypointProgress[creature->GetGUID()] = 0;
-                                
-                                // Start movement to first waypoint or leader
-                                if (!city.waypoints.empty())
-                                {
-                                    destX = city.waypoints[0].x;
-                                    destY = city.waypoints[0].y;
-                                    destZ = city.waypoints[0].z;
-                                }
-                                else
-                                {
-                                    destX = city.leaderX;
-                                    destY = city.leaderY;
-                                    destZ = city.leaderZ;
-                                }
-                            }
-                            
-                            // Store original Z coordinate
-                            float waypointZ = destZ;
-                            
-                            // Randomize position to prevent bunching on respawn (X/Y only)
-                            Map* creatureMap = creature->GetMap();
-                            RandomizePosition(destX, destY, destZ, creatureMap, 5.0f);
-                            
-                            // Restore original Z to prevent underground pathing
-                            destZ = waypointZ;
-                            
-                            // Update home position before movement to prevent evading
-                            creature->SetHomePosition(creature->GetPositionX(), creature->GetPositionY(), creature->GetPositionZ(), creature->GetOrientation());
-                            
-                            Movement::MoveSplineInit init(creature);
-                            init.MoveTo(destX, destY, destZ, true, true);
-                            init.SetWalk(false);
-                            init.Launch();
-                            
-                            if (g_DebugMode)
+                }
+            }
+        }
+
+        // Handle periodic yells
+        if (yellsDue && (currentTime - event.lastYellTime) >= g_YellFrequency)
+        {
+            event.lastYellTime = currentTime;
+            
+            const CityData& city = g_Cities[event.cityId];
+            Map* map = sMapMgr->FindMap(city.mapId, 0);
+            if (map)
+            {
+                // Make siege leaders yell
+                for (SiegeParticipant const& participant : event.participants.records)
+                {
+                    // Only leaders and mini-bosses yell (and they must be alive)
+                    if (!IsSiegeSpeaker(participant))
+                        continue;
+
+                    if (Creature* creature = map->GetCreature(participant.guid))
+                    {
+                        if (creature->IsAlive())
+                        {
+                            // Combat yells are compiled from CitySiege.Yell.Combat at config load
+                            if (SiegeTextTemplate const* yell = PickSiegeText(g_TextCombatYells))
                             {
-                                LOG_INFO("server.loading", "[City Siege] Respawned {} {} at {} ({}, {}, {}), starting movement to {} waypoint",
-                                         respawnData.isDefender ? "defender" : "attacker",
-                                         creature->GetGUID().ToString(),
-                                         respawnData.isDefender ? "leader position" : "siege spawn point",
-                                         spawnX, spawnY, spawnZ,
-                                         respawnData.isDefender ? "last" : "first");
+                                SiegeTextArgs args;
+                                args.city = city.name;
+                                args.leader = event.cityLeaderName;
+                                creature->Yell(RenderSiegeText(*yell, args), LANG_UNIVERSAL);
                             }
+                            break; // Only one creature yells per cycle
                         }
-                        
-                        // Remove from dead creatures list
-                        it = event.deadCreatures.erase(it);
-                    }
-                    else
-                    {
-                        ++it;
                     }
                 }
             }
         }
 
 #ifdef MOD_PLAYERBOTS
-        // Handle bot death tracking and respawning
-        if (!event.cinematicPhase)
+        // Bots are players, so their travel targets and respawns always stay on the world thread
+        if (!event.cinematicPhase &&
+            event.scheduler.ConsumeIfDue(SIEGE_SUBSYSTEM_BOT_MOVEMENT, g_SchedulerMovementInterval))
         {
-            CheckBotDeaths(event);
-            ProcessBotRespawns(event);
+            SiegePerfTimer botTimer(SIEGE_PERF_BOT_UPDATE, &event.perf);
             UpdateBotWaypointMovement(event);
         }
+
+        // Handle bot respawning (deaths are queued by the death hook)
+        if (!event.cinematicPhase &&
+            event.scheduler.ConsumeIfDue(SIEGE_SUBSYSTEM_BOT_RESPAWN, g_SchedulerRespawnInterval))
+        {
+            SiegePerfTimer botTimer(SIEGE_PERF_BOT_UPDATE, &event.perf);
+            ProcessBotRespawns(event);
+        }
 #endif
 
+        // Creature work runs here unless the map update threads already did it this tick
+        if (!g_SchedulerParallelUpdate)
+        {
+            UpdateSiegeMapWork(event, currentTime, budget);
+            ProcessSiegeWorldTasks();
+            if (!event.isActive)
+                continue;
+        }
+
         // Status announcements every 5 minutes (300 seconds) during active combat
         if (!event.cinematicPhase && (currentTime - event.lastStatusAnnouncement) >= 300)
         {
@@ -4141,21 +6423,12 @@ void UpdateSiegeEvents(uint32 /*diff*/)
             
             if (map)
             {
-                // Search around the leader's throne coordinates directly
-                std::list<Creature*> leaderList;
-                CitySiege::CreatureEntryCheck check(city.targetLeaderEntry);
-                CitySiege::SimpleCreatureListSearcher<CitySiege::CreatureEntryCheck> searcher(leaderList, check);
-                Cell::VisitObjects(city.leaderX, city.leaderY, map, searcher, 100.0f);
-                
-                // Find the leader at the throne
-                for (Creature* leader : leaderList)
+                // Use the cached leader handle instead of searching the throne room
+                Creature* leader = ResolveSiegeLeader(event, map);
+                if (leader && leader->IsAlive())
                 {
-                    if (leader && leader->IsAlive())
-                    {
-                        leaderHealthPct = leader->GetHealthPct();
-                        leaderHealthAvailable = true;
-                        break;
-                    }
+                    leaderHealthPct = leader->GetHealthPct();
+                    leaderHealthAvailable = true;
                 }
             }
             
@@ -4206,78 +6479,6 @@ void UpdateSiegeEvents(uint32 /*diff*/)
             BroadcastSiegeDataToAddon(event, "UPDATE");
         }
 
-        // Check if city leader is dead (attackers win)
-        if (!event.cinematicPhase)
-        {
-            const CityData& city = g_Cities[event.cityId];
-            Map* map = sMapMgr->FindMap(city.mapId, 0);
-            if (map)
-            {
-                // Search around the leader's throne coordinates directly - no dependency on siege creatures!
-                std::list<Creature*> leaderList;
-                CitySiege::CreatureEntryCheck check(city.targetLeaderEntry);
-                CitySiege::SimpleCreatureListSearcher<CitySiege::CreatureEntryCheck> searcher(leaderList, check);
-                Cell::VisitObjects(city.leaderX, city.leaderY, map, searcher, 100.0f);
-                
-                bool leaderFound = false;
-                bool leaderAlive = false;
-                
-                // Check if we found the leader at the throne
-                for (Creature* leader : leaderList)
-                {
-                    if (leader)
-                    {
-                        leaderFound = true;
-                        leaderAlive = leader->IsAlive();
-                        break;
-                    }
-                }
-                
-                // Only end siege if we actually FOUND the leader and they are DEAD
-                if (leaderFound && !leaderAlive)
-                {
-                    if (g_DebugMode)
-                    {
-                        LOG_INFO("server.loading", "[City Siege] City leader killed! Attackers win. Ending siege of {}", city.name);
-                    }
-                    
-                    // Determine winning team: opposite of the city's faction
-                    bool isAllianceCity = (event.cityId <= CITY_EXODAR);
-                    int winningTeam = isAllianceCity ? 1 : 0; // 0 = Alliance, 1 = Horde
-                    
-                    EndSiegeEvent(event, winningTeam);
-                }
-            }
-        }
-
-        // Check if city leader has died (attackers win immediately)
-        if (!event.cinematicPhase && event.cityLeaderGuid)
-        {
-            const CityData& city = g_Cities[event.cityId];
-            Map* map = sMapMgr->FindMap(city.mapId, 0);
-            
-            if (map)
-            {
-                Creature* cityLeader = map->GetCreature(event.cityLeaderGuid);
-                
-                if (!cityLeader || !cityLeader->IsAlive())
-                {
-                    if (g_DebugMode)
-                    {
-                        LOG_INFO("server.loading", "[City Siege] City leader has been killed! Attackers win the siege of {}!", city.name);
-                    }
-                    
-                    // Determine winning team (attackers = opposite of city faction)
-                    bool isAllianceCity = (event.cityId == CITY_STORMWIND || event.cityId == CITY_IRONFORGE || 
-                                          event.cityId == CITY_DARNASSUS || event.cityId == CITY_EXODAR);
-                    int winningTeam = isAllianceCity ? 1 : 0; // Opposite faction wins
-                    
-                    EndSiegeEvent(event, winningTeam);
-                    continue; // Skip to next event since this one just ended
-                }
-            }
-        }
-
         // Check if event should end (time limit reached - defenders win)
         if (currentTime >= event.endTime)
         {
@@ -4289,7 +6490,7 @@ void UpdateSiegeEvents(uint32 /*diff*/)
     g_ActiveSieges.erase(
         std::remove_if(g_ActiveSieges.begin(), g_ActiveSieges.end(),
             [currentTime](const SiegeEvent& event) {
-                return !event.isActive && (currentTime - event.endTime) > 60;
+                return !event.isActive && event.teardownStage == SIEGE_TEARDOWN_DONE && (currentTime - event.endTime) > 60;
             }),
         g_ActiveSieges.end()
     );
@@ -4338,16 +6539,31 @@ public:
         {
             LOG_INFO("server.loading", "[City Siege] Module disabled");
         }
+
+        // Pick up sieges interrupted by a crash (this also restores the siege timer) and start checkpointing
+        if (g_RecoveryEnabled)
+        {
+            LoadSiegeCheckpoint();
+            LoadSiegeRewardJournal();
+            g_CheckpointWriter.Start(g_RecoveryFile);
+        }
     }
 
     void OnUpdate(uint32 diff) override
     {
+        // Checkpoints keep running while the module is disabled so interrupted sieges still get rolled back
+        UpdateSiegeCheckpoints(diff);
+
+        // Rewards of ended sieges are paid out even if the module was disabled in the meantime
+        ProcessSiegeRewardJobs();
+
         if (!g_CitySiegeEnabled)
         {
             return;
         }
 
         UpdateSiegeEvents(diff);
+        UpdateSiegePerfLog(diff);
     }
 
     void OnShutdown() override
@@ -4355,15 +6571,136 @@ public:
         // Clean up any active sieges
         for (auto& event : g_ActiveSieges)
         {
-            if (event.isActive)
-                FinalizeSiegeCleanup(event, "shutdown", false);
+            // Also finishes sieges that already ended but are still tearing down
+            if (event.isActive || event.teardownStage != SIEGE_TEARDOWN_DONE)
+                FinalizeSiegeCleanup(event, "shutdown", false, true);
         }
         g_ActiveSieges.clear();
 
+        // Pay what is left to the players still online; the journal keeps the rest for the next start
+        ProcessSiegeRewardJobs(true);
+
+        // Clean shutdown: the final checkpoint only keeps the siege timer and anything still waiting for recovery
+        if (g_CheckpointWriter.IsRunning())
+        {
+            g_CheckpointWriter.Submit(BuildSiegeCheckpoint());
+            g_CheckpointWriter.Stop();
+        }
+
+        // The teardowns above flushed every replay; wait for them to reach the disk
+        g_ReplayWriter.Stop();
+
         LOG_INFO("server.loading", "[City Siege] Module shutdown complete");
     }
 };
 
+/**
+ * @brief UnitScript that reports deaths of siege creatures and playerbots as they happen.
+ */
+class CitySiegeUnitScript : public UnitScript
+{
+public:
+    CitySiegeUnitScript() : UnitScript("CitySiegeUnitScript", true, { UNITHOOK_ON_UNIT_DEATH, UNITHOOK_ON_DAMAGE, UNITHOOK_ON_HEAL }) { }
+
+    void OnUnitDeath(Unit* unit, Unit* killer) override
+    {
+        if (!unit || g_ActiveSieges.empty() || !IsOnSiegeMap(unit))
+            return;
+
+        // Deaths are reported from map update threads; sieges on different maps may report at the same time
+        std::lock_guard<std::mutex> guard(_lock);
+
+        if (Creature* creature = unit->ToCreature())
+            HandleSiegeCreatureDeath(creature, killer);
+#ifdef MOD_PLAYERBOTS
+        else if (Player* player = unit->ToPlayer())
+            HandleSiegeBotDeath(player, killer);
+#endif
+    }
+
+    // Each siege is only fought on its own map, so its ledger is only written from that map's update thread
+    void OnDamage(Unit* attacker, Unit* victim, uint32& damage) override
+    {
+        if (attacker && victim && !g_ActiveSieges.empty())
+            RecordSiegeDamage(attacker, victim, damage);
+    }
+
+    void OnHeal(Unit* healer, Unit* receiver, uint32& gain) override
+    {
+        if (healer && receiver && !g_ActiveSieges.empty())
+            RecordSiegeHealing(healer, receiver, gain);
+    }
+
+private:
+    std::mutex _lock;
+};
+
+/**
+ * @brief AllMapScript that runs siege creature work on the update thread of the siege's map.
+ */
+class CitySiegeMapScript : public AllMapScript
+{
+public:
+    CitySiegeMapScript() : AllMapScript("CitySiegeMapScript", { ALLMAPHOOK_ON_MAP_UPDATE }) { }
+
+    void OnMapUpdate(Map* map, uint32 /*diff*/) override
+    {
+        // Sieges only happen in the open world, never in instances
+        if (!g_CitySiegeEnabled || !g_SchedulerParallelUpdate || !map || map->GetInstanceId() != 0 || g_ActiveSieges.empty())
+            return;
+
+        UpdateSiegeMapEvents(map);
+    }
+};
+
+/**
+ * @brief AllCreatureScript that invalidates the cached city leader handle when the leader leaves the world.
+ */
+class CitySiegeCreatureScript : public AllCreatureScript
+{
+public:
+    CitySiegeCreatureScript() : AllCreatureScript("CitySiegeCreatureScript") { }
+
+    void OnCreatureRemoveWorld(Creature* creature) override
+    {
+        if (!creature || g_ActiveSieges.empty() || !IsOnSiegeMap(creature))
+            return;
+
+        // Only sieges on the creature's map; the others belong to other map threads
+        for (SiegeEvent& event : g_ActiveSieges)
+        {
+            if (g_Cities[event.cityId].mapId != creature->GetMapId())
+                continue;
+
+            if (event.isActive && event.cityLeaderGuid == creature->GetGUID())
+                event.leaderHandleStale = true;
+        }
+    }
+};
+
+/**
+ * @brief PlayerScript that returns bots from interrupted sieges on login and forgets per-player addon state on logout.
+ */
+class CitySiegePlayerScript : public PlayerScript
+{
+public:
+    CitySiegePlayerScript() : PlayerScript("CitySiegePlayerScript", { PLAYERHOOK_ON_LOGIN, PLAYERHOOK_ON_LOGOUT }) { }
+
+    void OnPlayerLogin(Player* player) override
+    {
+        if (!g_PendingBotReturns.empty())
+            ReturnRecoveredBot(player);
+
+        if (!g_OfflineRewards.empty())
+            PayOfflineSiegeRewards(player);
+    }
+
+    void OnPlayerLogout(Player* player) override
+    {
+        UnsubscribeAddonClient(player->GetGUID());
+    }
+};
+
 // -----------------------------------------------------------------------------
 // COMMAND SCRIPT
 // -----------------------------------------------------------------------------
@@ -4384,12 +6721,17 @@ public:
             { "stop",         HandleCitySiegeStopCommand,         SEC_GAMEMASTER, Console::No },
             { "cleanup",      HandleCitySiegeCleanupCommand,      SEC_GAMEMASTER, Console::No },
             { "status",       HandleCitySiegeStatusCommand,       SEC_GAMEMASTER, Console::No },
+            { "perf",         HandleCitySiegePerfCommand,         SEC_GAMEMASTER, Console::No },
+            { "bench",        HandleCitySiegeBenchCommand,        SEC_ADMINISTRATOR, Console::No },
             { "testwaypoint", HandleCitySiegeTestWaypointCommand, SEC_GAMEMASTER, Console::No },
             { "waypoints",    HandleCitySiegeWaypointsCommand,    SEC_GAMEMASTER, Console::No },
             { "distance",     HandleCitySiegeDistanceCommand,     SEC_GAMEMASTER, Console::No },
             { "info",         HandleCitySiegeInfoCommand,         SEC_GAMEMASTER, Console::No },
             { "reload",       HandleCitySiegeReloadCommand,       SEC_ADMINISTRATOR, Console::No },
             { "sync",         HandleCitySiegeSyncCommand,         SEC_PLAYER, Console::No },
+            { "resync",       HandleCitySiegeResyncCommand,       SEC_PLAYER, Console::No },
+            { "refresh",      HandleCitySiegeRefreshCommand,      SEC_PLAYER, Console::No },
+            { "proto",        HandleCitySiegeProtoCommand,        SEC_PLAYER, Console::No },
             { "mapdata",      HandleCitySiegeMapDataCommand,      SEC_PLAYER, Console::No }
         };
 
@@ -4441,17 +6783,11 @@ public:
             }
         }
 
-        // Check if already active
-        if (cityId != -1)
+        // Check if already active (or its last siege is still tearing down)
+        if (cityId != -1 && IsCityUnderSiege(CityId(cityId)))
         {
-            for (const auto& event : g_ActiveSieges)
-            {
-                if (event.isActive && event.cityId == cityId)
-                {
-                    handler->PSendSysMessage(("City '" + g_Cities[cityId].name + "' is already under siege!").c_str());
-                    return true;
-                }
-            }
+            handler->PSendSysMessage(("City '" + g_Cities[cityId].name + "' is already under siege!").c_str());
+            return true;
         }
 
         // Start the siege
@@ -4557,7 +6893,7 @@ public:
             // Remove inactive events
             g_ActiveSieges.erase(
                 std::remove_if(g_ActiveSieges.begin(), g_ActiveSieges.end(),
-                    [](const SiegeEvent& event) { return !event.isActive; }),
+                    [](const SiegeEvent& event) { return !event.isActive && event.teardownStage == SIEGE_TEARDOWN_DONE; }),
                 g_ActiveSieges.end());
         }
 
@@ -4596,7 +6932,7 @@ public:
         {
             if (cityId == -1 || event.cityId == cityId)
             {
-                FinalizeSiegeCleanup(event, "cleanup");
+                FinalizeSiegeCleanup(event, "cleanup", true, true);
                 handler->PSendSysMessage(("Cleaned up siege creatures in " + g_Cities[event.cityId].name).c_str());
                 cleanedCount++;
 
@@ -4614,7 +6950,7 @@ public:
             // Remove inactive events
             g_ActiveSieges.erase(
                 std::remove_if(g_ActiveSieges.begin(), g_ActiveSieges.end(),
-                    [](const SiegeEvent& event) { return !event.isActive; }),
+                    [](const SiegeEvent& event) { return !event.isActive && event.teardownStage == SIEGE_TEARDOWN_DONE; }),
                 g_ActiveSieges.end());
         }
 
@@ -4626,6 +6962,7 @@ public:
         handler->PSendSysMessage("=== City Siege Status ===");
         handler->PSendSysMessage(("Module Enabled: " + std::string(g_CitySiegeEnabled ? "Yes" : "No")).c_str());
         handler->PSendSysMessage(("Active Sieges: " + std::to_string(g_ActiveSieges.size())).c_str());
+        handler->PSendSysMessage(("Addon Subscribers: " + std::to_string(g_AddonSubscriptions.size())).c_str());
 
         if (!g_ActiveSieges.empty())
         {
@@ -4676,6 +7013,68 @@ public:
                     
                     // Show phase
                     handler->PSendSysMessage(event.cinematicPhase ? "    Phase: Cinematic (RP)" : "    Phase: Combat");
+
+                    // Show respawn queue depth
+                    char respawnInfo[128];
+                    snprintf(respawnInfo, sizeof(respawnInfo), "    Respawn queue: %zu creatures, %zu bots",
+                        event.deadCreatures.Size(), event.deadBots.Size());
+                    handler->PSendSysMessage(respawnInfo);
+
+                    char deathInfo[128];
+                    snprintf(deathInfo, sizeof(deathInfo), "    Deaths: %u attackers, %u defenders, %u bots",
+                        event.attackerDeaths, event.defenderDeaths, event.botDeaths);
+                    handler->PSendSysMessage(deathInfo);
+
+                    size_t squadFollowers = 0;
+                    for (SiegeSquad const& squad : event.squads)
+                        squadFollowers += squad.followers.size();
+
+                    char squadInfo[128];
+                    snprintf(squadInfo, sizeof(squadInfo), "    Squads: %zu (%zu units in formation)",
+                        event.squads.size(), squadFollowers);
+                    handler->PSendSysMessage(squadInfo);
+
+                    char contributionInfo[128];
+                    snprintf(contributionInfo, sizeof(contributionInfo), "    Contributors: %u players",
+                        event.contributions.Size());
+                    handler->PSendSysMessage(contributionInfo);
+
+                    char proximityInfo[128];
+                    snprintf(proximityInfo, sizeof(proximityInfo), "    Proximity grid: %zu entries in %zu cells",
+                        event.proximity.locations.size(), event.proximity.cells.size());
+                    handler->PSendSysMessage(proximityInfo);
+
+                    if (event.replay.IsRecording())
+                    {
+                        char replayInfo[160];
+                        snprintf(replayInfo, sizeof(replayInfo), "    Replay: %llu records, %llu buffered",
+                            (unsigned long long)event.replay.written, (unsigned long long)event.replay.Pending());
+                        handler->PSendSysMessage(replayInfo);
+                    }
+
+#ifdef MOD_PLAYERBOTS
+                    if (g_PlayerbotsEnabled)
+                    {
+                        char recruitInfo[192];
+                        snprintf(recruitInfo, sizeof(recruitInfo), "    Bot recruitment: %u scanned, %u eligible, %u rejected, %u teleported, %zu queued",
+                            event.recruitment.scanned, event.recruitment.eligible, event.recruitment.rejected,
+                            event.recruitment.teleported, event.pendingBotTeleports.size() - event.botTeleportCursor);
+                        handler->PSendSysMessage(recruitInfo);
+
+                        char travelInfo[160];
+                        snprintf(travelInfo, sizeof(travelInfo), "    Bot travel destinations: %zu pooled for this city, %u objects live in all pools",
+                            g_BotTravelPools[event.cityId] ? g_BotTravelPools[event.cityId]->destinations.size() : size_t(0),
+                            g_BotTravelLiveObjects);
+                        handler->PSendSysMessage(travelInfo);
+                    }
+#endif
+                }
+                else if (event.teardownStage != SIEGE_TEARDOWN_DONE)
+                {
+                    char teardownInfo[160];
+                    snprintf(teardownInfo, sizeof(teardownInfo), "  %s - ended, tearing down (%s stage, %u done)",
+                        g_Cities[event.cityId].name.c_str(), SiegeTeardownStageNames[event.teardownStage], event.teardownCursor);
+                    handler->PSendSysMessage(teardownInfo);
                 }
             }
         }
@@ -4693,6 +7092,72 @@ public:
         return true;
     }
 
+    static bool HandleCitySiegePerfCommand(ChatHandler* handler, Optional<std::string> actionArg)
+    {
+        if (actionArg && *actionArg == "reset")
+        {
+            g_PerfGlobal.Reset();
+            for (auto& event : g_ActiveSieges)
+                event.perf.Reset();
+            handler->PSendSysMessage("City Siege perf counters reset.");
+            return true;
+        }
+
+        handler->PSendSysMessage("=== City Siege Performance ===");
+        if (!g_PerfEnabled)
+            handler->PSendSysMessage("Instrumentation is disabled (CitySiege.Perf.Enable = 0); showing the last recorded values.");
+
+        auto showStats = [handler](std::string const& title, SiegePerfStats const& stats)
+        {
+            std::vector<std::string> const lines = FormatSiegePerfStats(stats);
+            handler->PSendSysMessage(("--- " + title + " ---").c_str());
+            if (lines.empty())
+                handler->PSendSysMessage("  No samples recorded.");
+            for (std::string const& line : lines)
+                handler->PSendSysMessage(("  " + line).c_str());
+        };
+
+        showStats("Global", g_PerfGlobal);
+        for (const auto& event : g_ActiveSieges)
+        {
+            if (event.isActive)
+                showStats(g_Cities[event.cityId].name, event.perf);
+        }
+
+        return true;
+    }
+
+    static bool HandleCitySiegeBenchCommand(ChatHandler* handler, Optional<uint32> siegesArg, Optional<uint32> attackersArg,
+        Optional<uint32> defendersArg, Optional<uint32> botsArg, Optional<uint32> playersArg, Optional<uint32> ticksArg)
+    {
+        // Runs on the world thread, so keep runs short: larger runs belong in tools/siege_benchmark.cpp
+        SiegeBenchOptions options;
+        options.sieges = std::clamp<uint32>(siegesArg.value_or(options.sieges), 1, CITY_MAX);
+        options.attackers = std::min<uint32>(attackersArg.value_or(options.attackers), 1000);
+        options.defenders = std::min<uint32>(defendersArg.value_or(options.defenders), 1000);
+        options.bots = std::min<uint32>(botsArg.value_or(options.bots), 200);
+        options.players = std::min<uint32>(playersArg.value_or(options.players), 1000);
+        options.ticks = std::clamp<uint32>(ticksArg.value_or(options.ticks), 1, 6000);
+
+        SiegeBenchResult const result = RunSiegeBenchmark(options);
+
+        char header[256];
+        snprintf(header, sizeof(header), "City Siege bench: %u sieges, %u attackers, %u defenders, %u bots, %u players, %u ticks of %u ms",
+            options.sieges, options.attackers, options.defenders, options.bots, options.players, options.ticks, SIEGE_BENCH_TICK_MS);
+        handler->PSendSysMessage(header);
+
+        char stats[256];
+        snprintf(stats, sizeof(stats), "  %llu ns/tick, %llu broadcasts, %llu packets, %llu bytes broadcast (%llu bytes/broadcast)",
+            (unsigned long long)(result.elapsedNs / options.ticks), (unsigned long long)result.broadcasts,
+            (unsigned long long)result.packets, (unsigned long long)result.bytes,
+            (unsigned long long)(result.broadcasts ? result.bytes / result.broadcasts : 0));
+        handler->PSendSysMessage(stats);
+
+        LOG_INFO("server.loading", "[City Siege] {}", header);
+        LOG_INFO("server.loading", "[City Siege] {}", stats);
+        return true;
+    }
+
     static bool HandleCitySiegeTestWaypointCommand(ChatHandler* handler)
     {
         Player* player = handler->GetSession()->GetPlayer();
@@ -5068,20 +7533,30 @@ public:
 
         const CityData& city = g_Cities[activeSiege->cityId];
 
-        // Get waypoint progress
-        auto it = activeSiege->creatureWaypointProgress.find(unitGuid);
-        if (it == activeSiege->creatureWaypointProgress.end())
+        // Get waypoint progress: creatures keep it in their participant record, playerbots in botWaypointProgress
+        uint32 currentWP = 0;
+        if (isCreature)
         {
-            handler->PSendSysMessage("Selected unit has no waypoint progress data.");
-            return true;
-        }
+            SiegeParticipant const* participant = FindSiegeParticipant(*activeSiege, unitGuid);
+            if (!participant)
+            {
+                handler->PSendSysMessage("Selected unit has no waypoint progress data.");
+                return true;
+            }
 
-        uint32 currentWP = it->second;
+            currentWP = participant->waypoint;
+        }
+        else
+        {
+            auto it = activeSiege->botWaypointProgress.find(unitGuid);
+            if (it == activeSiege->botWaypointProgress.end())
+            {
+                handler->PSendSysMessage("Selected unit has no waypoint progress data.");
+                return true;
+            }
 
-        // Check if this is a defender (marked with +10000)
-        bool isDefenderMarker = (currentWP >= 10000);
-        if (isDefenderMarker)
-            currentWP -= 10000; // Remove marker to get actual waypoint
+            currentWP = it->second;
+        }
 
         // Determine current target location
         float targetX, targetY, targetZ;
@@ -5208,7 +7683,7 @@ public:
         return true;
     }
 
-    static bool HandleCitySiegeSyncCommand(ChatHandler* handler, Optional<uint32> cityIdArg)
+    static bool HandleCitySiegeSyncCommand(ChatHandler* handler, Optional<uint32> cityIdArg, Optional<float> maxDistanceArg)
     {
         Player* player = handler->GetSession()->GetPlayer();
         if (!player)
@@ -5216,6 +7691,18 @@ public:
             return false;
         }
 
+        // Syncing registers (or refreshes) the addon subscription; a distance argument also sets its filters
+        AddonSubscription& subscription = SubscribeAddonClient(player);
+        if (maxDistanceArg)
+        {
+            subscription.cityFilter = cityIdArg && *cityIdArg < CITY_MAX ? *cityIdArg : static_cast<uint32>(CITY_MAX);
+            subscription.maxDistance = std::max(0.0f, *maxDistanceArg);
+        }
+
+        // Advertise the newest addon protocol; addons that speak it answer with .citysiege proto
+        if (GetAddonProtocolVersion(player) < ADDON_PROTOCOL_MAX)
+            SendAddonMessageToPlayer(player, "HELLO:" + std::to_string(ADDON_PROTOCOL_MAX));
+
         // If no city ID provided, sync all cities to this player.
         if (!cityIdArg)
         {
@@ -5261,7 +7748,72 @@ public:
         
         return true;
     }
+
+    static bool HandleCitySiegeRefreshCommand(ChatHandler* handler)
+    {
+        Player* player = handler->GetSession()->GetPlayer();
+        if (!player)
+        {
+            return false;
+        }
+
+        // Keeps an addon subscription from timing out without replaying any siege state
+        SubscribeAddonClient(player);
+        return true;
+    }
+
+    static bool HandleCitySiegeResyncCommand(ChatHandler* handler, uint32 cityId)
+    {
+        Player* player = handler->GetSession()->GetPlayer();
+        if (!player)
+        {
+            return false;
+        }
+
+        // Sent by the addon when a compact delta does not match its baseline: only the keyframe is resent,
+        // since a START would make the client treat the siege it already tracks as a new one
+        SubscribeAddonClient(player);
+        if (cityId >= CITY_MAX)
+        {
+            return true;
+        }
+
+        for (auto& event : g_ActiveSieges)
+        {
+            if (event.isActive && event.cityId == static_cast<int>(cityId))
+            {
+                SendSiegeDataToPlayer(player, event, "UPDATE");
+                return true;
+            }
+        }
+
+        SendAddonMessageToPlayer(player, "END:" + std::to_string(cityId) + ":none");
+        return true;
+    }
     
+    static bool HandleCitySiegeProtoCommand(ChatHandler* handler, uint32 version)
+    {
+        Player* player = handler->GetSession()->GetPlayer();
+        if (!player)
+        {
+            return false;
+        }
+
+        SubscribeAddonClient(player).protocol = std::clamp<uint32>(version, ADDON_PROTOCOL_TEXT, ADDON_PROTOCOL_MAX);
+
+        // Resend the full state of every active siege in the negotiated encoding
+        for (auto& event : g_ActiveSieges)
+        {
+            if (event.isActive)
+            {
+                SendSiegeDataToPlayer(player, event, "START");
+                SendSiegeDataToPlayer(player, event, "UPDATE");
+            }
+        }
+
+        return true;
+    }
+
     static bool HandleCitySiegeMapDataCommand(ChatHandler* handler, Optional<uint32> cityIdArg)
     {
         Player* player = handler->GetSession()->GetPlayer();
@@ -5356,5 +7908,9 @@ public:
 void Addmod_city_siegeScripts()
 {
     new CitySiegeWorldScript();
+    new CitySiegeUnitScript();
+    new CitySiegeCreatureScript();
+    new CitySiegeMapScript();
+    new CitySiegePlayerScript();
     new citysiege_commandscript();
 }
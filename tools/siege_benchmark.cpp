@@ -0,0 +1,824 @@
+/*
+ * This file is part of the AzerothCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ */
+
+/**
+ * @file siege_benchmark.cpp
+ * @brief Offline benchmark of a siege tick: the map work (src/CitySiegeUpdate.h) and the addon
+ * UPDATE broadcasts (src/CitySiegeNet.h).
+ *
+ * Runs the module's own RunSiegeMapWork against a synthetic world: units walk their splines at a fixed
+ * speed, ground heights come from a formula and players wander around the city center. Bots march the
+ * route on their own. On the broadcast interval the live positions are serialized with the module's
+ * SerializeSiegeUpdate and fanned out to the players like BroadcastSiegeDataToAddon: full rate inside the
+ * full-rate radius, the summary tier beyond it, every other player on the compact protocol.
+ * Only RunSiegeMapWork and the broadcast are measured; stepping the synthetic units stands in for the core's update.
+ *
+ * Standalone; it is not part of the module build and only needs the standard library:
+ *     g++ -std=c++17 -O2 -o siege_benchmark tools/siege_benchmark.cpp
+ *
+ * Usage: siege_benchmark [--sieges N] [--attackers N] [--defenders N] [--squad N] [--bots N] [--players N]
+ *                        [--ticks N] [--tick-ms N] [--budget US] [--deaths N] [--respawn S] [--seed N]
+ *                        [--broadcast-ms N] [--summary-ms N] [--full-rate YARDS]
+ */
+
+#include "../src/CitySiegeNet.h"
+#include "../src/CitySiegeReplay.h"
+#include "../src/CitySiegeUpdate.h"
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <random>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace
+{
+    using Guid = std::uint64_t;
+    using Role = CitySiegeReplay::Role;
+
+    constexpr float UNIT_SPEED = 7.0f;          // Yards per second, roughly a running creature
+    constexpr float SEGMENT_STEP = 10.0f;       // Yards between two sampled nodes of a straight route segment
+    constexpr std::uint32_t STOP_SLOTS = 8;     // Spread positions around each route stop
+    constexpr float STOP_SLOT_RADIUS = 3.0f;
+    constexpr std::uint32_t COMBAT_MS = 4000;   // How long a unit fights before a death is rolled
+
+    struct Options
+    {
+        std::uint32_t sieges = 1;
+        std::uint32_t attackers = 300;
+        std::uint32_t defenders = 100;
+        std::uint32_t squad = 5;         // Units per squad (leader included), 1 = every unit moves on its own
+        std::uint32_t bots = 20;         // Playerbots per siege, split evenly between both sides
+        std::uint32_t players = 200;     // Players per siege, half of them inside the announce radius
+        std::uint32_t ticks = 6000;      // 5 minutes of siege at the default tick length
+        std::uint32_t tickMs = 50;
+        std::uint32_t budgetUs = 0;      // CitySiege.Scheduler.TickBudget, 0 = unlimited
+        std::uint32_t deaths = 60;       // Deaths per siege and minute
+        std::uint32_t respawn = 30;      // Respawn delay in seconds
+        std::uint32_t seed = 1;
+        std::uint32_t broadcastMs = 30000; // CitySiege.Scheduler.BroadcastInterval
+        std::uint32_t summaryMs = 120000;  // CitySiege.Addon.SummaryInterval
+        std::uint32_t fullRate = 1000;     // CitySiege.Addon.FullRateRadius, 0 = everyone
+        std::uint32_t duration = 30 * 60;  // CitySiege.EventDuration in seconds, for the UPDATE timers
+    };
+
+    struct RespawnData
+    {
+        Guid guid;
+        std::uint32_t entry;
+        std::uint32_t deathTime;
+        bool isDefender;
+    };
+
+    // The fields RunSiegeMapWork and the addon broadcast read from the module's SiegeEvent
+    struct Event
+    {
+        CityId cityId = CITY_STORMWIND;
+        bool cinematicPhase = false;
+        SiegeScheduler scheduler;
+        BasicSiegeParticipantRegistry<Guid, Role> participants;
+        std::vector<BasicSiegeSquad<Guid>> squads;
+        BasicSiegeSpatialGrid<Guid> proximity;
+        BasicSiegeRespawnQueue<Guid, RespawnData> deadCreatures;
+        std::vector<Guid> attackerBots;
+        std::vector<Guid> defenderBots;
+        SiegeAddonBaseline addonBaseline;
+    };
+
+    using Participant = BasicSiegeParticipant<Guid, Role>;
+
+    struct Unit
+    {
+        Guid guid = 0;
+        Waypoint position{};
+        std::vector<Waypoint> path;      // Remaining spline points
+        Guid followLeader = 0;
+        float followDistance = 0.0f;
+        float followAngle = 0.0f;
+        Waypoint home{};
+        std::uint32_t combatUntil = 0;   // Simulated ms the unit stays in combat until
+        bool alive = true;
+    };
+
+    struct Player
+    {
+        Guid guid;
+        Waypoint position;
+    };
+
+    struct Counters
+    {
+        std::uint64_t splines = 0;
+        std::uint64_t rejoins = 0;
+        std::uint64_t follows = 0;
+        std::uint64_t heightQueries = 0;
+        std::uint64_t respawns = 0;
+        std::uint64_t waypoints = 0;
+        std::uint64_t presenceCredits = 0;
+        std::uint64_t deaths = 0;
+        std::array<std::uint64_t, 3> phaseNs{};
+        std::array<std::uint64_t, 3> phaseItems{};
+        std::uint64_t broadcasts = 0;
+        std::uint64_t broadcastNs = 0;
+        std::uint64_t packets = 0;
+        std::uint64_t bytes = 0;
+    };
+
+    char const* const PhaseNames[] = { "movement", "respawn", "leader check" };
+
+    /**
+     * @brief Times one phase of the map work, like the module's SiegePerfTimer.
+     */
+    class PhaseTimer
+    {
+    public:
+        PhaseTimer(Counters& counters, SiegeMapWorkPhase phase)
+            : _counters(counters), _phase(phase), _start(std::chrono::steady_clock::now()) { }
+
+        PhaseTimer(PhaseTimer const&) = delete;
+        PhaseTimer& operator=(PhaseTimer const&) = delete;
+
+        ~PhaseTimer()
+        {
+            _counters.phaseNs[_phase] += std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now() - _start).count();
+        }
+
+        void AddItems(std::uint32_t items) { _counters.phaseItems[_phase] += items; }
+
+    private:
+        Counters& _counters;
+        SiegeMapWorkPhase _phase;
+        std::chrono::steady_clock::time_point _start;
+    };
+
+    float Distance(Waypoint const& a, Waypoint const& b)
+    {
+        return std::sqrt((a.x - b.x) * (a.x - b.x) + (a.y - b.y) * (a.y - b.y) + (a.z - b.z) * (a.z - b.z));
+    }
+
+    /**
+     * @brief The World of CitySiegeUpdate.h for one synthetic siege.
+     */
+    class SyntheticWorld
+    {
+    public:
+        SyntheticWorld(CityData const& city, Counters& counters, std::mt19937& random)
+            : _counters(counters), _random(random)
+        {
+            BuildRoute(city);
+        }
+
+        // Map lookup
+        Unit* FindUnit(Guid guid)
+        {
+            auto itr = _units.find(guid);
+            return itr != _units.end() ? &itr->second : nullptr;
+        }
+
+        bool IsAlive(Unit* unit) const { return unit->alive; }
+        bool IsInCombat(Unit* unit) const { return unit->combatUntil > _nowMs; }
+        bool IsMoving(Unit* unit) const { return !unit->path.empty(); }
+        bool IsFollowing(Unit* unit) const { return unit->followLeader != 0; }
+        Waypoint GetPosition(Unit* unit) const { return unit->position; }
+        float GetDistance(Unit* unit, Waypoint const& point) const { return Distance(unit->position, point); }
+        std::uint32_t GetSpreadSeed(Unit* unit) const { return std::uint32_t(unit->guid); }
+        void AnchorHome(Unit* unit) const { unit->home = unit->position; }
+        void EnforceGrounding(Unit*) const { }
+
+        // Height query
+        bool GetGroundHeight(float x, float y, float /*z*/, float& groundZ)
+        {
+            ++_counters.heightQueries;
+            groundZ = Terrain(x, y);
+            return true;
+        }
+
+        // Spline launch
+        void MoveTo(Unit* unit, Waypoint const& point)
+        {
+            ++_counters.rejoins;
+            unit->followLeader = 0;
+            unit->path.assign(1, point);
+        }
+
+        void MoveByPath(Unit* unit, std::vector<Waypoint> const& points)
+        {
+            ++_counters.splines;
+            unit->followLeader = 0;
+            unit->path.assign(points.begin() + 1, points.end());
+            std::reverse(unit->path.begin(), unit->path.end()); // Consumed from the back
+        }
+
+        void Follow(Unit* follower, Unit* leader, float distance, float angle)
+        {
+            ++_counters.follows;
+            follower->path.clear();
+            follower->followLeader = leader->guid;
+            follower->followDistance = distance;
+            follower->followAngle = angle;
+        }
+
+        // Player iteration
+        template<class Fn>
+        void ForEachPlayer(float x, float y, float z, float range, Fn&& fn) const
+        {
+            Waypoint const center{ x, y, z };
+            for (Player const& player : _players)
+                if (range <= 0.0f || Distance(player.position, center) <= range)
+                    fn(player.guid, player.position);
+        }
+
+        // Siege hooks
+        SiegeRoute const* GetRoute(CityData const&, Unit*) const { return &_route; }
+
+        Unit* RespawnUnit(Event& event, Participant& participant, RespawnData const& respawnData, Waypoint const& position)
+        {
+            _units.erase(respawnData.guid);
+            Unit* unit = Spawn(position);
+            event.participants.Replace(respawnData.guid, unit->guid);
+            event.proximity.Remove(respawnData.guid);
+            participant.squadId = 0; // Respawned units move on their own, as in the module
+            ++_counters.respawns;
+            return unit;
+        }
+
+        void OnWaypointReached(Event&, Participant const&, Unit*) { ++_counters.waypoints; }
+        void CreditPresence(Event&, Guid const&, std::uint32_t) { ++_counters.presenceCredits; }
+        bool IsLeaderDefeated(Event&) const { return false; }
+        void OnLeaderDefeated(Event&) const { }
+        void SampleLeaderHealth(Event&) const { }
+
+        float RandomFloat(float min, float max)
+        {
+            return std::uniform_real_distribution<float>(min, max)(_random);
+        }
+
+        PhaseTimer StartTimer(Event&, SiegeMapWorkPhase phase) { return PhaseTimer(_counters, phase); }
+
+        // Synthetic side, not part of the World interface
+
+        float Terrain(float x, float y) const
+        {
+            return _baseZ + 4.0f * std::sin(x / 37.0f) * std::cos(y / 53.0f);
+        }
+
+        Unit* Spawn(Waypoint const& position)
+        {
+            Unit& unit = _units[++_nextGuid];
+            unit.guid = _nextGuid;
+            unit.position = position;
+            unit.home = position;
+            return &unit;
+        }
+
+        /**
+         * @brief Spawns a bot walking the whole route, forward from the spawn point or reverse from the leader.
+         * Bots are not siege participants; only the addon broadcast reports them.
+         */
+        Guid SpawnBot(bool isDefender)
+        {
+            std::vector<Waypoint> const& stops = _route.stops;
+            Waypoint const& start = isDefender ? stops.back() : stops.front();
+            float const x = start.x + RandomFloat(-10.0f, 10.0f);
+            float const y = start.y + RandomFloat(-10.0f, 10.0f);
+            Unit* unit = Spawn({ x, y, Terrain(x, y) });
+
+            // Consumed from the back, so the forward route is stored reversed
+            if (isDefender)
+                unit->path.assign(stops.begin(), stops.end());
+            else
+                unit->path.assign(stops.rbegin(), stops.rend());
+            return unit->guid;
+        }
+
+        void AddPlayers(CityData const& city, std::uint32_t count, float announceRadius)
+        {
+            // Half inside the announce radius, the rest out to twice of it
+            for (std::uint32_t i = 0; i < count; ++i)
+            {
+                float const maxDist = (i % 2 == 0 ? 1.0f : 2.0f) * std::max(announceRadius, 100.0f);
+                float const angle = RandomFloat(0.0f, 6.2831853f);
+                float const dist = RandomFloat(0.0f, maxDist);
+                float const x = city.centerX + dist * std::cos(angle);
+                float const y = city.centerY + dist * std::sin(angle);
+                _players.push_back({ (Guid(1) << 48) | i, { x, y, Terrain(x, y) } });
+            }
+        }
+
+        /**
+         * @brief Moves every unit along its spline or after its leader, and players a few yards at random.
+         */
+        void Step(std::uint32_t diffMs)
+        {
+            _nowMs += diffMs;
+            float const step = UNIT_SPEED * diffMs / 1000.0f;
+
+            for (auto& [guid, unit] : _units)
+            {
+                if (!unit.alive || IsInCombat(&unit))
+                    continue;
+
+                if (unit.followLeader)
+                {
+                    Unit* leader = FindUnit(unit.followLeader);
+                    if (!leader || !leader->alive)
+                    {
+                        unit.followLeader = 0;
+                        continue;
+                    }
+
+                    Waypoint const target{ leader->position.x + unit.followDistance * std::cos(unit.followAngle),
+                        leader->position.y + unit.followDistance * std::sin(unit.followAngle), leader->position.z };
+                    MoveTowards(unit, target, step);
+                    continue;
+                }
+
+                float remaining = step;
+                while (!unit.path.empty() && remaining > 0.0f)
+                {
+                    float const dist = Distance(unit.position, unit.path.back());
+                    if (dist > remaining)
+                    {
+                        MoveTowards(unit, unit.path.back(), remaining);
+                        break;
+                    }
+
+                    unit.position = unit.path.back();
+                    unit.path.pop_back();
+                    remaining -= dist;
+                }
+            }
+
+            for (Player& player : _players)
+            {
+                player.position.x += RandomFloat(-1.0f, 1.0f);
+                player.position.y += RandomFloat(-1.0f, 1.0f);
+            }
+        }
+
+        /**
+         * @brief Puts a random alive unit into a fight it dies in after COMBAT_MS.
+         */
+        void StartFight(Event& event)
+        {
+            auto const& records = event.participants.records;
+            if (records.empty())
+                return;
+
+            Unit* unit = FindUnit(records[_random() % records.size()].guid);
+            if (!unit || !unit->alive || IsInCombat(unit))
+                return;
+
+            unit->combatUntil = _nowMs + COMBAT_MS;
+            unit->path.clear();
+            unit->followLeader = 0;
+            _fighting.push_back(unit->guid);
+        }
+
+        /**
+         * @brief Kills the units whose fight is over; the squad hand-over and the respawn queue are
+         * done like the module's creature death hook.
+         */
+        void ResolveFights(Event& event, std::uint32_t currentTime, std::uint32_t respawnDelay)
+        {
+            auto dead = std::partition(_fighting.begin(), _fighting.end(), [this](Guid guid)
+            {
+                Unit* unit = FindUnit(guid);
+                return unit && IsInCombat(unit);
+            });
+
+            for (auto itr = dead; itr != _fighting.end(); ++itr)
+            {
+                Unit* unit = FindUnit(*itr);
+                Participant* participant = event.participants.Find(*itr);
+                if (!unit || !participant)
+                    continue;
+
+                unit->alive = false;
+                ++_counters.deaths;
+                LeaveSquad(event, *participant);
+                event.deadCreatures.Push(participant->guid, currentTime + respawnDelay,
+                    { participant->guid, 0, currentTime, participant->role == Role::Defender });
+            }
+
+            _fighting.erase(dead, _fighting.end());
+        }
+
+    private:
+        void BuildRoute(CityData const& city)
+        {
+            _baseZ = city.centerZ;
+            _route.stops.push_back({ city.spawnX, city.spawnY, Terrain(city.spawnX, city.spawnY) });
+            for (Waypoint const& wp : city.waypoints)
+                _route.stops.push_back({ wp.x, wp.y, Terrain(wp.x, wp.y) });
+            _route.stops.push_back({ city.leaderX, city.leaderY, Terrain(city.leaderX, city.leaderY) });
+
+            for (Waypoint const& stop : _route.stops)
+            {
+                std::vector<Waypoint> slots;
+                for (std::uint32_t i = 0; i < STOP_SLOTS; ++i)
+                {
+                    float const angle = 6.2831853f * i / STOP_SLOTS;
+                    float const x = stop.x + STOP_SLOT_RADIUS * std::cos(angle);
+                    float const y = stop.y + STOP_SLOT_RADIUS * std::sin(angle);
+                    slots.push_back({ x, y, Terrain(x, y) });
+                }
+                _route.stopSlots.push_back(std::move(slots));
+            }
+
+            for (std::size_t i = 0; i + 1 < _route.stops.size(); ++i)
+            {
+                Waypoint const& from = _route.stops[i];
+                Waypoint const& to = _route.stops[i + 1];
+                std::uint32_t const steps = std::max(1u, std::uint32_t(Distance(from, to) / SEGMENT_STEP));
+
+                std::vector<Waypoint> segment;
+                for (std::uint32_t step = 0; step <= steps; ++step)
+                {
+                    float const t = float(step) / steps;
+                    float const x = from.x + (to.x - from.x) * t;
+                    float const y = from.y + (to.y - from.y) * t;
+                    segment.push_back({ x, y, Terrain(x, y) });
+                }
+                _route.segments.push_back(std::move(segment));
+            }
+        }
+
+        void MoveTowards(Unit& unit, Waypoint const& target, float step) const
+        {
+            float const dist = Distance(unit.position, target);
+            if (dist <= step)
+            {
+                unit.position = target;
+                return;
+            }
+
+            float const factor = step / dist;
+            unit.position.x += (target.x - unit.position.x) * factor;
+            unit.position.y += (target.y - unit.position.y) * factor;
+            unit.position.z += (target.z - unit.position.z) * factor;
+        }
+
+        void LeaveSquad(Event& event, Participant& participant)
+        {
+            if (!participant.squadId)
+                return;
+
+            BasicSiegeSquad<Guid>& squad = event.squads[participant.squadId - 1];
+            participant.squadId = 0;
+
+            if (squad.leader != participant.guid)
+            {
+                squad.followers.erase(std::remove(squad.followers.begin(), squad.followers.end(), participant.guid),
+                    squad.followers.end());
+                return;
+            }
+
+            squad.leader = 0;
+            if (squad.followers.empty())
+                return;
+
+            squad.leader = squad.followers.front();
+            squad.followers.erase(squad.followers.begin());
+            if (Participant* newLeader = event.participants.Find(squad.leader))
+                newLeader->waypoint = participant.waypoint;
+            if (Unit* unit = FindUnit(squad.leader))
+                unit->followLeader = 0;
+            for (Guid follower : squad.followers)
+                if (Unit* unit = FindUnit(follower))
+                    unit->followLeader = 0; // Re-formed on the new leader by the next movement pass
+        }
+
+        Counters& _counters;
+        std::mt19937& _random;
+        SiegeRoute _route;
+        std::unordered_map<Guid, Unit> _units;
+        std::vector<Player> _players;
+        std::vector<Guid> _fighting;
+        Guid _nextGuid = 0;
+        std::uint32_t _nowMs = 0;
+        float _baseZ = 0.0f;
+    };
+
+    struct Siege
+    {
+        CityData city;
+        Event event;
+        SyntheticWorld world;
+
+        Siege(CityData const& cityData, Counters& counters, std::mt19937& random)
+            : city(cityData), world(city, counters, random) { }
+    };
+
+    /**
+     * @brief A city laid out like the module's defaults: spawn point 400 yards out, a few waypoints, then the leader.
+     */
+    CityData MakeCity(std::uint32_t index)
+    {
+        CityData city;
+        city.id = CityId(index % CITY_MAX);
+        city.name = "city " + std::to_string(index);
+        city.mapId = 0;
+        city.centerX = 1000.0f * index;
+        city.centerY = 0.0f;
+        city.centerZ = 50.0f;
+        city.leaderX = city.centerX + 40.0f;
+        city.leaderY = 20.0f;
+        city.leaderZ = city.centerZ;
+        city.spawnX = city.centerX - 400.0f;
+        city.spawnY = -150.0f;
+        city.spawnZ = city.centerZ;
+        city.targetLeaderEntry = 0;
+        for (std::uint32_t i = 1; i <= 5; ++i)
+        {
+            float const t = i / 6.0f;
+            city.waypoints.push_back({ city.spawnX + (city.leaderX - city.spawnX) * t + (i % 2 ? 30.0f : -30.0f),
+                city.spawnY + (city.leaderY - city.spawnY) * t, city.centerZ });
+        }
+        return city;
+    }
+
+    /**
+     * @brief Registers the armies like the module's spawn pipeline: attackers at the spawn point in squads,
+     * defenders around the leader walking the route in reverse.
+     */
+    void SetupSiege(Siege& siege, Options const& options, SiegeMapWorkSettings const& settings)
+    {
+        Event& event = siege.event;
+        CityData const& city = siege.city;
+        event.cityId = city.id;
+
+        auto addUnits = [&](std::uint32_t count, Role role, Waypoint const& around)
+        {
+            for (std::uint32_t i = 0; i < count; ++i)
+            {
+                float const angle = siege.world.RandomFloat(0.0f, 6.2831853f);
+                float const dist = siege.world.RandomFloat(0.0f, 35.0f);
+                float const x = around.x + dist * std::cos(angle);
+                float const y = around.y + dist * std::sin(angle);
+                Unit* unit = siege.world.Spawn({ x, y, siege.world.Terrain(x, y) });
+
+                Participant participant;
+                participant.guid = unit->guid;
+                participant.roleSlot = i;
+                participant.role = role;
+                participant.tier = role == Role::Defender ? SIEGE_TIER_DEFENDER : SIEGE_TIER_MINION;
+                participant.faction = role == Role::Defender ? 0 : 1;
+                participant.direction = role == Role::Defender ? SIEGE_ROUTE_REVERSE : SIEGE_ROUTE_FORWARD;
+                ResetParticipantRoute(participant, city);
+
+                // Consecutive attackers march together
+                if (role == Role::Attacker && options.squad > 1)
+                {
+                    if (i % options.squad == 0)
+                        event.squads.push_back({ unit->guid, {} });
+                    else
+                        event.squads.back().followers.push_back(unit->guid);
+                    participant.squadId = event.squads.size();
+                }
+
+                event.participants.slots[unit->guid] = event.participants.records.size();
+                event.participants.records.push_back(participant);
+            }
+        };
+
+        addUnits(options.attackers, Role::Attacker, { city.spawnX, city.spawnY, city.spawnZ });
+        addUnits(options.defenders, Role::Defender, { city.leaderX, city.leaderY, city.leaderZ });
+        for (std::uint32_t i = 0; i < options.bots - options.bots / 2; ++i)
+            event.attackerBots.push_back(siege.world.SpawnBot(false));
+        for (std::uint32_t i = 0; i < options.bots / 2; ++i)
+            event.defenderBots.push_back(siege.world.SpawnBot(true));
+        siege.world.AddPlayers(city, options.players, float(settings.announceRadius));
+
+        // The first UPDATE goes out on the first tick, as the module's bench does
+        event.scheduler.Reset();
+        event.scheduler.elapsed[SIEGE_SUBSYSTEM_BROADCAST] = options.broadcastMs;
+        event.scheduler.elapsed[SIEGE_SUBSYSTEM_SUMMARY] = options.summaryMs;
+    }
+
+    /**
+     * @brief Collects the UPDATE state like the module's CollectSiegeAddonSnapshot.
+     */
+    SiegeAddonSnapshot CollectSnapshot(Siege& siege, Options const& options, std::uint32_t elapsed)
+    {
+        Event& event = siege.event;
+        SiegeAddonSnapshot snapshot;
+        snapshot.elapsed = elapsed;
+        snapshot.remaining = options.duration > elapsed ? options.duration - elapsed : 0;
+        snapshot.leaderHealthPct = 100.0f;
+        if (elapsed > options.duration * 0.75f)
+            snapshot.phase = 4;
+        else if (elapsed > options.duration * 0.5f)
+            snapshot.phase = 3;
+        else if (elapsed > options.duration * 0.25f)
+            snapshot.phase = 2;
+
+        for (Participant const& participant : event.participants.records)
+        {
+            bool const isDefender = participant.role == Role::Defender;
+            ++(isDefender ? snapshot.defenderCount : snapshot.attackerCount);
+
+            Unit* unit = siege.world.FindUnit(participant.guid);
+            if (!unit || !unit->alive)
+                continue;
+
+            snapshot.positions[isDefender ? SIEGE_NET_DEFENDERS : SIEGE_NET_ATTACKERS].push_back(
+                { unit->position.x, unit->position.y, unit->position.z });
+        }
+
+        auto collectBots = [&](SiegeNetSection section, std::vector<Guid> const& guids)
+        {
+            for (Guid guid : guids)
+                if (Unit* unit = siege.world.FindUnit(guid))
+                    snapshot.positions[section].push_back({ unit->position.x, unit->position.y, unit->position.z });
+        };
+
+        collectBots(SIEGE_NET_ATTACKER_BOTS, event.attackerBots);
+        collectBots(SIEGE_NET_DEFENDER_BOTS, event.defenderBots);
+        return snapshot;
+    }
+
+    /**
+     * @brief Serializes an UPDATE when the broadcast is due and adds up the packets each player would receive,
+     * like the module's BroadcastSiegeDataToAddon.
+     */
+    void BroadcastSiege(Siege& siege, Options const& options, std::uint32_t elapsed, Counters& counters)
+    {
+        Event& event = siege.event;
+        if (!event.scheduler.ConsumeIfDue(SIEGE_SUBSYSTEM_BROADCAST, options.broadcastMs))
+            return;
+
+        bool const summaryDue = event.scheduler.ConsumeIfDue(SIEGE_SUBSYSTEM_SUMMARY, options.summaryMs);
+        SiegeAddonSnapshot snapshot = CollectSnapshot(siege, options, elapsed);
+        SiegeUpdateMessages const messages = SerializeSiegeUpdate(siege.city, event.addonBaseline, snapshot, summaryDue);
+
+        std::size_t const textSize = GetAddonMessagePacketSize(messages.text);
+        std::size_t const compactSize = GetAddonMessagePacketSize(messages.compact);
+        std::size_t const summaryTextSize = summaryDue ? GetAddonMessagePacketSize(messages.summaryText) : 0;
+        std::size_t const summaryCompactSize = summaryDue ? GetAddonMessagePacketSize(messages.summaryCompact) : 0;
+        ++counters.broadcasts;
+
+        Waypoint const center{ siege.city.centerX, siege.city.centerY, siege.city.centerZ };
+        siege.world.ForEachPlayer(center.x, center.y, center.z, 0.0f, [&](Guid guid, Waypoint const& position)
+        {
+            bool const compact = guid % 2 == 0;
+            bool const fullRate = !options.fullRate || Distance(position, center) <= options.fullRate;
+            if (!fullRate && !summaryDue)
+                return;
+
+            if (fullRate)
+                counters.bytes += compact ? compactSize : textSize;
+            else
+                counters.bytes += compact ? summaryCompactSize : summaryTextSize;
+            ++counters.packets;
+        });
+    }
+
+    bool ParseOptions(int argc, char** argv, Options& options)
+    {
+        struct Flag
+        {
+            char const* name;
+            std::uint32_t* value;
+        };
+
+        Flag const flags[] =
+        {
+            { "--sieges", &options.sieges }, { "--attackers", &options.attackers }, { "--defenders", &options.defenders },
+            { "--squad", &options.squad }, { "--bots", &options.bots }, { "--players", &options.players },
+            { "--ticks", &options.ticks }, { "--tick-ms", &options.tickMs }, { "--budget", &options.budgetUs },
+            { "--deaths", &options.deaths }, { "--respawn", &options.respawn }, { "--seed", &options.seed },
+            { "--broadcast-ms", &options.broadcastMs }, { "--summary-ms", &options.summaryMs },
+            { "--full-rate", &options.fullRate },
+        };
+
+        for (int i = 1; i < argc; ++i)
+        {
+            Flag const* flag = std::find_if(std::begin(flags), std::end(flags),
+                [&](Flag const& candidate) { return std::strcmp(argv[i], candidate.name) == 0; });
+            if (flag == std::end(flags) || i + 1 >= argc)
+                return false;
+
+            *flag->value = std::uint32_t(std::strtoul(argv[++i], nullptr, 10));
+        }
+
+        options.sieges = std::max(options.sieges, 1u);
+        options.ticks = std::max(options.ticks, 1u);
+        options.tickMs = std::max(options.tickMs, 1u);
+        return true;
+    }
+
+    std::uint64_t Percentile(std::vector<std::uint64_t> sorted, double fraction)
+    {
+        std::sort(sorted.begin(), sorted.end());
+        return sorted[std::min(sorted.size() - 1, std::size_t(fraction * sorted.size()))];
+    }
+}
+
+int main(int argc, char** argv)
+{
+    Options options;
+    if (!ParseOptions(argc, argv, options))
+    {
+        std::fprintf(stderr, "Usage: %s [--sieges N] [--attackers N] [--defenders N] [--squad N] [--bots N] [--players N]\n"
+            "       [--ticks N] [--tick-ms N] [--budget US] [--deaths N] [--respawn S] [--seed N]\n"
+            "       [--broadcast-ms N] [--summary-ms N] [--full-rate YARDS]\n", argv[0]);
+        return 1;
+    }
+
+    SiegeMapWorkSettings settings; // The module's defaults, with contributions on
+    settings.creditPresence = true;
+    Counters counters;
+    std::mt19937 random(options.seed);
+
+    std::vector<std::unique_ptr<Siege>> sieges;
+    for (std::uint32_t i = 0; i < options.sieges; ++i)
+    {
+        sieges.push_back(std::make_unique<Siege>(MakeCity(i), counters, random));
+        SetupSiege(*sieges.back(), options, settings);
+    }
+
+    // Fights start at an even rate, each one ends with a death
+    double const fightsPerTick = double(options.deaths) * options.tickMs / 60000.0;
+    double pendingFights = 0.0;
+
+    std::vector<std::uint64_t> tickNs;
+    tickNs.reserve(options.ticks);
+    std::uint64_t nowMs = 0;
+
+    for (std::uint32_t tick = 0; tick < options.ticks; ++tick)
+    {
+        nowMs += options.tickMs;
+        std::uint32_t const currentTime = std::uint32_t(nowMs / 1000);
+
+        pendingFights += fightsPerTick;
+        std::uint32_t const fights = std::uint32_t(pendingFights);
+        pendingFights -= fights;
+
+        for (auto& siege : sieges)
+        {
+            siege->world.Step(options.tickMs);
+            for (std::uint32_t fight = 0; fight < fights; ++fight)
+                siege->world.StartFight(siege->event);
+            siege->world.ResolveFights(siege->event, currentTime, options.respawn);
+            siege->event.scheduler.Advance(options.tickMs);
+        }
+
+        // The budget is shared by every siege of the tick, as on a map update thread
+        auto const start = std::chrono::steady_clock::now();
+        SiegeTickBudget const budget(options.budgetUs);
+        for (auto& siege : sieges)
+            RunSiegeMapWork(siege->event, siege->world, siege->city, settings, currentTime, budget);
+
+        auto const broadcastStart = std::chrono::steady_clock::now();
+        for (auto& siege : sieges)
+            BroadcastSiege(*siege, options, currentTime, counters);
+        counters.broadcastNs += std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now() - broadcastStart).count();
+
+        tickNs.push_back(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start).count());
+    }
+
+    std::uint64_t totalNs = 0;
+    for (std::uint64_t ns : tickNs)
+        totalNs += ns;
+
+    std::printf("=== %u sieges, %u attackers (squads of %u), %u defenders, %u bots, %u players, %u ticks of %u ms, budget %u us ===\n",
+        options.sieges, options.attackers, options.squad, options.defenders, options.bots, options.players, options.ticks,
+        options.tickMs, options.budgetUs);
+    std::printf("Tick:           %llu ns average, p50 %llu ns, p99 %llu ns, max %llu ns\n",
+        (unsigned long long)(totalNs / tickNs.size()), (unsigned long long)Percentile(tickNs, 0.50),
+        (unsigned long long)Percentile(tickNs, 0.99), (unsigned long long)*std::max_element(tickNs.begin(), tickNs.end()));
+
+    for (std::size_t phase = 0; phase < std::size(PhaseNames); ++phase)
+    {
+        std::printf("%-15s %llu us over %llu items\n", (std::string(PhaseNames[phase]) + ":").c_str(),
+            (unsigned long long)(counters.phaseNs[phase] / 1000), (unsigned long long)counters.phaseItems[phase]);
+    }
+
+    std::printf("Splines:        %llu route legs, %llu rejoins, %llu follows\n", (unsigned long long)counters.splines,
+        (unsigned long long)counters.rejoins, (unsigned long long)counters.follows);
+    std::printf("Height queries: %llu\n", (unsigned long long)counters.heightQueries);
+    std::printf("Deaths:         %llu, %llu respawned\n", (unsigned long long)counters.deaths, (unsigned long long)counters.respawns);
+    std::printf("Stops reached:  %llu\n", (unsigned long long)counters.waypoints);
+    std::printf("Presence:       %llu credits\n", (unsigned long long)counters.presenceCredits);
+
+    std::uint64_t const broadcasts = std::max<std::uint64_t>(counters.broadcasts, 1);
+    std::printf("Broadcasts:     %llu every %u ms, %llu bytes per broadcast in %llu packets, %llu ns per broadcast\n",
+        (unsigned long long)counters.broadcasts, options.broadcastMs, (unsigned long long)(counters.bytes / broadcasts),
+        (unsigned long long)(counters.packets / broadcasts), (unsigned long long)(counters.broadcastNs / broadcasts));
+    return 0;
+}
@@ -0,0 +1,279 @@
+/*
+ * This file is part of the AzerothCore Project. See AUTHORS file for Copyright information
+ *
+ * This program is free software; you can redistribute it and/or modify it
+ * under the terms of the GNU Affero General Public License as published by the
+ * Free Software Foundation; either version 3 of the License, or (at your
+ * option) any later version.
+ */
+
+/**
+ * @file siege_replay_reader.cpp
+ * @brief Offline reader for the siege replays written with CitySiege.Replay.Enable.
+ *
+ * Standalone; it is not part of the module build and only needs the standard library:
+ *     g++ -std=c++17 -O2 -o siege_replay_reader tools/siege_replay_reader.cpp
+ *
+ * Usage: siege_replay_reader [--timeline] <replay.csr>...
+ * Prints summary stats of every replay, and with --timeline every recorded event first.
+ */
+
+#include "../src/CitySiegeReplay.h"
+#include <algorithm>
+#include <array>
+#include <cstdio>
+#include <cstring>
+#include <fstream>
+#include <map>
+#include <string>
+#include <vector>
+
+using namespace CitySiegeReplay;
+
+namespace
+{
+    // Same order as the module's CityId enum
+    char const* const CityNames[] =
+    {
+        "Stormwind", "Ironforge", "Darnassus", "Exodar", "Orgrimmar", "Undercity", "Thunder Bluff", "Silvermoon"
+    };
+
+    char const* const TeardownStageNames[] = { "none", "bots", "creatures", "world" };
+
+    char const* CityName(std::uint32_t cityId)
+    {
+        return cityId < std::size(CityNames) ? CityNames[cityId] : "unknown city";
+    }
+
+    char const* RoleName(Role role)
+    {
+        switch (role)
+        {
+            case Role::Attacker: return "attacker";
+            case Role::Defender: return "defender";
+            default:             return "-";
+        }
+    }
+
+    char const* EventName(EventType type)
+    {
+        switch (type)
+        {
+            case EventType::Spawn:        return "SPAWN";
+            case EventType::Death:        return "DEATH";
+            case EventType::Respawn:      return "RESPAWN";
+            case EventType::Waypoint:     return "WAYPOINT";
+            case EventType::LeaderHealth: return "LEADER_HP";
+            case EventType::BotRecruit:   return "BOT_RECRUIT";
+            case EventType::BotDeath:     return "BOT_DEATH";
+            case EventType::Broadcast:    return "BROADCAST";
+            case EventType::CombatStart:  return "COMBAT_START";
+            case EventType::Teardown:     return "TEARDOWN";
+            case EventType::End:          return "END";
+            case EventType::Dropped:      return "DROPPED";
+            default:                      return "UNKNOWN";
+        }
+    }
+
+    std::string FormatTime(std::uint32_t timeMs)
+    {
+        char buffer[32];
+        std::snprintf(buffer, sizeof(buffer), "%02u:%02u.%03u", timeMs / 60000, (timeMs / 1000) % 60, timeMs % 1000);
+        return buffer;
+    }
+
+    /**
+     * @brief Reads a replay file. Trailing bytes of a record cut off by a crash are ignored.
+     * @return False if the file is missing or not a replay of a known version.
+     */
+    bool ReadReplay(char const* path, FileHeader& header, std::vector<Record>& records)
+    {
+        std::ifstream in(path, std::ios::binary);
+        if (!in || !in.read(reinterpret_cast<char*>(&header), sizeof(header)))
+        {
+            std::fprintf(stderr, "%s: cannot read replay header\n", path);
+            return false;
+        }
+
+        if (std::memcmp(header.magic, FILE_MAGIC, sizeof(FILE_MAGIC)) != 0 || header.version != FILE_VERSION ||
+            header.recordSize != sizeof(Record))
+        {
+            std::fprintf(stderr, "%s: not a version %u siege replay\n", path, unsigned(FILE_VERSION));
+            return false;
+        }
+
+        Record record;
+        while (in.read(reinterpret_cast<char*>(&record), sizeof(record)))
+            records.push_back(record);
+
+        return true;
+    }
+
+    void PrintTimeline(std::vector<Record> const& records)
+    {
+        for (Record const& record : records)
+        {
+            std::printf("%s  %-12s %-8s detail=%-5u id=%-10u value=%-10u (%.1f, %.1f)\n",
+                FormatTime(record.timeMs).c_str(), EventName(record.type), RoleName(record.role),
+                unsigned(record.detail), unsigned(record.id), unsigned(record.value), record.x, record.y);
+        }
+    }
+
+    // Index 0 = attackers, 1 = defenders
+    std::size_t Side(Role role)
+    {
+        return role == Role::Defender ? 1 : 0;
+    }
+
+    void PrintSummary(char const* path, FileHeader const& header, std::vector<Record> const& records)
+    {
+        std::array<std::uint32_t, 2> spawns{}, deaths{}, respawns{}, botRecruits{}, botDeaths{};
+        std::map<std::uint16_t, std::uint32_t> stopsReached; // Route stop -> units that reached it
+        std::uint32_t broadcasts = 0, broadcastRecipients = 0;
+        std::uint64_t broadcastBytes = 0;
+        std::uint64_t dropped = 0;
+        std::uint32_t combatStartMs = 0, endMs = 0;
+        bool combatStarted = false, ended = false;
+        std::uint16_t winner = 0;
+        std::uint32_t leaderMinHealth = 10000, leaderHalfHealthMs = 0;
+        bool leaderSampled = false, leaderHalfHealth = false;
+        std::array<std::uint32_t, std::size(TeardownStageNames)> teardownUs{};
+
+        for (Record const& record : records)
+        {
+            switch (record.type)
+            {
+                case EventType::Spawn:      ++spawns[Side(record.role)]; break;
+                case EventType::Death:      ++deaths[Side(record.role)]; break;
+                case EventType::Respawn:    ++respawns[Side(record.role)]; break;
+                case EventType::Waypoint:   ++stopsReached[record.detail]; break;
+                case EventType::BotRecruit: ++botRecruits[Side(record.role)]; break;
+                case EventType::BotDeath:   ++botDeaths[Side(record.role)]; break;
+                case EventType::Broadcast:
+                    ++broadcasts;
+                    broadcastRecipients += record.id;
+                    broadcastBytes += record.value;
+                    break;
+                case EventType::LeaderHealth:
+                    leaderSampled = true;
+                    leaderMinHealth = std::min(leaderMinHealth, record.value);
+                    if (!leaderHalfHealth && record.value <= 5000)
+                    {
+                        leaderHalfHealth = true;
+                        leaderHalfHealthMs = record.timeMs;
+                    }
+                    break;
+                case EventType::CombatStart:
+                    combatStarted = true;
+                    combatStartMs = record.timeMs;
+                    break;
+                case EventType::Teardown:
+                    if (record.detail < teardownUs.size())
+                        teardownUs[record.detail] = record.value;
+                    break;
+                case EventType::End:
+                    ended = true;
+                    endMs = record.timeMs;
+                    winner = record.detail;
+                    break;
+                case EventType::Dropped:
+                    dropped += record.value;
+                    break;
+                default:
+                    break;
+            }
+        }
+
+        std::uint32_t lastMs = 0;
+        for (Record const& record : records)
+            lastMs = std::max(lastMs, record.timeMs);
+        std::printf("=== %s: siege of %s, recorded at %u ===\n", path, CityName(header.cityId), unsigned(header.startTime));
+        std::printf("Records:        %zu over %s%s\n", records.size(), FormatTime(lastMs).c_str(),
+            ended ? "" : " (no END record, the siege was interrupted)");
+        if (dropped)
+            std::printf("Dropped:        %llu records lost to buffer overflow (raise CitySiege.Replay.BufferSize)\n", (unsigned long long)dropped);
+
+        if (combatStarted)
+            std::printf("Combat start:   %s\n", FormatTime(combatStartMs).c_str());
+        if (ended)
+            std::printf("End:            %s, %s won\n", FormatTime(endMs).c_str(), winner == 0 ? "Alliance" : "Horde");
+
+        std::printf("                  attackers   defenders\n");
+        std::printf("Spawned:        %11u %11u\n", spawns[0], spawns[1]);
+        std::printf("Died:           %11u %11u\n", deaths[0], deaths[1]);
+        std::printf("Respawned:      %11u %11u\n", respawns[0], respawns[1]);
+        std::printf("Bots recruited: %11u %11u\n", botRecruits[0], botRecruits[1]);
+        std::printf("Bots died:      %11u %11u\n", botDeaths[0], botDeaths[1]);
+
+        if (combatStarted && ended && endMs > combatStartMs)
+        {
+            double const combatMinutes = (endMs - combatStartMs) / 60000.0;
+            std::printf("Deaths/minute:  %11.1f %11.1f\n", deaths[0] / combatMinutes, deaths[1] / combatMinutes);
+        }
+
+        if (leaderSampled)
+        {
+            std::printf("Leader health:  lowest %.2f%%", leaderMinHealth / 100.0);
+            if (leaderHalfHealth)
+                std::printf(", below 50%% at %s", FormatTime(leaderHalfHealthMs).c_str());
+            std::printf("\n");
+        }
+
+        if (!stopsReached.empty())
+        {
+            std::printf("Route stops reached:");
+            for (auto const& [stop, count] : stopsReached)
+                std::printf(" %u:%u", unsigned(stop), count);
+            std::printf("\n");
+        }
+
+        if (broadcasts)
+        {
+            std::printf("Broadcasts:     %u, %.1f recipients and %llu bytes on average\n", broadcasts,
+                double(broadcastRecipients) / broadcasts, (unsigned long long)(broadcastBytes / broadcasts));
+        }
+
+        std::printf("Teardown:      ");
+        for (std::size_t stage = 1; stage < teardownUs.size(); ++stage)
+            std::printf(" %s %uus", TeardownStageNames[stage], teardownUs[stage]);
+        std::printf("\n\n");
+    }
+}
+
+int main(int argc, char** argv)
+{
+    bool timeline = false;
+    std::vector<char const*> paths;
+    for (int i = 1; i < argc; ++i)
+    {
+        if (std::strcmp(argv[i], "--timeline") == 0)
+            timeline = true;
+        else
+            paths.push_back(argv[i]);
+    }
+
+    if (paths.empty())
+    {
+        std::fprintf(stderr, "Usage: %s [--timeline] <replay.csr>...\n", argv[0]);
+        return 1;
+    }
+
+    int result = 0;
+    for (char const* path : paths)
+    {
+        FileHeader header;
+        std::vector<Record> records;
+        if (!ReadReplay(path, header, records))
+        {
+            result = 1;
+            continue;
+        }
+
+        if (timeline)
+            PrintTimeline(records);
+
+        PrintSummary(path, header, records);
+    }
+
+    return result;
+}